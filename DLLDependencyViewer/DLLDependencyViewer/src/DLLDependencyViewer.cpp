@@ -1,3 +1,5 @@
+#include "gui/background_processor.cpp"
+#include "gui/benchmark.cpp"
 #include "gui/export_view.cpp"
 #include "gui/import_export_matcher.cpp"
 #include "gui/import_view.cpp"
@@ -11,6 +13,7 @@
 #include "gui/smart_menu.cpp"
 #include "gui/splitter_window.cpp"
 #include "gui/test.cpp"
+#include "gui/traversal_queue.cpp"
 #include "gui/tree_view.cpp"
 
 #include "nogui/activation_context.cpp"
@@ -18,7 +21,9 @@
 #include "nogui/allocator_big.cpp"
 #include "nogui/allocator_malloc.cpp"
 #include "nogui/allocator_small.cpp"
+#include "nogui/allocator_stats.cpp"
 #include "nogui/array_bool.cpp"
+#include "nogui/ascii_scan.cpp"
 #include "nogui/assert.cpp"
 #include "nogui/com.cpp"
 #include "nogui/dbg_provider.cpp"
@@ -28,18 +33,22 @@
 #include "nogui/fnv1a.cpp"
 #include "nogui/int_to_string.cpp"
 #include "nogui/known_dlls.cpp"
+#include "nogui/latency_histogram.cpp"
 #include "nogui/manifest_parser.cpp"
 #include "nogui/manifest_parser_impl.cpp"
+#include "nogui/mapping_cache.cpp"
 #include "nogui/memory_manager.cpp"
 #include "nogui/memory_mapped_file.cpp"
 #include "nogui/my_string.cpp"
 #include "nogui/my_string_handle.cpp"
 #include "nogui/ole.cpp"
-#include "nogui/pe.cpp"
 #include "nogui/pe2.cpp"
 #include "nogui/pe_getters.cpp"
 #include "nogui/pe_getters_export.cpp"
 #include "nogui/pe_getters_import.cpp"
+#include "nogui/pe_triage.cpp"
+#include "nogui/prefetcher.cpp"
+#include "nogui/selective_file.cpp"
 #include "nogui/smart_com_interface.cpp"
 #include "nogui/smart_handle.cpp"
 #include "nogui/smart_library.cpp"
@@ -50,6 +59,7 @@
 #include "nogui/unicode.cpp"
 #include "nogui/unique_strings.cpp"
 #include "nogui/utils.cpp"
+#include "nogui/wyhash.cpp"
 
 #include "nogui/pe/coff.cpp"
 #include "nogui/pe/coff_full.cpp"
@@ -59,3 +69,4 @@
 #include "nogui/pe/import_table.cpp"
 #include "nogui/pe/mz.cpp"
 #include "nogui/pe/pe_util.cpp"
+#include "nogui/pe/resource_table.cpp"
@@ -0,0 +1,72 @@
+#include "background_processor.h"
+
+#include <cassert>
+#include <utility>
+
+
+background_processor::background_processor() :
+	m_cancel(false),
+	m_hints(),
+	m_published(),
+	m_thread()
+{
+}
+
+background_processor::~background_processor()
+{
+	cancel();
+	wait();
+}
+
+void background_processor::start(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_budget const& budget, process_progress_fn_t const progress_fn, background_done_fn_t const done_fn, void* const param)
+{
+	cancel();
+	wait();
+	m_cancel.store(false);
+	background_processor* const self = this;
+	m_thread = std::thread([self, file_paths, policy, mode, backend, budget, progress_fn, done_fn, param]()
+	{
+		process_control control;
+		control.m_cancel = &self->m_cancel;
+		control.m_progress_fn = progress_fn;
+		control.m_progress_param = param;
+		control.m_event_fn = nullptr;
+		control.m_event_param = nullptr;
+		control.m_hints = &self->m_hints;
+		control.m_budget = budget;
+		auto mo = std::make_unique<main_type_32>();
+		mapping_cache mappings;
+		bool const processed = process(file_paths, policy, mode, backend, &control, mappings, mo.get()) && materialize_all(*mo, mappings, &control);
+		if(processed)
+		{
+			self->m_published.store(std::shared_ptr<main_type_32 const>(std::move(mo)));
+		}
+		if(done_fn)
+		{
+			done_fn(processed, param);
+		}
+	});
+}
+
+void background_processor::cancel()
+{
+	m_cancel.store(true);
+}
+
+void background_processor::wait()
+{
+	if(m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void background_processor::set_focus(std::vector<std::wstring> const& file_paths)
+{
+	m_hints.set_focus(file_paths);
+}
+
+std::shared_ptr<main_type_32 const> background_processor::get_published() const
+{
+	return m_published.load();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+
+#include "processor.h"
+#include "traversal_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+typedef void(*background_done_fn_t)(bool const processed, void* const param);
+
+
+class background_processor
+{
+public:
+	background_processor();
+	background_processor(background_processor const&) = delete;
+	background_processor& operator=(background_processor const&) = delete;
+	~background_processor();
+public:
+	void start(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_budget const& budget, process_progress_fn_t const progress_fn, background_done_fn_t const done_fn, void* const param);
+	void cancel();
+	void wait();
+	void set_focus(std::vector<std::wstring> const& file_paths);
+	// The published snapshot is fully materialized and validated, it is never modified after that.
+	// A canceled or failed run keeps the previous snapshot published.
+	std::shared_ptr<main_type_32 const> get_published() const;
+private:
+	std::atomic<bool> m_cancel;
+	traversal_hints m_hints;
+	std::atomic<std::shared_ptr<main_type_32 const>> m_published;
+	std::thread m_thread;
+};
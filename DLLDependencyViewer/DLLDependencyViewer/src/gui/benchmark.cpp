@@ -0,0 +1,559 @@
+#include "benchmark.h"
+
+#include "../nogui/array_bool.h"
+#include "../nogui/ascii_scan.h"
+#include "../nogui/fnv1a.h"
+#include "../nogui/memory_manager.h"
+#include "../nogui/memory_mapped_file.h"
+#include "../nogui/my_string.h"
+#include "../nogui/pe2.h"
+#include "../nogui/selective_file.h"
+#include "../nogui/smart_local_free.h"
+#include "../nogui/unique_strings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../nogui/my_windows.h"
+#include <shellapi.h>
+
+
+static constexpr wchar_t const s_bench_kind_strings[] = L"strings";
+static constexpr wchar_t const s_bench_kind_hash[] = L"hash";
+static constexpr wchar_t const s_bench_kind_ascii[] = L"ascii";
+static constexpr wchar_t const s_bench_kind_parse[] = L"parse";
+static constexpr wchar_t const s_bench_kind_closure[] = L"closure";
+static constexpr wchar_t const s_bench_kind_io[] = L"io";
+static constexpr int const s_bench_repetitions = 5;
+static constexpr double const s_bench_simulated_latency_ms = 5.0;
+static constexpr std::uint64_t const s_bench_page_in_cluster = 64 * 1024;
+
+
+struct bench_corpus
+{
+	std::vector<std::string> m_names;
+	std::vector<std::wstring> m_paths;
+};
+
+
+static void bench_print(wchar_t const* const str)
+{
+	OutputDebugStringW(str);
+	OutputDebugStringW(L"\n");
+}
+
+template<typename fn_t>
+static double bench_measure_ms(fn_t const& fn)
+{
+	auto const begin = std::chrono::steady_clock::now();
+	for(int i = 0; i != s_bench_repetitions; ++i)
+	{
+		fn();
+	}
+	auto const end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count() / s_bench_repetitions;
+}
+
+static void bench_collect(wchar_t const* const dir, bench_corpus* const corpus_out)
+{
+	std::filesystem::recursive_directory_iterator dir_it(dir, std::filesystem::directory_options::skip_permission_denied);
+	for(auto const& e : dir_it)
+	{
+		auto const& p = e.path();
+		if(std::filesystem::is_directory(p))
+		{
+			continue;
+		}
+		memory_mapped_file const mmf(p.c_str());
+		if(mmf.begin() == nullptr)
+		{
+			continue;
+		}
+		pe_image img;
+		bool const hdrs_processed = pe_process_headers(mmf.begin(), mmf.size(), mmf.file_size(), &img);
+		if(!hdrs_processed)
+		{
+			continue;
+		}
+		memory_manager mm;
+		allocator tmp_alc;
+		pe_import_table_info iti;
+		pe_export_table_info eti;
+		std::uint16_t enpt_count;
+		std::uint16_t const* enpt;
+		pe_tables tables;
+		tables.m_policy = pe_parse_policy::strict;
+		tables.m_dll_names_only = false;
+		tables.m_tmp_alc = &tmp_alc;
+		tables.m_iti_out = &iti;
+		tables.m_eti_out = &eti;
+		tables.m_enpt_count_out = &enpt_count;
+		tables.m_enpt_out = &enpt;
+		tables.m_rti_out = nullptr;
+		bool const tables_processed = pe_process_all(img, mm, &tables);
+		if(!tables_processed)
+		{
+			continue;
+		}
+		corpus_out->m_paths.push_back(p.native());
+		for(int i = 0; i != iti.m_dll_count; ++i)
+		{
+			corpus_out->m_names.emplace_back(iti.m_dll_names[i].m_string->m_str, iti.m_dll_names[i].m_string->m_len);
+			for(int j = 0; j != iti.m_import_counts[i]; ++j)
+			{
+				if(array_bool_tst(iti.m_are_ordinals[i], j))
+				{
+					continue;
+				}
+				corpus_out->m_names.emplace_back(iti.m_names[i][j].m_string->m_str, iti.m_names[i][j].m_string->m_len);
+			}
+		}
+		for(int i = 0; i != eti.m_count; ++i)
+		{
+			if(!eti.m_names[i])
+			{
+				continue;
+			}
+			corpus_out->m_names.emplace_back(eti.m_names[i].m_string->m_str, eti.m_names[i].m_string->m_len);
+		}
+	}
+}
+
+static void bench_strings(bench_corpus const& corpus)
+{
+	int unique_node = 0;
+	double const node_ms = bench_measure_ms([&]()
+	{
+		allocator alc;
+		std::unordered_set<string_handle> set;
+		for(auto const& name : corpus.m_names)
+		{
+			string const tmp_str{name.c_str(), static_cast<int>(name.size())};
+			string_handle const tmp_hndl{&tmp_str};
+			auto const it = set.find(tmp_hndl);
+			if(it != set.end())
+			{
+				continue;
+			}
+			char* const new_buff = alc.allocate_objects<char>(tmp_str.m_len + 1);
+			std::memcpy(new_buff, tmp_str.m_str, tmp_str.m_len + 1);
+			string* const new_str = alc.allocate_objects<string>(1);
+			*new_str = string{new_buff, tmp_str.m_len};
+			set.insert(string_handle{new_str});
+		}
+		unique_node = static_cast<int>(set.size());
+	});
+	int unique_flat = 0;
+	double const flat_ms = bench_measure_ms([&]()
+	{
+		allocator alc;
+		unique_strings strs;
+		for(auto const& name : corpus.m_names)
+		{
+			strs.add_string(name.c_str(), static_cast<int>(name.size()), alc);
+		}
+		unique_flat = strs.size();
+	});
+	wchar_t buff[256];
+	std::swprintf(buff, std::size(buff), L"strings: %d names, %d / %d unique, node set %.3f ms, flat table %.3f ms.", static_cast<int>(corpus.m_names.size()), unique_node, unique_flat, node_ms, flat_ms);
+	bench_print(buff);
+}
+
+template<typename char_t>
+static std::size_t bench_hash_fnv1a(basic_string<char_t> const& str)
+{
+	fnv1a_state hash;
+	fnv1a_hash_init(hash);
+	fnv1a_hash_process(hash, str.m_str, str.m_len * sizeof(char_t));
+	return fnv1a_hash_finish(hash);
+}
+
+template<typename char_t>
+static std::size_t bench_hash_fnv1a_case_insensitive(basic_string<char_t> const& str)
+{
+	fnv1a_state hash;
+	fnv1a_hash_init(hash);
+	for(int i = 0; i != str.m_len; ++i)
+	{
+		char_t const ch = (str.m_str[i] | 0b0010'0000);
+		fnv1a_hash_process(hash, &ch, 1 * sizeof(char_t));
+	}
+	return fnv1a_hash_finish(hash);
+}
+
+template<typename char_t, typename fn_t>
+static double bench_hash_workload(std::vector<std::basic_string<char_t>> const& strs, int const repeat, fn_t const& fn, std::size_t* const sum_out)
+{
+	std::size_t sum = 0;
+	double const ms = bench_measure_ms([&]()
+	{
+		for(int r = 0; r != repeat; ++r)
+		{
+			for(auto const& s : strs)
+			{
+				sum += fn(basic_string<char_t>{s.c_str(), static_cast<int>(s.size())});
+			}
+		}
+	});
+	*sum_out += sum;
+	return ms;
+}
+
+template<typename char_t>
+static void bench_hash_strings(wchar_t const* const workload, std::vector<std::basic_string<char_t>> const& strs, int const repeat)
+{
+	std::size_t sum = 0;
+	double const fnv1a_ms = bench_hash_workload(strs, repeat, [](basic_string<char_t> const& s){ return bench_hash_fnv1a(s); }, &sum);
+	double const wyhash_ms = bench_hash_workload(strs, repeat, [](basic_string<char_t> const& s){ return basic_string_hash<char_t>{}(s); }, &sum);
+	double const fnv1a_ci_ms = bench_hash_workload(strs, repeat, [](basic_string<char_t> const& s){ return bench_hash_fnv1a_case_insensitive(s); }, &sum);
+	double const wyhash_ci_ms = bench_hash_workload(strs, repeat, [](basic_string<char_t> const& s){ return basic_string_case_insensitive_hash<char_t>{}(s); }, &sum);
+	wchar_t buff[256];
+	std::swprintf(buff, std::size(buff), L"hash %ls: %d strings x %d, fnv1a %.3f ms, wyhash %.3f ms, case insensitive fnv1a %.3f ms, case insensitive wyhash %.3f ms (%zu).", workload, static_cast<int>(strs.size()), repeat, fnv1a_ms, wyhash_ms, fnv1a_ci_ms, wyhash_ci_ms, sum & 0xF);
+	bench_print(buff);
+}
+
+static void bench_hash(bench_corpus const& corpus)
+{
+	bench_hash_strings(L"names", corpus.m_names, 10);
+	bench_hash_strings(L"paths", corpus.m_paths, 1000);
+}
+
+static bool bench_ascii_scan_z_old(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	char const* const str_end = std::find(str, str + max_len, '\0');
+	if(str_end == str + max_len)
+	{
+		return false;
+	}
+	*len_out = static_cast<int>(str_end - str);
+	*is_printable_out = std::all_of(str, str_end, [](char const& e){ return e >= 32 && e <= 126; });
+	return true;
+}
+
+template<typename fn_t>
+static double bench_ascii_workload(std::vector<char> const& table, int const table_len, int const repeat, fn_t const& fn, int* const sum_out)
+{
+	int sum = 0;
+	double const ms = bench_measure_ms([&]()
+	{
+		for(int r = 0; r != repeat; ++r)
+		{
+			int pos = 0;
+			while(pos != table_len)
+			{
+				int len;
+				bool is_printable;
+				bool const terminated = fn(table.data() + pos, table_len - pos, &len, &is_printable);
+				if(!terminated)
+				{
+					break;
+				}
+				sum += is_printable ? 1 : 0;
+				pos += len + 1;
+			}
+		}
+	});
+	*sum_out = sum / s_bench_repetitions / repeat;
+	return ms;
+}
+
+static void bench_ascii(bench_corpus const& corpus)
+{
+	static constexpr int const s_table_padding = 64;
+	static constexpr int const s_repeat = 10;
+	std::vector<char> table;
+	for(auto const& name : corpus.m_names)
+	{
+		table.insert(table.end(), name.c_str(), name.c_str() + name.size() + 1);
+	}
+	int const table_len = static_cast<int>(table.size());
+	table.resize(table.size() + s_table_padding, '\0');
+	int old_cnt;
+	int scalar_cnt;
+	int sse2_cnt;
+	int avx2_cnt = 0;
+	double const old_ms = bench_ascii_workload(table, table_len, s_repeat, [](char const* const str, int const max_len, int* const len_out, bool* const is_printable_out){ return bench_ascii_scan_z_old(str, max_len, len_out, is_printable_out); }, &old_cnt);
+	double const scalar_ms = bench_ascii_workload(table, table_len, s_repeat, [](char const* const str, int const max_len, int* const len_out, bool* const is_printable_out){ return ascii_scan_z(ascii_isa::scalar, str, max_len, len_out, is_printable_out); }, &scalar_cnt);
+	double const sse2_ms = bench_ascii_workload(table, table_len, s_repeat, [](char const* const str, int const max_len, int* const len_out, bool* const is_printable_out){ return ascii_scan_z(ascii_isa::sse2, str, max_len, len_out, is_printable_out); }, &sse2_cnt);
+	double avx2_ms = 0.0;
+	if(ascii_get_best_isa() == ascii_isa::avx2)
+	{
+		avx2_ms = bench_ascii_workload(table, table_len, s_repeat, [](char const* const str, int const max_len, int* const len_out, bool* const is_printable_out){ return ascii_scan_z(ascii_isa::avx2, str, max_len, len_out, is_printable_out); }, &avx2_cnt);
+	}
+	wchar_t buff[256];
+	std::swprintf(buff, std::size(buff), L"ascii: %d strings, %d bytes x %d, find + all_of %.3f ms (%d), scalar %.3f ms (%d), sse2 %.3f ms (%d), avx2 %.3f ms (%d).", static_cast<int>(corpus.m_names.size()), table_len, s_repeat, old_ms, old_cnt, scalar_ms, scalar_cnt, sse2_ms, sse2_cnt, avx2_ms, avx2_cnt);
+	bench_print(buff);
+}
+
+static double bench_map_all(bench_corpus const& corpus, std::vector<memory_mapped_file>* const mmfs_out)
+{
+	double total_bytes = 0.0;
+	for(auto const& path : corpus.m_paths)
+	{
+		memory_mapped_file mmf(path.c_str());
+		if(mmf.begin() == nullptr)
+		{
+			continue;
+		}
+		total_bytes += mmf.size();
+		mmfs_out->push_back(std::move(mmf));
+	}
+	return total_bytes;
+}
+
+static bool bench_parse_image(pe_image const& img, pe_parse_policy const policy, bool const validate)
+{
+	memory_manager mm;
+	allocator tmp_alc;
+	pe_import_table_info iti;
+	pe_export_table_info eti;
+	std::uint16_t enpt_count;
+	std::uint16_t const* enpt;
+	pe_tables tables;
+	tables.m_policy = policy;
+	tables.m_dll_names_only = false;
+	tables.m_tmp_alc = &tmp_alc;
+	tables.m_iti_out = &iti;
+	tables.m_eti_out = &eti;
+	tables.m_enpt_count_out = &enpt_count;
+	tables.m_enpt_out = &enpt;
+	tables.m_rti_out = nullptr;
+	bool const tables_processed = pe_process_all(img, mm, &tables);
+	if(!tables_processed)
+	{
+		return false;
+	}
+	if(validate && eti.m_validation == pe_validation::pending)
+	{
+		return pe_validate_export_table(eti, tmp_alc);
+	}
+	return true;
+}
+
+static bool bench_parse_file(memory_mapped_file const& mmf, pe_parse_policy const policy, bool const validate)
+{
+	pe_image img;
+	bool const hdrs_processed = pe_process_headers(mmf.begin(), mmf.size(), mmf.file_size(), &img);
+	if(!hdrs_processed)
+	{
+		return false;
+	}
+	return bench_parse_image(img, policy, validate);
+}
+
+static void bench_parse(bench_corpus const& corpus)
+{
+	static constexpr pe_parse_policy const s_policies[] = {pe_parse_policy::strict, pe_parse_policy::fast, pe_parse_policy::deferred, pe_parse_policy::deferred};
+	static constexpr bool const s_validate[] = {false, false, false, true};
+	static constexpr wchar_t const* const s_policy_names[] = {L"strict", L"fast", L"deferred", L"deferred + validate"};
+	std::vector<memory_mapped_file> mmfs;
+	double const total_bytes = bench_map_all(corpus, &mmfs);
+	for(int i = 0; i != static_cast<int>(std::size(s_policies)); ++i)
+	{
+		int failed = 0;
+		double const ms = bench_measure_ms([&]()
+		{
+			failed = 0;
+			for(auto const& mmf : mmfs)
+			{
+				bool const parsed = bench_parse_file(mmf, s_policies[i], s_validate[i]);
+				failed += parsed ? 0 : 1;
+			}
+		});
+		wchar_t buff[256];
+		std::swprintf(buff, std::size(buff), L"parse %ls: %d files, %.1f MB, %.3f ms, %.0f files/s, %.1f MB/s, %d failed.", s_policy_names[i], static_cast<int>(mmfs.size()), total_bytes / (1024.0 * 1024.0), ms, mmfs.size() / (ms / 1000.0), total_bytes / (1024.0 * 1024.0) / (ms / 1000.0), failed);
+		bench_print(buff);
+	}
+}
+
+static bool bench_closure_file(memory_mapped_file const& mmf, bool const dll_names_only, int* const dll_count_out)
+{
+	pe_image img;
+	bool const hdrs_processed = pe_process_headers(mmf.begin(), mmf.size(), mmf.file_size(), &img);
+	if(!hdrs_processed)
+	{
+		return false;
+	}
+	memory_manager mm;
+	allocator tmp_alc;
+	pe_import_table_info iti;
+	pe_export_table_info eti;
+	std::uint16_t enpt_count;
+	std::uint16_t const* enpt;
+	pe_tables tables;
+	tables.m_policy = pe_parse_policy::fast;
+	tables.m_dll_names_only = dll_names_only;
+	tables.m_tmp_alc = &tmp_alc;
+	tables.m_iti_out = &iti;
+	tables.m_eti_out = dll_names_only ? nullptr : &eti;
+	tables.m_enpt_count_out = &enpt_count;
+	tables.m_enpt_out = &enpt;
+	tables.m_rti_out = nullptr;
+	bool const tables_processed = pe_process_all(img, mm, &tables);
+	if(!tables_processed)
+	{
+		return false;
+	}
+	*dll_count_out += iti.m_dll_count;
+	return true;
+}
+
+static void bench_closure(bench_corpus const& corpus)
+{
+	static constexpr bool const s_dll_names_only[] = {false, true};
+	static constexpr wchar_t const* const s_mode_names[] = {L"full", L"closure"};
+	std::vector<memory_mapped_file> mmfs;
+	double const total_bytes = bench_map_all(corpus, &mmfs);
+	for(int i = 0; i != static_cast<int>(std::size(s_dll_names_only)); ++i)
+	{
+		int failed = 0;
+		int dll_count = 0;
+		double const ms = bench_measure_ms([&]()
+		{
+			failed = 0;
+			dll_count = 0;
+			for(auto const& mmf : mmfs)
+			{
+				bool const parsed = bench_closure_file(mmf, s_dll_names_only[i], &dll_count);
+				failed += parsed ? 0 : 1;
+			}
+		});
+		wchar_t buff[256];
+		std::swprintf(buff, std::size(buff), L"closure %ls: %d files, %.1f MB, %d DLL references, %.3f ms, %.0f files/s, %d failed.", s_mode_names[i], static_cast<int>(mmfs.size()), total_bytes / (1024.0 * 1024.0), dll_count, ms, mmfs.size() / (ms / 1000.0), failed);
+		bench_print(buff);
+	}
+}
+
+static bool bench_io_mapped_file(std::wstring const& path, std::uint64_t* const clusters_out)
+{
+	memory_mapped_file mmf(path.c_str());
+	if(mmf.begin() == nullptr)
+	{
+		return false;
+	}
+	pe_image img;
+	bool const hdrs_processed = pe_process_headers(mmf, false, &img);
+	if(!hdrs_processed)
+	{
+		return false;
+	}
+	pe_section_header const* sections[s_pe_required_sections_max];
+	int const count = pe_find_required_sections(img, false, sections);
+	std::uint64_t clusters = (pe_find_headers_size(img) + s_bench_page_in_cluster - 1) / s_bench_page_in_cluster;
+	for(int i = 0; i != count; ++i)
+	{
+		clusters += (std::uint64_t{sections[i]->m_raw_size} + s_bench_page_in_cluster - 1) / s_bench_page_in_cluster;
+	}
+	*clusters_out += clusters;
+	return bench_parse_image(img, pe_parse_policy::fast, false);
+}
+
+static bool bench_io_selective_file(std::wstring const& path, std::uint64_t* const requests_out, std::uint64_t* const bytes_out)
+{
+	selective_file sf(path.c_str());
+	if(sf.begin() == nullptr)
+	{
+		return false;
+	}
+	pe_image img;
+	bool const hdrs_processed = pe_process_headers(sf, false, &img);
+	*requests_out += sf.request_count();
+	*bytes_out += sf.bytes_read();
+	if(!hdrs_processed)
+	{
+		return false;
+	}
+	return bench_parse_image(img, pe_parse_policy::fast, false);
+}
+
+static void bench_io(bench_corpus const& corpus)
+{
+	double total_bytes = 0.0;
+	for(auto const& path : corpus.m_paths)
+	{
+		std::error_code ec;
+		std::uintmax_t const size = std::filesystem::file_size(path, ec);
+		total_bytes += ec ? 0.0 : static_cast<double>(size);
+	}
+	int mapped_failed = 0;
+	std::uint64_t mapped_clusters = 0;
+	double const mapped_ms = bench_measure_ms([&]()
+	{
+		mapped_failed = 0;
+		mapped_clusters = 0;
+		for(auto const& path : corpus.m_paths)
+		{
+			bool const parsed = bench_io_mapped_file(path, &mapped_clusters);
+			mapped_failed += parsed ? 0 : 1;
+		}
+	});
+	int selective_failed = 0;
+	std::uint64_t selective_requests = 0;
+	std::uint64_t selective_bytes = 0;
+	double const selective_ms = bench_measure_ms([&]()
+	{
+		selective_failed = 0;
+		selective_requests = 0;
+		selective_bytes = 0;
+		for(auto const& path : corpus.m_paths)
+		{
+			bool const parsed = bench_io_selective_file(path, &selective_requests, &selective_bytes);
+			selective_failed += parsed ? 0 : 1;
+		}
+	});
+	wchar_t buff[256];
+	std::swprintf(buff, std::size(buff), L"io mapped: %d files, %.1f MB, %.3f ms, %llu page-in clusters touched, %.3f ms at %.1f ms latency, %d failed.", static_cast<int>(corpus.m_paths.size()), total_bytes / (1024.0 * 1024.0), mapped_ms, static_cast<unsigned long long>(mapped_clusters), mapped_ms + mapped_clusters * s_bench_simulated_latency_ms, s_bench_simulated_latency_ms, mapped_failed);
+	bench_print(buff);
+	std::swprintf(buff, std::size(buff), L"io selective: %d files, %.1f MB read, %.3f ms, %llu requests, %.3f ms at %.1f ms latency, %d failed.", static_cast<int>(corpus.m_paths.size()), selective_bytes / (1024.0 * 1024.0), selective_ms, static_cast<unsigned long long>(selective_requests), selective_ms + selective_requests * s_bench_simulated_latency_ms, s_bench_simulated_latency_ms, selective_failed);
+	bench_print(buff);
+}
+
+void benchmark()
+{
+	wchar_t const* const cmd_line = GetCommandLineW();
+	int argc;
+	wchar_t** const argv = CommandLineToArgvW(cmd_line, &argc);
+	smart_local_free const sp_argv(reinterpret_cast<void*>(argv));
+	if(argc != 4)
+	{
+		return;
+	}
+	if(std::wcsncmp(argv[1], s_cmd_arg_bench, std::size(s_cmd_arg_bench) - 1) != 0)
+	{
+		return;
+	}
+	bench_corpus corpus;
+	bench_collect(argv[3], &corpus);
+	if(std::wcscmp(argv[2], s_bench_kind_strings) == 0)
+	{
+		bench_strings(corpus);
+	}
+	else if(std::wcscmp(argv[2], s_bench_kind_hash) == 0)
+	{
+		bench_hash(corpus);
+	}
+	else if(std::wcscmp(argv[2], s_bench_kind_ascii) == 0)
+	{
+		bench_ascii(corpus);
+	}
+	else if(std::wcscmp(argv[2], s_bench_kind_parse) == 0)
+	{
+		bench_parse(corpus);
+	}
+	else if(std::wcscmp(argv[2], s_bench_kind_closure) == 0)
+	{
+		bench_closure(corpus);
+	}
+	else if(std::wcscmp(argv[2], s_bench_kind_io) == 0)
+	{
+		bench_io(corpus);
+	}
+}
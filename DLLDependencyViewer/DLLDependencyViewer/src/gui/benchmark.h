@@ -0,0 +1,7 @@
+#pragma once
+
+
+static constexpr wchar_t const s_cmd_arg_bench[] = L"/bench";
+
+
+void benchmark();
@@ -188,12 +188,12 @@ void export_view::on_getdispinfow(NMHDR& nmhdr)
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_selected = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_selected == TRUE);
-	file_info const& fi_tmp = *reinterpret_cast<file_info*>(ti.lParam);
-	file_info const& fi = fi_tmp.m_orig_instance ? *fi_tmp.m_orig_instance : fi_tmp;
+	file_info_32 const& fi_tmp = *reinterpret_cast<file_info_32*>(ti.lParam);
+	module_info_32 const& fi = get_module(m_main_window.m_mo, fi_tmp);
 	int const row = nm.item.iItem;
 	int const col = nm.item.iSubItem;
-	pe_export_table_info const& eti = fi.m_export_table;
-	std::uint16_t const exp_idx = static_cast<std::uint16_t>(row);
+	pe_export_table_info_32 const& eti = fi.m_export_table;
+	std::uint32_t const exp_idx = static_cast<std::uint32_t>(row);
 	e_export_column const ecol = static_cast<e_export_column>(col);
 	if((nm.item.mask | LVIF_TEXT) != 0)
 	{
@@ -238,7 +238,7 @@ void export_view::on_getdispinfow(NMHDR& nmhdr)
 	}
 	if((nm.item.mask & LVIF_IMAGE) != 0)
 	{
-		std::uint16_t const& real_exp_idx = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+		std::uint32_t const& real_exp_idx = m_sort.empty() ? exp_idx : m_sort[exp_idx];
 		std::uint8_t const img_idx = pe_get_export_icon_id(eti, fi_tmp.m_matched_imports, real_exp_idx);
 		nm.item.iImage = img_idx;
 	}
@@ -257,7 +257,7 @@ void export_view::on_columnclick(NMHDR& nmhdr)
 void export_view::on_context_menu(LPARAM const lparam)
 {
 	POINT cursor_screen;
-	std::uint16_t ith_line;
+	std::uint32_t ith_line;
 	if(lparam == LPARAM{-1})
 	{
 		LRESULT const sel = SendMessageW(m_hwnd, LVM_GETNEXTITEM, WPARAM{0} - 1, LVNI_SELECTED);
@@ -277,8 +277,7 @@ void export_view::on_context_menu(LPARAM const lparam)
 		cursor_screen.y = rect.top + (rect.bottom - rect.top) / 2;
 		BOOL const converted = ClientToScreen(m_hwnd, &cursor_screen);
 		assert(converted != 0);
-		assert(static_cast<std::size_t>(sel) <= 0xFFFF);
-		ith_line = static_cast<std::uint16_t>(sel);
+		ith_line = static_cast<std::uint32_t>(sel);
 	}
 	else
 	{
@@ -296,10 +295,9 @@ void export_view::on_context_menu(LPARAM const lparam)
 			return;
 		}
 		assert(hit_tested == hti.iItem);
-		assert(hti.iItem <= 0xFFFF);
-		ith_line = static_cast<std::uint16_t>(hti.iItem);
+		ith_line = static_cast<std::uint32_t>(hti.iItem);
 	}
-	std::uint16_t const ith_export = m_sort.empty() ? ith_line : m_sort[ith_line];
+	std::uint32_t const ith_export = m_sort.empty() ? ith_line : m_sort[ith_line];
 	HWND const tree = m_main_window.m_tree_view.get_hwnd();
 	HTREEITEM const tree_selected = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_CARET, 0));
 	if(!tree_selected)
@@ -311,8 +309,8 @@ void export_view::on_context_menu(LPARAM const lparam)
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_item = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
-	file_info const& fi = *reinterpret_cast<file_info*>(ti.lParam);
-	std::uint16_t const& matched = fi.m_matched_imports[ith_export];
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	std::uint32_t const& matched = fi.m_matched_imports[ith_export];
 	bool const enable_goto_orig = matched != 0xffff;
 	HMENU const menu = reinterpret_cast<HMENU>(m_menu.get());
 	BOOL const enabled = EnableMenuItem(menu, static_cast<std::uint16_t>(e_export_menu_id::e_matching), MF_BYCOMMAND | (enable_goto_orig ? MF_ENABLED : MF_GRAYED));
@@ -371,8 +369,8 @@ void export_view::refresh()
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_1 = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_1 == TRUE);
-	file_info const& fi_tmp = *reinterpret_cast<file_info*>(ti.lParam);
-	file_info const& fi = fi_tmp.m_orig_instance ? *fi_tmp.m_orig_instance : fi_tmp;
+	file_info_32 const& fi_tmp = *reinterpret_cast<file_info_32*>(ti.lParam);
+	module_info_32 const& fi = get_module(m_main_window.m_mo, fi_tmp);
 
 	LRESULT const set_size = SendMessageW(m_hwnd, LVM_SETITEMCOUNT, fi.m_export_table.m_count, 0);
 	assert(set_size != 0);
@@ -403,7 +401,7 @@ void export_view::refresh_headers()
 	list_view_base::refresh_headers(&m_hwnd, static_cast<int>(std::size(s_export_headers)), m_main_window.m_settings.m_export_sort);
 }
 
-void export_view::select_item(std::uint16_t const item_idx)
+void export_view::select_item(std::uint32_t const item_idx)
 {
 	list_view_base::select_item(&m_hwnd, &m_sort, item_idx);
 	repaint();
@@ -432,24 +430,24 @@ void export_view::sort_view()
 		ti.mask = TVIF_PARAM;
 		LRESULT const got_selected = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got_selected == TRUE);
-		file_info const& fi_tmp = *reinterpret_cast<file_info*>(ti.lParam);
-		file_info const& fi = fi_tmp.m_orig_instance ? *fi_tmp.m_orig_instance : fi_tmp;
-		pe_export_table_info const& eti = fi.m_export_table;
+		file_info_32 const& fi_tmp = *reinterpret_cast<file_info_32*>(ti.lParam);
+		module_info_32 const& fi = get_module(m_main_window.m_mo, fi_tmp);
+		pe_export_table_info_32 const& eti = fi.m_export_table;
 
-		std::uint16_t const n_items = eti.m_count;
+		std::uint32_t const n_items = eti.m_count;
 		if(static_cast<int>(m_sort.size()) != n_items * 2)
 		{
 			m_sort.resize(n_items * 2);
-			std::iota(m_sort.begin(), m_sort.end(), std::uint16_t{0});
+			std::iota(m_sort.begin(), m_sort.end(), std::uint32_t{0});
 		}
-		std::uint16_t* const sort = m_sort.data();
+		std::uint32_t* const sort = m_sort.data();
 		assert(cur_sort_col >= 0 && cur_sort_col < std::size(s_export_headers));
 		e_export_column const col = static_cast<e_export_column>(cur_sort_col);
 		switch(col)
 		{
 			case e_export_column::e_e:
 			{
-				auto const fn_compare_icon = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_icon = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					std::uint8_t const icon_idx_a = pe_get_export_icon_id(eti, fi_tmp.m_matched_imports, a);
 					std::uint8_t const icon_idx_b = pe_get_export_icon_id(eti, fi_tmp.m_matched_imports, b);
@@ -467,7 +465,7 @@ void export_view::sort_view()
 			break;
 			case e_export_column::e_type:
 			{
-				auto const fn_compare_type = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_type = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					bool const is_rva_a = pe_get_export_type(eti, a);
 					bool const is_rva_b = pe_get_export_type(eti, b);
@@ -485,10 +483,10 @@ void export_view::sort_view()
 			break;
 			case e_export_column::e_ordinal:
 			{
-				auto const fn_compare_ordinal = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_ordinal = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
-					std::uint16_t const ordinal_a = pe_get_export_ordinal(eti, a);
-					std::uint16_t const ordinal_b = pe_get_export_ordinal(eti, b);
+					std::uint32_t const ordinal_a = pe_get_export_ordinal(eti, a);
+					std::uint32_t const ordinal_b = pe_get_export_ordinal(eti, b);
 					return cmp(ordinal_a, ordinal_b);
 				};
 				if(cur_sort_asc)
@@ -503,7 +501,7 @@ void export_view::sort_view()
 			break;
 			case e_export_column::e_hint:
 			{
-				auto const fn_compare_hint = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_hint = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					auto const ret_a = pe_get_export_hint(eti, a);
 					auto const ret_b = pe_get_export_hint(eti, b);
@@ -521,7 +519,7 @@ void export_view::sort_view()
 			break;
 			case e_export_column::e_name:
 			{
-				auto const fn_compare_name = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_name = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					string_handle const ret_a = pe_get_export_name(eti, a);
 					string_handle const ret_b = pe_get_export_name(eti, b);
@@ -543,7 +541,7 @@ void export_view::sort_view()
 			break;
 			case e_export_column::e_entry_point:
 			{
-				auto const fn_compare_entry_point = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_entry_point = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					bool const is_rva_a = pe_get_export_type(eti, a);
 					bool const is_rva_b = pe_get_export_type(eti, b);
@@ -569,7 +567,7 @@ void export_view::sort_view()
 			}
 			break;
 		}
-		for(std::uint16_t i = 0; i != n_items; ++i)
+		for(std::uint32_t i = 0; i != n_items; ++i)
 		{
 			m_sort[n_items + m_sort[i]] = i;
 		}
@@ -592,9 +590,9 @@ smart_menu export_view::create_menu()
 	return smart_menu{menu};
 }
 
-wchar_t const* export_view::on_get_col_type(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+wchar_t const* export_view::on_get_col_type(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+	std::uint32_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
 	bool const is_rva = pe_get_export_type(eti, exp_idx_sorted);
 	if(is_rva)
 	{
@@ -606,20 +604,20 @@ wchar_t const* export_view::on_get_col_type(pe_export_table_info const& eti, std
 	}
 }
 
-wchar_t const* export_view::on_get_col_ordinal(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+wchar_t const* export_view::on_get_col_ordinal(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
-	std::uint16_t const ordinal = pe_get_export_ordinal(eti, exp_idx_sorted);
+	std::uint32_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+	std::uint32_t const ordinal = pe_get_export_ordinal(eti, exp_idx_sorted);
 	return ordinal_to_string(ordinal, m_string_converter);
 }
 
-wchar_t const* export_view::on_get_col_hint(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+wchar_t const* export_view::on_get_col_hint(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+	std::uint32_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
 	auto const hint_opt = pe_get_export_hint(eti, exp_idx_sorted);
 	if(hint_opt.m_is_valid)
 	{
-		std::uint16_t const& hint = hint_opt.m_value;
+		std::uint32_t const& hint = hint_opt.m_value;
 		return ordinal_to_string(hint, m_string_converter);
 	}
 	else
@@ -628,9 +626,9 @@ wchar_t const* export_view::on_get_col_hint(pe_export_table_info const& eti, std
 	}
 }
 
-wchar_t const* export_view::on_get_col_name(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+wchar_t const* export_view::on_get_col_name(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+	std::uint32_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
 	bool const undecorate = m_main_window.m_settings.m_undecorate;
 	if(undecorate)
 	{
@@ -670,9 +668,9 @@ wchar_t const* export_view::on_get_col_name(pe_export_table_info const& eti, std
 	}
 }
 
-wchar_t const* export_view::on_get_col_address(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+wchar_t const* export_view::on_get_col_address(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
+	std::uint32_t const& exp_idx_sorted = m_sort.empty() ? exp_idx : m_sort[exp_idx];
 	bool const is_rva = pe_get_export_type(eti, exp_idx_sorted);
 	pe_rva_or_forwarder const entry_point = pe_get_export_entry_point(eti, exp_idx_sorted);
 	if(is_rva)
@@ -692,9 +690,8 @@ void export_view::select_matching_instance()
 	{
 		return;
 	}
-	assert(static_cast<std::size_t>(sel) <= 0xFFFF);
-	std::uint16_t const ith_line = static_cast<std::uint16_t>(sel);
-	std::uint16_t const ith_export = m_sort.empty() ? ith_line : m_sort[ith_line];
+	std::uint32_t const ith_line = static_cast<std::uint32_t>(sel);
+	std::uint32_t const ith_export = m_sort.empty() ? ith_line : m_sort[ith_line];
 	HWND const tree = m_main_window.m_tree_view.get_hwnd();
 	HTREEITEM const tree_selected = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_CARET, 0));
 	if(!tree_selected)
@@ -706,9 +703,9 @@ void export_view::select_matching_instance()
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_item = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
-	file_info const& fi = *reinterpret_cast<file_info*>(ti.lParam);
-	std::uint16_t const& matched_imp = fi.m_matched_imports[ith_export];
-	if(matched_imp == 0xFFFF)
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	std::uint32_t const& matched_imp = fi.m_matched_imports[ith_export];
+	if(matched_imp == pe_invalid_idx_v<std::uint32_t>)
 	{
 		return;
 	}
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "../nogui/pe.h"
 #include "../nogui/string_converter.h"
 
 #include "../nogui/my_windows.h"
@@ -14,7 +15,6 @@
 
 class main_window;
 struct export_address_entry;
-struct pe_export_table_info;
 
 
 class export_view
@@ -39,22 +39,22 @@ public:
 	void refresh();
 	void repaint();
 	void refresh_headers();
-	void select_item(std::uint16_t const item_idx);
+	void select_item(std::uint32_t const item_idx);
 	void sort_view();
 private:
 	smart_menu create_menu();
-	wchar_t const* on_get_col_type(pe_export_table_info const& eti, std::uint16_t const exp_idx);
-	wchar_t const* on_get_col_ordinal(pe_export_table_info const& eti, std::uint16_t const exp_idx);
-	wchar_t const* on_get_col_hint(pe_export_table_info const& eti, std::uint16_t const exp_idx);
-	wchar_t const* on_get_col_name(pe_export_table_info const& eti, std::uint16_t const exp_idx);
-	wchar_t const* on_get_col_address(pe_export_table_info const& eti, std::uint16_t const exp_idx);
+	wchar_t const* on_get_col_type(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx);
+	wchar_t const* on_get_col_ordinal(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx);
+	wchar_t const* on_get_col_hint(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx);
+	wchar_t const* on_get_col_name(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx);
+	wchar_t const* on_get_col_address(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx);
 	void select_matching_instance();
 	int get_type_column_max_width();
 private:
 	HWND const m_hwnd;
 	main_window& m_main_window;
 	smart_menu const m_menu;
-	std::vector<std::uint16_t> m_sort;
+	std::vector<std::uint32_t> m_sort;
 	string_converter m_string_converter;
 private:
 	friend class import_view;
@@ -6,51 +6,91 @@
 #include <algorithm>
 
 
-void pair_root(file_info& fi, tmp_type& to)
+template<typename idx_t>
+void pair_root(tmp_type<idx_t>& to)
 {
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::vector<module_info_t<idx_t>>& modules = *to.m_modules;
+	std::vector<file_info_t<idx_t>>& nodes = *to.m_nodes;
+	allocator& alc = to.m_mm->m_alc;
+	module_info_t<idx_t> const& mi = modules[s_root_module];
+	idx_t const n = mi.m_import_table.m_dll_count;
+	for(idx_t i = 0; i != n && !to.m_canceled; ++i)
 	{
-		file_info& sub_fi = fi.m_fis[i];
-		file_info& sub_fi_orig = sub_fi.m_orig_instance ? *sub_fi.m_orig_instance : sub_fi;
-		sub_fi.m_matched_imports = to.m_mm->m_alc.allocate_objects<std::uint16_t>(sub_fi_orig.m_export_table.m_count);
-		std::fill(sub_fi.m_matched_imports, sub_fi.m_matched_imports + sub_fi_orig.m_export_table.m_count, static_cast<std::uint16_t>(0xFFFF));
-		pair_all(sub_fi, to);
+		std::uint32_t const sub_node = mi.m_first_child + i;
+		file_info_t<idx_t>& sub_fi = nodes[sub_node];
+		module_info_t<idx_t> const& sub_mi = modules[sub_fi.m_module];
+		sub_fi.m_matched_imports = alc.allocate_objects<idx_t>(sub_mi.m_export_table.m_count, allocation_tag::matching);
+		std::fill(sub_fi.m_matched_imports, sub_fi.m_matched_imports + sub_mi.m_export_table.m_count, pe_invalid_idx_v<idx_t>);
+		sub_fi.m_matched = true;
 	}
+	pair_all(to);
 }
 
-void pair_all(file_info& fi, tmp_type& to)
+template<typename idx_t>
+void pair_all(tmp_type<idx_t>& to)
 {
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(to.m_modules->size());
+	for(std::uint32_t module = s_root_module + 1; module != n && !to.m_canceled; ++module)
 	{
-		file_info& sub_fi = fi.m_fis[i];
-		pair_imports_with_exports(fi, sub_fi, to);
-		pair_exports_with_imports(fi, sub_fi, to);
-		pair_all(sub_fi, to);
+		pair_module(module, to);
 	}
 }
 
-void pair_imports_with_exports(file_info& fi, file_info& sub_fi, tmp_type& to)
+template<typename idx_t>
+void pair_module(std::uint32_t const module, tmp_type<idx_t>& to)
 {
-	file_info& sub_fi_proper = sub_fi.m_orig_instance ? *sub_fi.m_orig_instance : sub_fi;
-	if(sub_fi_proper.m_file_path.m_string == nullptr)
+	std::vector<module_info_t<idx_t>>& modules = *to.m_modules;
+	std::vector<file_info_t<idx_t>>& nodes = *to.m_nodes;
+	module_info_t<idx_t>& mi = modules[module];
+	idx_t const n = mi.m_import_table.m_dll_count;
+	for(idx_t i = 0; i != n && !to.m_canceled; ++i)
+	{
+		std::uint32_t const sub_node = mi.m_first_child + i;
+		file_info_t<idx_t>& sub_fi = nodes[sub_node];
+		module_info_t<idx_t>& sub_mi = modules[sub_fi.m_module];
+		enptr_type<idx_t> enpt{nullptr, 0};
+		if(sub_mi.m_file_path.m_string != nullptr && sub_mi.m_truncation == truncation::none)
+		{
+			auto const it = to.m_map.find(sub_mi.m_file_path);
+			assert(it != to.m_map.end());
+			enpt = it->second->m_enpt;
+		}
+		pair_imports_with_exports(mi, i, sub_mi, enpt);
+		pair_exports_with_imports(mi, i, sub_mi, sub_fi, to.m_mm->m_alc);
+		sub_fi.m_matched = true;
+		idx_t const import_count = mi.m_import_table.m_import_counts[i];
+		idx_t const* const matched_exports = mi.m_import_table.m_matched_exports[i];
+		process_event event{};
+		event.m_kind = process_event_kind::edge_matched;
+		event.m_parent = module;
+		event.m_index = i;
+		event.m_node = sub_node;
+		event.m_module = sub_fi.m_module;
+		event.m_file_path = sub_mi.m_file_path;
+		event.m_dll_name = mi.m_import_table.m_dll_names[i];
+		event.m_import_count = import_count;
+		event.m_missing_imports = static_cast<std::uint32_t>(std::count(matched_exports, matched_exports + import_count, pe_invalid_idx_v<idx_t>));
+		emit_event(to, event);
+	}
+}
+
+template<typename idx_t>
+void pair_imports_with_exports(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, enptr_type<idx_t> const& enpt)
+{
+	if(sub_mi.m_file_path.m_string == nullptr)
 	{
 		return;
 	}
-	pe_export_table_info& exp = sub_fi_proper.m_export_table;
-	auto const dll_idx_ = &sub_fi - fi.m_fis;
-	assert(dll_idx_ >= 0 && dll_idx_ <= 0xFFFF);
-	std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
-	std::uint16_t const n = fi.m_import_table.m_import_counts[dll_idx];
-	for(int i = 0; i != n; ++i)
+	pe_export_table_info_t<idx_t>& exp = sub_mi.m_export_table;
+	idx_t const n = mi.m_import_table.m_import_counts[dll_idx];
+	for(idx_t i = 0; i != n; ++i)
 	{
-		std::uint16_t& matched_export = fi.m_import_table.m_matched_exports[dll_idx][i];
-		bool const is_ordinal = array_bool_tst(fi.m_import_table.m_are_ordinals[dll_idx], i);
+		idx_t& matched_export = mi.m_import_table.m_matched_exports[dll_idx][i];
+		bool const is_ordinal = array_bool_tst(mi.m_import_table.m_are_ordinals[dll_idx], i);
 		if(is_ordinal)
 		{
-			std::uint16_t const& ordinal = fi.m_import_table.m_ordinals_or_hints[dll_idx][i];
-			std::uint16_t const ordinal_as_idx = ordinal - exp.m_ordinal_base;
+			std::uint16_t const& ordinal = mi.m_import_table.m_ordinals_or_hints[dll_idx][i];
+			idx_t const ordinal_as_idx = static_cast<idx_t>(ordinal - exp.m_ordinal_base);
 			if(ordinal_as_idx < exp.m_count && exp.m_ordinals[ordinal_as_idx] == ordinal)
 			{
 				matched_export = ordinal_as_idx;
@@ -61,7 +101,7 @@ void pair_imports_with_exports(file_info& fi, file_info& sub_fi, tmp_type& to)
 				auto const it = std::lower_bound(exp.m_ordinals, ordinals_end, ordinal, [](auto const& e, auto const& v){ return e < v; });
 				if(it != ordinals_end && *it == ordinal)
 				{
-					matched_export = static_cast<std::uint16_t>(it - exp.m_ordinals);
+					matched_export = static_cast<idx_t>(it - exp.m_ordinals);
 				}
 				else
 				{
@@ -70,11 +110,8 @@ void pair_imports_with_exports(file_info& fi, file_info& sub_fi, tmp_type& to)
 		}
 		else
 		{
-			std::uint16_t const& hint = fi.m_import_table.m_ordinals_or_hints[dll_idx][i];
-			string_handle const& name = fi.m_import_table.m_names[dll_idx][i];
-			auto const it_2 = to.m_map.find(sub_fi.m_orig_instance ? sub_fi.m_orig_instance->m_file_path : sub_fi.m_file_path);
-			assert(it_2 != to.m_map.end());
-			auto const& enpt = it_2->second->m_enpt;
+			std::uint16_t const& hint = mi.m_import_table.m_ordinals_or_hints[dll_idx][i];
+			string_handle const& name = mi.m_import_table.m_names[dll_idx][i];
 			if(hint < enpt.m_count && exp.m_names[enpt.m_table[hint]] == name)
 			{
 				matched_export = enpt.m_table[hint];
@@ -92,39 +129,41 @@ void pair_imports_with_exports(file_info& fi, file_info& sub_fi, tmp_type& to)
 				}
 			}
 		}
-		#define ordinal_macro (fi.m_import_table.m_ordinals_or_hints[dll_idx][i])
-		#define name_macro (fi.m_import_table.m_names[dll_idx][i])
-		assert(matched_export == 0xFFFF || (is_ordinal ? (ordinal_macro == exp.m_ordinals[matched_export]) : (name_macro == exp.m_names[matched_export])));
+		#define ordinal_macro (mi.m_import_table.m_ordinals_or_hints[dll_idx][i])
+		#define name_macro (mi.m_import_table.m_names[dll_idx][i])
+		assert(matched_export == pe_invalid_idx_v<idx_t> || (is_ordinal ? (ordinal_macro == exp.m_ordinals[matched_export]) : (name_macro == exp.m_names[matched_export])));
 		#undef name_macro
 		#undef ordinal_macro
 	}
 }
 
-void pair_exports_with_imports(file_info& fi, file_info& sub_fi, tmp_type& to)
+template<typename idx_t>
+void pair_exports_with_imports(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, file_info_t<idx_t>& sub_fi, allocator& alc)
 {
-	file_info& sub_fi_proper = sub_fi.m_orig_instance ? *sub_fi.m_orig_instance : sub_fi;
-	if(sub_fi_proper.m_file_path.m_string == nullptr)
+	if(sub_mi.m_file_path.m_string == nullptr)
 	{
 		return;
 	}
-	pe_export_table_info& exp = sub_fi_proper.m_export_table;
-	sub_fi.m_matched_imports = to.m_mm->m_alc.allocate_objects<std::uint16_t>(exp.m_count);
-	std::fill(sub_fi.m_matched_imports, sub_fi.m_matched_imports + exp.m_count, static_cast<std::uint16_t>(0xFFFF));
-	auto const dll_idx_ = &sub_fi - fi.m_fis;
-	assert(dll_idx_ >= 0 && dll_idx_ <= 0xFFFF);
-	std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
-	std::uint16_t const& n_imports = fi.m_import_table.m_import_counts[dll_idx];
-	for(std::uint16_t i = 0; i != n_imports; ++i)
+	pe_export_table_info_t<idx_t>& exp = sub_mi.m_export_table;
+	sub_fi.m_matched_imports = alc.allocate_objects<idx_t>(exp.m_count, allocation_tag::matching);
+	std::fill(sub_fi.m_matched_imports, sub_fi.m_matched_imports + exp.m_count, pe_invalid_idx_v<idx_t>);
+	idx_t const& n_imports = mi.m_import_table.m_import_counts[dll_idx];
+	for(idx_t i = 0; i != n_imports; ++i)
 	{
-		std::uint16_t const& matched_export = fi.m_import_table.m_matched_exports[dll_idx][i];
-		if(matched_export == 0xFFFF)
+		idx_t const& matched_export = mi.m_import_table.m_matched_exports[dll_idx][i];
+		if(matched_export == pe_invalid_idx_v<idx_t>)
 		{
 			continue;
 		}
 		sub_fi.m_matched_imports[matched_export] = i;
-		if(!array_bool_tst(exp.m_are_used, matched_export))
-		{
-			array_bool_set(exp.m_are_used, matched_export);
-		}
+		array_bool_set(exp.m_are_used, matched_export);
 	}
 }
+
+
+template void pair_root<std::uint16_t>(tmp_type<std::uint16_t>& to);
+template void pair_root<std::uint32_t>(tmp_type<std::uint32_t>& to);
+template void pair_imports_with_exports<std::uint16_t>(module_info_t<std::uint16_t>& mi, std::uint16_t const dll_idx, module_info_t<std::uint16_t>& sub_mi, enptr_type<std::uint16_t> const& enpt);
+template void pair_imports_with_exports<std::uint32_t>(module_info_t<std::uint32_t>& mi, std::uint32_t const dll_idx, module_info_t<std::uint32_t>& sub_mi, enptr_type<std::uint32_t> const& enpt);
+template void pair_exports_with_imports<std::uint16_t>(module_info_t<std::uint16_t>& mi, std::uint16_t const dll_idx, module_info_t<std::uint16_t>& sub_mi, file_info_t<std::uint16_t>& sub_fi, allocator& alc);
+template void pair_exports_with_imports<std::uint32_t>(module_info_t<std::uint32_t>& mi, std::uint32_t const dll_idx, module_info_t<std::uint32_t>& sub_mi, file_info_t<std::uint32_t>& sub_fi, allocator& alc);
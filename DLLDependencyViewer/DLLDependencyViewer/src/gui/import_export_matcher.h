@@ -4,8 +4,11 @@
 #include "processor.h"
 #include "processor_impl.h"
 
+#include <cstdint>
 
-void pair_root(file_info& fi, tmp_type& to);
-void pair_all(file_info& fi, tmp_type& to);
-void pair_imports_with_exports(file_info& fi, file_info& sub_fi, tmp_type& to);
-void pair_exports_with_imports(file_info& fi, file_info& sub_fi, tmp_type& to);
+
+template<typename idx_t> void pair_root(tmp_type<idx_t>& to);
+template<typename idx_t> void pair_all(tmp_type<idx_t>& to);
+template<typename idx_t> void pair_module(std::uint32_t const module, tmp_type<idx_t>& to);
+template<typename idx_t> void pair_imports_with_exports(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, enptr_type<idx_t> const& enpt);
+template<typename idx_t> void pair_exports_with_imports(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, file_info_t<idx_t>& sub_fi, allocator& alc);
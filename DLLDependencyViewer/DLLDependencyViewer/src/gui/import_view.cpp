@@ -162,19 +162,17 @@ void import_view::on_getdispinfow(NMHDR& nmhdr)
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_parent = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_parent == TRUE);
-	file_info const& parent_fi = *reinterpret_cast<file_info*>(ti.lParam);
+	module_info_32 const& parent_fi = get_module(m_main_window.m_mo, *reinterpret_cast<file_info_32*>(ti.lParam));
 	ti.hItem = selected;
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_selected = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_selected == TRUE);
-	file_info const& tmp_fi = *reinterpret_cast<file_info*>(ti.lParam);
-	file_info const& fi = tmp_fi.m_orig_instance ? *tmp_fi.m_orig_instance : tmp_fi;
-	auto const dll_idx_ = &tmp_fi - parent_fi.m_fis;
-	assert(dll_idx_ >= 0 && dll_idx_ <= 0xFFFF);
-	std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
+	file_info_32 const& tmp_fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	module_info_32 const& fi = get_module(m_main_window.m_mo, tmp_fi);
+	std::uint32_t const dll_idx = get_dll_idx(m_main_window.m_mo, tmp_fi);
 	int const row = nm.item.iItem;
 	int const col = nm.item.iSubItem;
-	std::uint16_t const imp_idx = static_cast<std::uint16_t>(row);
+	std::uint32_t const imp_idx = static_cast<std::uint32_t>(row);
 	e_import_column const ecol = static_cast<e_import_column>(col);
 	if((nm.item.mask | LVIF_TEXT) != 0)
 	{
@@ -214,7 +212,7 @@ void import_view::on_getdispinfow(NMHDR& nmhdr)
 	}
 	if((nm.item.mask & LVIF_IMAGE) != 0)
 	{
-		std::uint16_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
+		std::uint32_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
 		std::uint8_t const icon_idx = pe_get_import_icon_id(parent_fi.m_import_table, dll_idx, imp_idx_sorted);
 		nm.item.iImage = icon_idx;
 	}
@@ -233,7 +231,7 @@ void import_view::on_columnclick(NMHDR& nmhdr)
 void import_view::on_context_menu(LPARAM const lparam)
 {
 	POINT cursor_screen;
-	std::uint16_t line_idx;
+	std::uint32_t line_idx;
 	if(lparam == LPARAM{-1})
 	{
 		LRESULT const sel = SendMessageW(m_hwnd, LVM_GETNEXTITEM, WPARAM{0} - 1, LVNI_SELECTED);
@@ -253,8 +251,7 @@ void import_view::on_context_menu(LPARAM const lparam)
 		cursor_screen.y = rect.top + (rect.bottom - rect.top) / 2;
 		BOOL const converted = ClientToScreen(m_hwnd, &cursor_screen);
 		assert(converted != 0);
-		assert(static_cast<std::size_t>(sel) <= 0xFFFF);
-		line_idx = static_cast<std::uint16_t>(sel);
+		line_idx = static_cast<std::uint32_t>(sel);
 	}
 	else
 	{
@@ -272,10 +269,9 @@ void import_view::on_context_menu(LPARAM const lparam)
 			return;
 		}
 		assert(hit_tested == hti.iItem);
-		assert(hti.iItem <= 0xFFFF);
-		line_idx = static_cast<std::uint16_t>(hti.iItem);
+		line_idx = static_cast<std::uint32_t>(hti.iItem);
 	}
-	std::uint16_t const import_idx = m_sort.empty() ? line_idx : m_sort[line_idx];
+	std::uint32_t const import_idx = m_sort.empty() ? line_idx : m_sort[line_idx];
 	HWND const tree = m_main_window.m_tree_view.get_hwnd();
 	HTREEITEM const tree_selected = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_CARET, 0));
 	if(!tree_selected)
@@ -292,18 +288,16 @@ void import_view::on_context_menu(LPARAM const lparam)
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_item = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
-	file_info const& fi = *reinterpret_cast<file_info*>(ti.lParam);
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(ti.lParam);
 	TVITEMEXW ti_2;
 	ti_2.hItem = tree_parent;
 	ti_2.mask = TVIF_PARAM;
 	LRESULT const got_item_2 = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti_2));
 	assert(got_item_2 == TRUE);
-	file_info const& parent_fi = *reinterpret_cast<file_info*>(ti_2.lParam);
-	auto const dll_idx_ = &fi - parent_fi.m_fis;
-	assert(dll_idx_ >= 0 && dll_idx_ <= 0xFFFF);
-	std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
-	std::uint16_t const& matched_export = parent_fi.m_import_table.m_matched_exports[dll_idx][import_idx];
-	bool const enable_goto_orig = matched_export != 0xFFFF;
+	module_info_32 const& parent_fi = get_module(m_main_window.m_mo, *reinterpret_cast<file_info_32*>(ti_2.lParam));
+	std::uint32_t const dll_idx = get_dll_idx(m_main_window.m_mo, fi);
+	std::uint32_t const& matched_export = parent_fi.m_import_table.m_matched_exports[dll_idx][import_idx];
+	bool const enable_goto_orig = matched_export != pe_invalid_idx_v<std::uint32_t>;
 	HMENU const menu = reinterpret_cast<HMENU>(m_menu.get());
 	BOOL const enabled = EnableMenuItem(menu, static_cast<std::uint16_t>(e_import_menu_id::e_matching), MF_BYCOMMAND | (enable_goto_orig ? MF_ENABLED : MF_GRAYED));
 	assert(enabled != -1 && (enabled == MF_ENABLED || enabled == MF_GRAYED));
@@ -361,7 +355,7 @@ void import_view::refresh()
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_1 = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_1 == TRUE);
-	file_info const& fi_tmp = *reinterpret_cast<file_info*>(ti.lParam);
+	file_info_32 const& fi_tmp = *reinterpret_cast<file_info_32*>(ti.lParam);
 	HTREEITEM const parent = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_PARENT, reinterpret_cast<LPARAM>(selected)));
 	if(parent)
 	{
@@ -370,10 +364,8 @@ void import_view::refresh()
 		ti_2.mask = TVIF_PARAM;
 		LRESULT const got_2 = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti_2));
 		assert(got_2 == TRUE);
-		file_info const& parent_fi = *reinterpret_cast<file_info*>(ti_2.lParam);
-		auto const idx_ = &fi_tmp - parent_fi.m_fis;
-		assert(idx_ >= 0 && idx_ <= 0xFFFF);
-		std::uint16_t const idx = static_cast<std::uint16_t>(idx_);
+		module_info_32 const& parent_fi = get_module(m_main_window.m_mo, *reinterpret_cast<file_info_32*>(ti_2.lParam));
+		std::uint32_t const idx = get_dll_idx(m_main_window.m_mo, fi_tmp);
 
 		LRESULT const set_size = SendMessageW(m_hwnd, LVM_SETITEMCOUNT, parent_fi.m_import_table.m_import_counts[idx], 0);
 		assert(set_size != 0);
@@ -405,7 +397,7 @@ void import_view::refresh_headers()
 	list_view_base::refresh_headers(&m_hwnd, static_cast<int>(std::size(s_import_headers)), m_main_window.m_settings.m_import_sort);
 }
 
-void import_view::select_item(std::uint16_t const item_idx)
+void import_view::select_item(std::uint32_t const item_idx)
 {
 	list_view_base::select_item(&m_hwnd, &m_sort, item_idx);
 	repaint();
@@ -439,33 +431,31 @@ void import_view::sort_view()
 		ti.mask = TVIF_PARAM;
 		LRESULT const got_parent = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got_parent == TRUE);
-		file_info const& parent_fi = *reinterpret_cast<file_info*>(ti.lParam);
+		module_info_32 const& parent_fi = get_module(m_main_window.m_mo, *reinterpret_cast<file_info_32*>(ti.lParam));
 		ti.hItem = selected;
 		ti.mask = TVIF_PARAM;
 		LRESULT const got_selected = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got_selected == TRUE);
-		file_info const& fi_tmp = *reinterpret_cast<file_info*>(ti.lParam);
-		file_info const& fi = fi_tmp.m_orig_instance ? *fi_tmp.m_orig_instance : fi_tmp;
-		auto const dll_idx_ = &fi_tmp - parent_fi.m_fis;
-		assert(dll_idx_ >= 0 && dll_idx_ <= 0xFFFF);
-		std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
-		pe_import_table_info const& iti = parent_fi.m_import_table;
-		pe_export_table_info const& eti = fi.m_export_table;
-
-		std::uint16_t const n_items = iti.m_import_counts[dll_idx];
+		file_info_32 const& fi_tmp = *reinterpret_cast<file_info_32*>(ti.lParam);
+		module_info_32 const& fi = get_module(m_main_window.m_mo, fi_tmp);
+		std::uint32_t const dll_idx = get_dll_idx(m_main_window.m_mo, fi_tmp);
+		pe_import_table_info_32 const& iti = parent_fi.m_import_table;
+		pe_export_table_info_32 const& eti = fi.m_export_table;
+
+		std::uint32_t const n_items = iti.m_import_counts[dll_idx];
 		if(static_cast<int>(m_sort.size()) != n_items * 2)
 		{
 			m_sort.resize(n_items * 2);
-			std::iota(m_sort.begin(), m_sort.end(), std::uint16_t{0});
+			std::iota(m_sort.begin(), m_sort.end(), std::uint32_t{0});
 		}
-		std::uint16_t* const sort = m_sort.data();
+		std::uint32_t* const sort = m_sort.data();
 		assert(cur_sort_col >= 0 && cur_sort_col < std::size(s_import_headers));
 		e_import_column const col = static_cast<e_import_column>(cur_sort_col);
 		switch(col)
 		{
 			case e_import_column::e_pi:
 			{
-				auto const fn_compare_icon = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_icon = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					std::uint8_t const icon_idx_a = pe_get_import_icon_id(iti, dll_idx, a);
 					std::uint8_t const icon_idx_b = pe_get_import_icon_id(iti, dll_idx, b);
@@ -483,7 +473,7 @@ void import_view::sort_view()
 			break;
 			case e_import_column::e_type:
 			{
-				auto const fn_compare_type = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_type = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					bool const is_ordinal_a = pe_get_import_is_ordinal(iti, dll_idx, a);
 					bool const is_ordinal_b = pe_get_import_is_ordinal(iti, dll_idx, b);
@@ -501,7 +491,7 @@ void import_view::sort_view()
 			break;
 			case e_import_column::e_ordinal:
 			{
-				auto const fn_compare_ordinal = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_ordinal = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					auto const ret_a = pe_get_import_ordinal(iti, eti, dll_idx, a);
 					auto const ret_b = pe_get_import_ordinal(iti, eti, dll_idx, b);
@@ -519,7 +509,7 @@ void import_view::sort_view()
 			break;
 			case e_import_column::e_hint:
 			{
-				auto const fn_compare_hint = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_hint = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					auto const ret_a = pe_get_import_hint(iti, eti, dll_idx, a);
 					auto const ret_b = pe_get_import_hint(iti, eti, dll_idx, b);
@@ -537,7 +527,7 @@ void import_view::sort_view()
 			break;
 			case e_import_column::e_name:
 			{
-				auto const fn_compare_name = [&](std::uint16_t const a, std::uint16_t const b, auto const& cmp) -> bool
+				auto const fn_compare_name = [&](std::uint32_t const a, std::uint32_t const b, auto const& cmp) -> bool
 				{
 					string_handle const ret_a = pe_get_import_name(iti, eti, dll_idx, a);
 					string_handle const ret_b = pe_get_import_name(iti, eti, dll_idx, b);
@@ -563,7 +553,7 @@ void import_view::sort_view()
 			}
 			break;
 		}
-		for(std::uint16_t i = 0; i != n_items; ++i)
+		for(std::uint32_t i = 0; i != n_items; ++i)
 		{
 			m_sort[n_items + m_sort[i]] = i;
 		}
@@ -586,9 +576,9 @@ smart_menu import_view::create_menu()
 	return smart_menu{menu};
 }
 
-wchar_t const* import_view::on_get_col_type(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+wchar_t const* import_view::on_get_col_type(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
-	std::uint16_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
+	std::uint32_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
 	bool const is_ordinal = pe_get_import_is_ordinal(iti, dll_idx, imp_idx_sorted);
 	if(is_ordinal)
 	{
@@ -600,9 +590,9 @@ wchar_t const* import_view::on_get_col_type(pe_import_table_info const& iti, std
 	}
 }
 
-wchar_t const* import_view::on_get_col_ordinal(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi)
+wchar_t const* import_view::on_get_col_ordinal(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi)
 {
-	std::uint16_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
+	std::uint32_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
 	auto const oridnal_opt = pe_get_import_ordinal(iti, fi.m_export_table, dll_idx, imp_idx_sorted);
 	if(oridnal_opt.m_is_valid)
 	{
@@ -614,9 +604,9 @@ wchar_t const* import_view::on_get_col_ordinal(pe_import_table_info const& iti,
 	}
 }
 
-wchar_t const* import_view::on_get_col_hint(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi)
+wchar_t const* import_view::on_get_col_hint(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi)
 {
-	std::uint16_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
+	std::uint32_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
 	auto const hint_opt = pe_get_import_hint(iti, fi.m_export_table, dll_idx, imp_idx_sorted);
 	if(hint_opt.m_is_valid)
 	{
@@ -628,9 +618,9 @@ wchar_t const* import_view::on_get_col_hint(pe_import_table_info const& iti, std
 	}
 }
 
-wchar_t const* import_view::on_get_col_name(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi)
+wchar_t const* import_view::on_get_col_name(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi)
 {
-	std::uint16_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
+	std::uint32_t const& imp_idx_sorted = m_sort.empty() ? imp_idx : m_sort[imp_idx];
 	bool const undecorate = m_main_window.m_settings.m_undecorate;
 	if(undecorate)
 	{
@@ -677,9 +667,8 @@ void import_view::select_matching_instance()
 	{
 		return;
 	}
-	assert(static_cast<std::size_t>(sel) <= 0xFFFF);
-	std::uint16_t const line_idx = static_cast<std::uint16_t>(sel);
-	std::uint16_t const import_idx = m_sort.empty() ? line_idx : m_sort[line_idx];
+	std::uint32_t const line_idx = static_cast<std::uint32_t>(sel);
+	std::uint32_t const import_idx = m_sort.empty() ? line_idx : m_sort[line_idx];
 	HWND const tree = m_main_window.m_tree_view.get_hwnd();
 	HTREEITEM const tree_selected = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_CARET, 0));
 	if(!tree_selected)
@@ -696,17 +685,16 @@ void import_view::select_matching_instance()
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_item = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
-	file_info const& fi = *reinterpret_cast<file_info*>(ti.lParam);
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(ti.lParam);
 	TVITEMEXW ti_2;
 	ti_2.hItem = tree_parent;
 	ti_2.mask = TVIF_PARAM;
 	LRESULT const got_item_2 = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti_2));
 	assert(got_item_2 == TRUE);
-	file_info const& parent_fi = *reinterpret_cast<file_info*>(ti_2.lParam);
-	auto const dll_idx_ = &fi - parent_fi.m_fis;
-	std::uint16_t const dll_idx = static_cast<std::uint16_t>(dll_idx_);
-	std::uint16_t const& matched_exp = parent_fi.m_import_table.m_matched_exports[dll_idx][import_idx];
-	if(matched_exp == 0xFFFF)
+	module_info_32 const& parent_fi = get_module(m_main_window.m_mo, *reinterpret_cast<file_info_32*>(ti_2.lParam));
+	std::uint32_t const dll_idx = get_dll_idx(m_main_window.m_mo, fi);
+	std::uint32_t const& matched_exp = parent_fi.m_import_table.m_matched_exports[dll_idx][import_idx];
+	if(matched_exp == pe_invalid_idx_v<std::uint32_t>)
 	{
 		return;
 	}
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "processor.h"
 #include "smart_menu.h"
 
 #include <cstdint>
@@ -13,9 +14,7 @@
 
 
 class main_window;
-struct file_info;
 struct pe_import_entry;
-struct pe_import_table_info;
 
 
 class import_view
@@ -40,20 +39,20 @@ public:
 	void refresh();
 	void repaint();
 	void refresh_headers();
-	void select_item(std::uint16_t const item_idx);
+	void select_item(std::uint32_t const item_idx);
 	void sort_view();
 private:
 	smart_menu create_menu();
-	wchar_t const* on_get_col_type(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx);
-	wchar_t const* on_get_col_ordinal(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi);
-	wchar_t const* on_get_col_hint(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi);
-	wchar_t const* on_get_col_name(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx, file_info const& fi);
+	wchar_t const* on_get_col_type(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx);
+	wchar_t const* on_get_col_ordinal(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi);
+	wchar_t const* on_get_col_hint(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi);
+	wchar_t const* on_get_col_name(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx, module_info_32 const& fi);
 	void select_matching_instance();
 	int get_type_column_max_width();
 private:
 	HWND const m_hwnd;
 	main_window& m_main_window;
 	smart_menu const m_menu;
-	std::vector<std::uint16_t> m_sort;
+	std::vector<std::uint32_t> m_sort;
 	string_converter m_string_converter;
 };
@@ -91,9 +91,8 @@ void list_view_base::refresh_headers(void const* const handle, int const n_heade
 void list_view_base::select_item(void const* const hwnd_ptr, void const* const sort_ptr, int const item_idx)
 {
 	HWND const& hwnd = *static_cast<HWND const*>(hwnd_ptr);
-	std::vector<std::uint16_t> const& sort = *static_cast<std::vector<std::uint16_t> const*>(sort_ptr);
-	assert(item_idx <= 0xFFFF);
-	std::uint16_t const ith_line = sort.empty() ? static_cast<std::uint16_t>(item_idx) : sort[sort.size() / 2 + item_idx];
+	std::vector<std::uint32_t> const& sort = *static_cast<std::vector<std::uint32_t> const*>(sort_ptr);
+	std::uint32_t const ith_line = sort.empty() ? static_cast<std::uint32_t>(item_idx) : sort[sort.size() / 2 + item_idx];
 	LRESULT const visibility_ensured = SendMessageW(hwnd, LVM_ENSUREVISIBLE, ith_line, FALSE);
 	assert(visibility_ensured == TRUE);
 	LVITEMW lvi;
@@ -1,5 +1,6 @@
 #include "main.h"
 
+#include "benchmark.h"
 #include "main_window.h"
 #include "splitter_window.h"
 #include "test.h"
@@ -29,6 +30,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance
 	init_known_dlls();
 	auto const fn_deinit_known_dlls = mk::make_scope_exit([](){ deinit_known_dlls(); });
 	test();
+	stats();
+	benchmark();
 	dbg_provider::init();
 	auto const dbg_provider_deinit = mk::make_scope_exit([](){ dbg_provider::deinit(); });
 	auto const fn_clean_actctx = mk::make_scope_exit([](){ activation_context::free_system_default_manifests(); });
@@ -1,5 +1,6 @@
 #include "main_window.h"
 
+#include "benchmark.h"
 #include "constants.h"
 #include "main.h"
 #include "smart_dc.h"
@@ -9,6 +10,7 @@
 #include "../nogui/dbg_provider.h"
 #include "../nogui/memory_mapped_file.h"
 #include "../nogui/pe.h"
+#include "../nogui/pe2.h"
 #include "../nogui/scope_exit.h"
 #include "../nogui/smart_local_free.h"
 #include "../nogui/utils.h"
@@ -37,8 +39,12 @@ static constexpr wchar_t const s_menu_view[] = L"&View";
 static constexpr wchar_t const s_menu_view_paths[] = L"&Full Paths\tF9";
 static constexpr wchar_t const s_menu_view_undecorate[] = L"&Undecorate C++ Functions\tF10";
 static constexpr wchar_t const s_menu_view_refresh[] = L"&Refresh\tF5";
+static constexpr wchar_t const s_menu_debug[] = L"&Debug";
+static constexpr wchar_t const s_menu_debug_stats[] = L"&Allocator Statistics";
 static constexpr wchar_t const s_open_file_dialog_file_name_filter[] = L"Executable files and libraries (*.exe;*.dll;*.ocx)\0*.exe;*.dll;*.ocx\0All files\0*.*\0";
 static constexpr wchar_t const s_msg_error[] = L"DLLDependencyViewer error.";
+static constexpr wchar_t const s_msg_export_validation[] = L"Export table of this module failed validation, some imports might not be matched to it.";
+static constexpr wchar_t const s_msg_stats[] = L"DLLDependencyViewer allocator statistics.";
 static constexpr wchar_t const s_toolbar_tooltip_open[] = L"Open... (Ctrl+O)";
 static constexpr wchar_t const s_toolbar_tooltip_full_paths[] = L"View Full Paths (F9)";
 static constexpr wchar_t const s_toolbar_tooltip_undecorate[] = L"Undecorate C++ Functions (F10)";
@@ -49,7 +55,8 @@ enum class e_main_menu_id : std::uint16_t
 	e_exit,
 	e_full_paths,
 	e_undecorate,
-	e_refresh
+	e_refresh,
+	e_stats
 };
 enum class e_toolbar : std::uint16_t
 {
@@ -268,6 +275,16 @@ HMENU main_window::create_menu()
 	BOOL const menu_view_refresh_appended = AppendMenuW(menu_view, MF_STRING, static_cast<std::uint16_t>(e_main_menu_id::e_refresh), s_menu_view_refresh);
 	assert(menu_view_refresh_appended != 0);
 
+	#if WANT_ALLOCATOR_STATS == 1
+	HMENU const menu_debug = CreatePopupMenu();
+	assert(menu_debug != nullptr);
+	BOOL const menu_debug_appended = AppendMenuW(menu_bar, MF_POPUP, reinterpret_cast<UINT_PTR>(menu_debug), s_menu_debug);
+	assert(menu_debug_appended != 0);
+
+	BOOL const menu_debug_stats_appended = AppendMenuW(menu_debug, MF_STRING, static_cast<std::uint16_t>(e_main_menu_id::e_stats), s_menu_debug_stats);
+	assert(menu_debug_stats_appended != 0);
+	#endif
+
 	return menu_bar;
 }
 
@@ -605,6 +622,11 @@ void main_window::on_menu(std::uint16_t const menu_id)
 			on_menu_refresh();
 		}
 		break;
+		case e_main_menu_id::e_stats:
+		{
+			on_menu_stats();
+		}
+		break;
 	}
 }
 
@@ -701,8 +723,99 @@ void main_window::on_toolbar(WPARAM const wparam)
 
 void main_window::on_tree_selchangedw()
 {
+	materialize_selected_file();
 	m_import_view.refresh();
 	m_export_view.refresh();
+	validate_selected_export_table();
+}
+
+void main_window::materialize_selected_file()
+{
+	HWND const tree = m_tree_view.get_hwnd();
+	HTREEITEM const selected = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_CARET, 0));
+	if(!selected)
+	{
+		return;
+	}
+	HTREEITEM const parent = reinterpret_cast<HTREEITEM>(SendMessageW(tree, TVM_GETNEXTITEM, TVGN_PARENT, reinterpret_cast<LPARAM>(selected)));
+	TVITEMW ti;
+	ti.mask = TVIF_PARAM;
+	ti.hItem = selected;
+	LRESULT const got_selected = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
+	assert(got_selected == TRUE);
+	file_info_32& tmp_fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	file_info_32* parent_fi = &get_root(m_mo);
+	if(parent)
+	{
+		ti.hItem = parent;
+		LRESULT const got_parent = SendMessageW(tree, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
+		assert(got_parent == TRUE);
+		parent_fi = reinterpret_cast<file_info_32*>(ti.lParam);
+	}
+	module_info_32& parent_mi = get_module(m_mo, *parent_fi);
+	module_info_32& fi = get_module(m_mo, tmp_fi);
+	if(tmp_fi.m_matched && fi.m_importers_matched)
+	{
+		return;
+	}
+	bool const parent_was_loaded = parent_mi.m_tables_loaded;
+	bool const fi_was_loaded = fi.m_tables_loaded;
+	bool const materialized = materialize(m_mo, m_mappings, *parent_fi, tmp_fi);
+	if(!materialized)
+	{
+		int const msgbox = MessageBoxW(m_hwnd, L"Failed to load import and export tables.", s_msg_error, MB_OK | MB_ICONERROR);
+		return;
+	}
+	if(!parent_was_loaded && parent_mi.m_tables_loaded)
+	{
+		request_symbols_from_addresses(parent_mi);
+		request_symbol_undecoration(parent_mi);
+	}
+	if(!fi_was_loaded && fi.m_tables_loaded && &fi != &parent_mi)
+	{
+		request_symbols_from_addresses(fi);
+		request_symbol_undecoration(fi);
+	}
+	// The export view marks exports used by any importer, not only by the selected edge.
+	std::vector<std::uint32_t> loaded;
+	bool const importers_materialized = materialize_importers(m_mo, m_mappings, tmp_fi.m_module, &loaded);
+	if(!importers_materialized)
+	{
+		int const msgbox = MessageBoxW(m_hwnd, L"Failed to load import and export tables.", s_msg_error, MB_OK | MB_ICONERROR);
+		return;
+	}
+	for(std::uint32_t const module : loaded)
+	{
+		request_symbols_from_addresses(m_mo.m_modules[module]);
+		request_symbol_undecoration(m_mo.m_modules[module]);
+	}
+}
+
+void main_window::validate_selected_export_table()
+{
+	HTREEITEM const selected = reinterpret_cast<HTREEITEM>(SendMessageW(m_tree_view.get_hwnd(), TVM_GETNEXTITEM, TVGN_CARET, 0));
+	if(!selected)
+	{
+		return;
+	}
+	TVITEMW ti;
+	ti.mask = TVIF_PARAM;
+	ti.hItem = selected;
+	LRESULT const got = SendMessageW(m_tree_view.get_hwnd(), TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
+	assert(got == TRUE);
+	file_info_32* const fi_tmp = reinterpret_cast<file_info_32*>(ti.lParam);
+	module_info_32& fi = get_module(m_mo, *fi_tmp);
+	if(fi.m_export_table.m_validation != pe_validation::pending)
+	{
+		return;
+	}
+	allocator tmp_alc;
+	bool const validated = pe_validate_export_table(fi.m_export_table, tmp_alc);
+	fi.m_export_table.m_validation = validated ? pe_validation::passed : pe_validation::failed;
+	if(!validated)
+	{
+		int const msgbox = MessageBoxW(m_hwnd, s_msg_export_validation, s_msg_error, MB_OK | MB_ICONWARNING);
+	}
 }
 
 void main_window::on_toolbar_notify(NMHDR& nmhdr)
@@ -771,6 +884,22 @@ void main_window::on_menu_refresh()
 	refresh();
 }
 
+void main_window::on_menu_stats()
+{
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats st;
+	m_mo.m_mm.get_stats(&st);
+	std::wstring str;
+	allocator_stats_to_string(st, str);
+	str.append(L"String hash computations: ");
+	str.append(std::to_wstring(m_mo.m_hash_computations));
+	str.append(L"\r\n");
+	stage_stats_to_string(m_mo.m_stage_stats, str);
+	OutputDebugStringW(str.c_str());
+	int const msgbox = MessageBoxW(m_hwnd, str.c_str(), s_msg_stats, MB_OK | MB_ICONINFORMATION);
+	#endif
+}
+
 void main_window::on_accel_open()
 {
 	open();
@@ -895,11 +1024,12 @@ void main_window::open()
 
 void main_window::open_files(std::vector<std::wstring> const& file_paths)
 {
-	main_type mo;
-	bool const processed = process(file_paths, &mo);
+	main_type_32 mo;
+	mapping_cache mappings;
+	bool const processed = process(file_paths, pe_parse_policy::deferred, process_mode::closure, read_backend::mapped, mappings, &mo);
 	if(processed)
 	{
-		refresh(std::move(mo));
+		refresh(std::move(mo), std::move(mappings));
 	}
 	else
 	{
@@ -912,14 +1042,15 @@ void main_window::exit()
 	LRESULT const sent = SendMessageW(m_hwnd, WM_CLOSE, 0, 0);
 }
 
-void main_window::refresh(main_type&& mo)
+void main_window::refresh(main_type_32&& mo, mapping_cache&& mappings)
 {
 	cancel_all_dbg_tasks();
 
-	auto tmp = std::make_unique<main_type>();
+	auto tmp = std::make_unique<main_type_32>();
 	using std::swap;
 	swap(*tmp, m_mo);
 	swap(m_mo, mo);
+	m_mappings = std::move(mappings);
 	request_mo_deletion(std::move(tmp));
 
 	m_tree_view.refresh();
@@ -963,19 +1094,23 @@ void main_window::undecorate()
 
 void main_window::refresh()
 {
-	file_info const& fi = m_mo.m_fi;
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
+	if(m_mo.m_nodes.empty())
+	{
+		return;
+	}
+	file_info_32 const& fi = get_root(m_mo);
+	std::uint32_t const n = get_child_count(m_mo, fi);
 	if(n == 0)
 	{
 		return;
 	}
 	assert(n >= 1);
+	file_info_32* const fis = get_children(m_mo, fi);
 	std::vector<std::wstring> file_paths;
 	file_paths.resize(n);
-	for(std::uint16_t i = 0; i != n; ++i)
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		file_info const* const orig = fi.m_fis[i].m_orig_instance;
-		wstring_handle const& name = orig ? orig->m_file_path : fi.m_fis[i].m_file_path;
+		wstring_handle const& name = get_module(m_mo, fis[i]).m_file_path;
 		file_paths[i].assign(cbegin(name), cend(name));
 	}
 	open_files(file_paths);
@@ -1040,7 +1175,7 @@ int main_window::get_ordinal_column_max_width()
 	return g_ordinal_column_max_width;
 }
 
-std::pair<file_info const*, POINT> main_window::get_file_info_2_under_cursor()
+std::pair<file_info_32 const*, POINT> main_window::get_file_info_2_under_cursor()
 {
 	POINT cursor_screen;
 	BOOL const got_cursor_pos = GetCursorPos(&cursor_screen);
@@ -1062,7 +1197,7 @@ std::pair<file_info const*, POINT> main_window::get_file_info_2_under_cursor()
 	LRESULT const got_item = SendMessageW(m_tree_view.get_hwnd(), TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
 	assert(ti.lParam);
-	file_info const* const fi = reinterpret_cast<file_info*>(ti.lParam);
+	file_info_32 const* const fi = reinterpret_cast<file_info_32*>(ti.lParam);
 	return {fi, cursor_screen};
 }
 
@@ -1107,6 +1242,14 @@ void main_window::process_command_line()
 	{
 		return;
 	}
+	if(argc >= 3 && std::wcsncmp(argv[1], s_cmd_arg_stats, std::size(s_cmd_arg_stats) - 1) == 0)
+	{
+		return;
+	}
+	if(argc == 4 && std::wcsncmp(argv[1], s_cmd_arg_bench, std::size(s_cmd_arg_bench) - 1) == 0)
+	{
+		return;
+	}
 	std::vector<std::wstring> file_paths;
 	file_paths.resize(argc - 1);
 	for(int i = 1; i != argc; ++i)
@@ -1164,11 +1307,11 @@ void main_window::cancel_all_dbg_tasks()
 	std::for_each(m_dbg_tasks.begin(), m_dbg_tasks.end(), [](auto& e){ static_cast<cancellable_task_param*>(e)->m_canceled.store(true); });
 }
 
-void main_window::request_mo_deletion(std::unique_ptr<main_type>&& mo)
+void main_window::request_mo_deletion(std::unique_ptr<main_type_32>&& mo)
 {
 	struct marshaller
 	{
-		std::unique_ptr<main_type> m_mo;
+		std::unique_ptr<main_type_32> m_mo;
 	};
 	marshaller m;
 	m.m_mo.swap(mo);
@@ -1198,15 +1341,14 @@ void main_window::request_close()
 	request_helper(this, dbg_provider::get(), std::move(m), fn_worker, fn_main);
 }
 
-void main_window::request_symbols_from_addresses(file_info& fi)
+void main_window::request_symbols_from_addresses(module_info_32& fi)
 {
-	pe_export_table_info* const eti = &fi.m_export_table;
-	std::uint16_t n = 0;
-	for(std::uint16_t i = 0; i != fi.m_export_table.m_count; ++i)
+	pe_export_table_info_32* const eti = &fi.m_export_table;
+	std::uint32_t n = 0;
+	for(int i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, 0); i != fi.m_export_table.m_count; i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, i + 1))
 	{
-		bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
-		bool const has_name = fi.m_export_table.m_hints[i] != 0xFFFF;
-		if(is_rva && !has_name)
+		bool const has_name = fi.m_export_table.m_hints[i] != pe_invalid_idx_v<std::uint32_t>;
+		if(!has_name)
 		{
 			++n;
 		}
@@ -1215,16 +1357,15 @@ void main_window::request_symbols_from_addresses(file_info& fi)
 	{
 		return;
 	}
-	std::vector<std::uint16_t> indexes;
+	std::vector<std::uint32_t> indexes;
 	indexes.resize(n);
-	std::uint16_t j = 0;
-	for(std::uint16_t i = 0; i != fi.m_export_table.m_count; ++i)
+	std::uint32_t j = 0;
+	for(int i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, 0); i != fi.m_export_table.m_count; i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, i + 1))
 	{
-		bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
-		bool const has_name = fi.m_export_table.m_hints[i] != 0xFFFF;
-		if(is_rva && !has_name)
+		bool const has_name = fi.m_export_table.m_hints[i] != pe_invalid_idx_v<std::uint32_t>;
+		if(!has_name)
 		{
-			indexes[j] = i;
+			indexes[j] = static_cast<std::uint32_t>(i);
 			++j;
 		}
 	}
@@ -1255,10 +1396,10 @@ void main_window::request_symbols_from_addresses(file_info& fi)
 void main_window::finish_symbols_from_addresses(symbols_from_addresses_param_t const& param)
 {
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		std::uint16_t const idx = param.m_indexes[i];
+		std::uint32_t const idx = param.m_indexes[i];
 		string_handle& dbg_name = param.m_eti->m_names[idx];
 		assert(!dbg_name);
 		if(!param.m_strings[i].empty())
@@ -1278,8 +1419,8 @@ void main_window::finish_symbols_from_addresses(symbols_from_addresses_param_t c
 		ti.hItem = selected;
 		LRESULT const got = SendMessageW(m_tree_view.get_hwnd(), TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got == TRUE);
-		file_info const* const fi = reinterpret_cast<file_info*>(ti.lParam);
-		if(fi == param.m_data || fi->m_orig_instance == param.m_data)
+		file_info_32 const* const fi = reinterpret_cast<file_info_32*>(ti.lParam);
+		if(&get_module(m_mo, *fi) == param.m_data)
 		{
 			m_import_view.sort_view();
 			m_export_view.sort_view();
@@ -1287,32 +1428,31 @@ void main_window::finish_symbols_from_addresses(symbols_from_addresses_param_t c
 			m_export_view.repaint();
 		}
 	}
-	request_symbol_undecoration_e(*static_cast<file_info*>(param.m_data), param.m_indexes);
+	request_symbol_undecoration_e(*static_cast<module_info_32*>(param.m_data), param.m_indexes);
 }
 
-void main_window::request_symbol_undecoration(file_info& fi)
+void main_window::request_symbol_undecoration(module_info_32& fi)
 {
-	std::vector<std::uint16_t> const empty_indexes;
+	std::vector<std::uint32_t> const empty_indexes;
 	request_symbol_undecoration_e(fi, empty_indexes);
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = fi.m_import_table.m_dll_count;
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
 		request_symbol_undecoration_i(fi, i);
 	}
 }
 
-void main_window::request_symbol_undecoration_e(file_info& fi, std::vector<std::uint16_t> const& input_indexes)
+void main_window::request_symbol_undecoration_e(module_info_32& fi, std::vector<std::uint32_t> const& input_indexes)
 {
-	pe_export_table_info const& eti = fi.m_export_table;
+	pe_export_table_info_32 const& eti = fi.m_export_table;
 	auto const fn_is_decorated = [](bool const is_rva, string_handle const& name){ return is_rva && name.m_string && name.m_string != static_cast<string const*>(nullptr) + 1 && cbegin(name)[0] == '?'; };
-	std::uint16_t n = 0;
+	std::uint32_t n = 0;
 	if(input_indexes.empty())
 	{
-		for(std::uint16_t i = 0; i != fi.m_export_table.m_count; ++i)
+		for(int i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, 0); i != fi.m_export_table.m_count; i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, i + 1))
 		{
-			bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
 			string_handle const& name = fi.m_export_table.m_names[i];
-			if(fn_is_decorated(is_rva, name))
+			if(fn_is_decorated(true, name))
 			{
 				++n;
 			}
@@ -1320,7 +1460,7 @@ void main_window::request_symbol_undecoration_e(file_info& fi, std::vector<std::
 	}
 	else
 	{
-		for(std::uint16_t const i : input_indexes)
+		for(std::uint32_t const i : input_indexes)
 		{
 			bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
 			string_handle const& name = fi.m_export_table.m_names[i];
@@ -1334,26 +1474,25 @@ void main_window::request_symbol_undecoration_e(file_info& fi, std::vector<std::
 	{
 		return;
 	}
-	std::vector<std::uint16_t> indexes;
+	std::vector<std::uint32_t> indexes;
 	indexes.resize(n);
-	std::uint16_t j = 0;
+	std::uint32_t j = 0;
 	if(input_indexes.empty())
 	{
-		for(std::uint16_t i = 0; i != fi.m_export_table.m_count; ++i)
+		for(int i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, 0); i != fi.m_export_table.m_count; i = array_bool_find_next(fi.m_export_table.m_are_rvas, fi.m_export_table.m_count, i + 1))
 		{
-			bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
 			string_handle const& name = fi.m_export_table.m_names[i];
-			if(!fn_is_decorated(is_rva, name))
+			if(!fn_is_decorated(true, name))
 			{
 				continue;
 			}
-			indexes[j] = i;
+			indexes[j] = static_cast<std::uint32_t>(i);
 			++j;
 		}
 	}
 	else
 	{
-		for(std::uint16_t const i : input_indexes)
+		for(std::uint32_t const i : input_indexes)
 		{
 			bool const is_rva = array_bool_tst(fi.m_export_table.m_are_rvas, i);
 			string_handle const& name = fi.m_export_table.m_names[i];
@@ -1391,10 +1530,10 @@ void main_window::request_symbol_undecoration_e(file_info& fi, std::vector<std::
 void main_window::finish_symbol_undecoration_e(undecorated_from_decorated_e_param_t const& param)
 {
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		std::uint16_t const idx = param.m_indexes[i];
+		std::uint32_t const idx = param.m_indexes[i];
 		string_handle& undecorated_name = param.m_eti->m_undecorated_names[idx];
 		assert(!undecorated_name);
 		if(!param.m_strings[i].empty())
@@ -1414,8 +1553,8 @@ void main_window::finish_symbol_undecoration_e(undecorated_from_decorated_e_para
 		ti.hItem = selected;
 		LRESULT const got = SendMessageW(m_tree_view.get_hwnd(), TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got == TRUE);
-		file_info const* const fi = reinterpret_cast<file_info*>(ti.lParam);
-		if(fi == param.m_data || fi->m_orig_instance == param.m_data)
+		file_info_32 const* const fi = reinterpret_cast<file_info_32*>(ti.lParam);
+		if(&get_module(m_mo, *fi) == param.m_data)
 		{
 			m_import_view.sort_view();
 			m_export_view.sort_view();
@@ -1425,11 +1564,11 @@ void main_window::finish_symbol_undecoration_e(undecorated_from_decorated_e_para
 	}
 }
 
-void main_window::request_symbol_undecoration_i(file_info& fi, std::uint16_t const dll_idx)
+void main_window::request_symbol_undecoration_i(module_info_32& fi, std::uint32_t const dll_idx)
 {
-	pe_import_table_info const& iti = fi.m_import_table;
-	std::uint16_t n = 0;
-	for(std::uint16_t i = 0; i != fi.m_import_table.m_import_counts[dll_idx]; ++i)
+	pe_import_table_info_32 const& iti = fi.m_import_table;
+	std::uint32_t n = 0;
+	for(std::uint32_t i = 0; i != fi.m_import_table.m_import_counts[dll_idx]; ++i)
 	{
 		bool const is_ordinal = array_bool_tst(fi.m_import_table.m_are_ordinals[dll_idx], i);
 		if(is_ordinal)
@@ -1447,10 +1586,10 @@ void main_window::request_symbol_undecoration_i(file_info& fi, std::uint16_t con
 	{
 		return;
 	}
-	std::vector<std::uint16_t> indexes;
+	std::vector<std::uint32_t> indexes;
 	indexes.resize(n);
-	std::uint16_t j = 0;
-	for(std::uint16_t i = 0; i != fi.m_import_table.m_import_counts[dll_idx]; ++i)
+	std::uint32_t j = 0;
+	for(std::uint32_t i = 0; i != fi.m_import_table.m_import_counts[dll_idx]; ++i)
 	{
 		bool const is_ordinal = array_bool_tst(fi.m_import_table.m_are_ordinals[dll_idx], i);
 		if(is_ordinal)
@@ -1492,10 +1631,10 @@ void main_window::request_symbol_undecoration_i(file_info& fi, std::uint16_t con
 void main_window::finish_symbol_undecoration_i(undecorated_from_decorated_i_param_t const& param)
 {
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		std::uint16_t const idx = param.m_indexes[i];
+		std::uint32_t const idx = param.m_indexes[i];
 		string_handle& undecorated_name = param.m_iti->m_undecorated_names[param.m_dll_idx][idx];
 		assert(!undecorated_name);
 		if(!param.m_strings[i].empty())
@@ -1515,8 +1654,8 @@ void main_window::finish_symbol_undecoration_i(undecorated_from_decorated_i_para
 		ti.hItem = selected;
 		LRESULT const got = SendMessageW(m_tree_view.get_hwnd(), TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got == TRUE);
-		file_info const* const fi = reinterpret_cast<file_info*>(ti.lParam);
-		if(fi == param.m_data || fi->m_orig_instance == param.m_data)
+		file_info_32 const* const fi = reinterpret_cast<file_info_32*>(ti.lParam);
+		if(&get_module(m_mo, *fi) == param.m_data)
 		{
 			m_import_view.sort_view();
 			m_export_view.sort_view();
@@ -75,12 +75,15 @@ private:
 	void on_accelerator(WPARAM const wparam);
 	void on_toolbar(WPARAM const wparam);
 	void on_tree_selchangedw();
+	void materialize_selected_file();
+	void validate_selected_export_table();
 	void on_toolbar_notify(NMHDR& nmhdr);
 	void on_menu_open();
 	void on_menu_exit();
 	void on_menu_paths();
 	void on_menu_undecorate();
 	void on_menu_refresh();
+	void on_menu_stats();
 	void on_accel_open();
 	void on_accel_paths();
 	void on_accel_undecorate();
@@ -93,12 +96,12 @@ private:
 	void open();
 	void open_files(std::vector<std::wstring> const& file_paths);
 	void exit();
-	void refresh(main_type&& mo);
+	void refresh(main_type_32&& mo, mapping_cache&& mappings);
 	void full_paths();
 	void undecorate();
 	void refresh();
 	int get_ordinal_column_max_width();
-	std::pair<file_info const*, POINT> get_file_info_2_under_cursor();
+	std::pair<file_info_32 const*, POINT> get_file_info_2_under_cursor();
 	void add_idle_task(idle_task_t const task, idle_task_param_t const param);
 	void on_idle();
 	void process_command_line();
@@ -107,14 +110,14 @@ private:
 	void update_staus_bar();
 	void draw_status_bar(DRAWITEMSTRUCT& ds);
 	void cancel_all_dbg_tasks();
-	void request_mo_deletion(std::unique_ptr<main_type>&& mo);
+	void request_mo_deletion(std::unique_ptr<main_type_32>&& mo);
 	void request_close();
-	void request_symbols_from_addresses(file_info& fi);
+	void request_symbols_from_addresses(module_info_32& fi);
 	void finish_symbols_from_addresses(symbols_from_addresses_param_t const& param);
-	void request_symbol_undecoration(file_info& fi);
-	void request_symbol_undecoration_e(file_info& fi, std::vector<std::uint16_t> const& input_indexes);
+	void request_symbol_undecoration(module_info_32& fi);
+	void request_symbol_undecoration_e(module_info_32& fi, std::vector<std::uint32_t> const& input_indexes);
 	void finish_symbol_undecoration_e(undecorated_from_decorated_e_param_t const& param);
-	void request_symbol_undecoration_i(file_info& fi, std::uint16_t const dll_idx);
+	void request_symbol_undecoration_i(module_info_32& fi, std::uint32_t const dll_idx);
 	void finish_symbol_undecoration_i(undecorated_from_decorated_i_param_t const& param);
 private:
 	static ATOM g_class;
@@ -131,7 +134,9 @@ private:
 	std::queue<std::pair<idle_task_t, idle_task_param_t>> m_idle_tasks;
 	std::deque<thread_worker_param_t> m_dbg_tasks;
 private:
-	main_type m_mo;
+	main_type_32 m_mo;
+	// Views mapped while walking m_mo, kept for lazy loading, replaced together with m_mo.
+	mapping_cache m_mappings;
 	settings m_settings;
 private:
 	friend class tree_view;
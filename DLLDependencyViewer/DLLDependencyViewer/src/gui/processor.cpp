@@ -3,9 +3,13 @@
 #include "processor_impl.h"
 
 #include "../nogui/assert.h"
+#include "../nogui/pe2.h"
 
 #include <cassert>
+#include <cstddef>
 #include <cstring>
+#include <numeric>
+#include <string>
 #include <type_traits>
 
 
@@ -41,24 +45,304 @@ inline constexpr bool is_simple_type_v =
 	std::is_nothrow_swappable_v              	<T>;
 
 
+static_assert(is_simple_type_v<module_info>, "");
+static_assert(is_simple_type_v<module_info_32>, "");
 static_assert(is_simple_type_v<file_info>, "");
+static_assert(is_simple_type_v<file_info_32>, "");
 
 
-void init(file_info* const fi)
+template<typename idx_t>
+void init(module_info_t<idx_t>* const mi)
+{
+	init(mi, 1);
+}
+
+template<typename idx_t>
+void init(module_info_t<idx_t>* const mi, int const count)
+{
+	std::memset(mi, 0, count * sizeof(*mi));
+}
+
+template<typename idx_t>
+void init(file_info_t<idx_t>* const fi)
 {
 	init(fi, 1);
 }
 
-void init(file_info* const fi, int const count)
+template<typename idx_t>
+void init(file_info_t<idx_t>* const fi, int const count)
 {
 	std::memset(fi, 0, count * sizeof(*fi));
 }
 
+void init(stage_stats* const stats)
+{
+	assert(stats);
+	stats->m_prefetch_threads = 0;
+	stats->m_prefetch_misses = 0;
+	latency_histogram_init(&stats->m_locate);
+	latency_histogram_init(&stats->m_prefetch_read);
+	latency_histogram_init(&stats->m_open);
+	latency_histogram_init(&stats->m_parse);
+}
 
-bool process(std::vector<std::wstring> const& file_paths, main_type* const mo_out)
+void stage_stats_to_string(stage_stats const& stats, std::wstring& str)
+{
+	str.append(L"Prefetch threads: ");
+	str.append(std::to_wstring(stats.m_prefetch_threads));
+	str.append(L"\r\n");
+	str.append(L"Prefetch misses: ");
+	str.append(std::to_wstring(stats.m_prefetch_misses));
+	str.append(L"\r\n");
+	latency_histogram_to_string(stats.m_locate, L"Locate", str);
+	latency_histogram_to_string(stats.m_prefetch_read, L"Prefetch read", str);
+	latency_histogram_to_string(stats.m_open, L"Open", str);
+	latency_histogram_to_string(stats.m_parse, L"Parse", str);
+}
+
+
+template<typename idx_t>
+bool process(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, mapping_cache& mappings, main_type_t<idx_t>* const mo_out)
+{
+	return process(file_paths, policy, mode, backend, nullptr, mappings, mo_out);
+}
+
+template<typename idx_t>
+bool process(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, mapping_cache& mappings, main_type_t<idx_t>* const mo_out)
 {
 	assert(mo_out);
-	bool const processed = process_impl(file_paths, mo_out->m_fi, mo_out->m_mm);
+	#if WANT_ALLOCATOR_STATS == 1
+	std::uint64_t const hash_computations = string_hash_get_computations();
+	#endif
+	bool canceled = false;
+	bool const processed = process_impl(file_paths, policy, mode, backend, control, mo_out->m_modules, mo_out->m_nodes, mo_out->m_mm, mappings, mo_out->m_stage_stats, &canceled);
+	if(canceled)
+	{
+		return false;
+	}
 	WARN_M_R(processed, L"Failed to process_impl.", false);
+	mo_out->m_policy = policy;
+	mo_out->m_backend = backend;
+	#if WANT_ALLOCATOR_STATS == 1
+	mo_out->m_hash_computations = string_hash_get_computations() - hash_computations;
+	#endif
 	return true;
 }
+
+template<typename idx_t>
+bool materialize(main_type_t<idx_t>& mo, mapping_cache& mappings, file_info_t<idx_t>& fi, file_info_t<idx_t>& sub_fi)
+{
+	bool const materialized = materialize_impl(get_module(mo, fi), get_dll_idx(mo, sub_fi), get_module(mo, sub_fi), sub_fi, mo.m_policy, mo.m_backend, mo.m_mm, mappings);
+	WARN_M_R(materialized, L"Failed to materialize_impl.", false);
+	return true;
+}
+
+template<typename idx_t>
+static bool materialize_edge(main_type_t<idx_t>& mo, mapping_cache& mappings, std::uint32_t const node, std::vector<std::uint32_t>* const loaded_out)
+{
+	file_info_t<idx_t>& sub_fi = mo.m_nodes[node];
+	if(sub_fi.m_matched)
+	{
+		return true;
+	}
+	module_info_t<idx_t>& mi = mo.m_modules[sub_fi.m_parent_module];
+	bool const was_loaded = mi.m_tables_loaded;
+	bool const materialized = materialize_impl(mi, get_dll_idx(mo, sub_fi), get_module(mo, sub_fi), sub_fi, mo.m_policy, mo.m_backend, mo.m_mm, mappings);
+	WARN_M_R(materialized, L"Failed to materialize_impl.", false);
+	if(loaded_out && !was_loaded && mi.m_tables_loaded)
+	{
+		loaded_out->push_back(sub_fi.m_parent_module);
+	}
+	return true;
+}
+
+template<typename idx_t>
+bool materialize_importers(main_type_t<idx_t>& mo, mapping_cache& mappings, std::uint32_t const module, std::vector<std::uint32_t>* const loaded_out)
+{
+	assert(loaded_out);
+	assert(module < mo.m_modules.size());
+	module_info_t<idx_t>& sub_mi = mo.m_modules[module];
+	if(module == s_missing_module || module == s_root_module || sub_mi.m_importers_matched)
+	{
+		return true;
+	}
+	std::uint32_t const n = static_cast<std::uint32_t>(mo.m_nodes.size());
+	for(std::uint32_t i = s_root_node + 1; i != n; ++i)
+	{
+		if(mo.m_nodes[i].m_module != module)
+		{
+			continue;
+		}
+		bool const materialized = materialize_edge(mo, mappings, i, loaded_out);
+		WARN_M_R(materialized, L"Failed to materialize_edge.", false);
+	}
+	sub_mi.m_importers_matched = true;
+	return true;
+}
+
+template<typename idx_t>
+bool materialize_all(main_type_t<idx_t>& mo, mapping_cache& mappings, process_control const* const control)
+{
+	std::uint32_t const n = static_cast<std::uint32_t>(mo.m_modules.size());
+	std::uint32_t const n_nodes = static_cast<std::uint32_t>(mo.m_nodes.size());
+	// Importer edges grouped by module in one pass, a per-module scan of all nodes would be quadratic.
+	std::vector<std::uint32_t> importers_begin(n + 1, 0);
+	for(std::uint32_t i = s_root_node + 1; i != n_nodes; ++i)
+	{
+		++importers_begin[mo.m_nodes[i].m_module + 1];
+	}
+	std::partial_sum(importers_begin.begin(), importers_begin.end(), importers_begin.begin());
+	std::vector<std::uint32_t> importers(importers_begin.back());
+	std::vector<std::uint32_t> importers_end(importers_begin.begin(), importers_begin.end() - 1);
+	for(std::uint32_t i = s_root_node + 1; i != n_nodes; ++i)
+	{
+		importers[importers_end[mo.m_nodes[i].m_module]++] = i;
+	}
+	process_progress progress{};
+	progress.m_modules_parsed = static_cast<int>(n - (s_root_module + 1));
+	for(std::uint32_t i = s_root_module + 1; i != n; ++i)
+	{
+		if(control && control->m_cancel && control->m_cancel->load())
+		{
+			return false;
+		}
+		module_info_t<idx_t>& sub_mi = mo.m_modules[i];
+		if(!sub_mi.m_importers_matched)
+		{
+			for(std::uint32_t j = importers_begin[i]; j != importers_begin[i + 1]; ++j)
+			{
+				bool const materialized = materialize_edge(mo, mappings, importers[j], nullptr);
+				WARN_M_R(materialized, L"Failed to materialize_edge.", false);
+			}
+			sub_mi.m_importers_matched = true;
+		}
+		++progress.m_modules_materialized;
+		if(control && control->m_progress_fn)
+		{
+			control->m_progress_fn(progress, control->m_progress_param);
+		}
+	}
+	for(std::uint32_t i = s_root_module + 1; i != n; ++i)
+	{
+		pe_export_table_info_t<idx_t>& eti = mo.m_modules[i].m_export_table;
+		if(eti.m_validation != pe_validation::pending)
+		{
+			continue;
+		}
+		allocator tmp_alc;
+		bool const validated = pe_validate_export_table(eti, tmp_alc);
+		eti.m_validation = validated ? pe_validation::passed : pe_validation::failed;
+	}
+	return true;
+}
+
+
+template<typename idx_t>
+file_info_t<idx_t>& get_root(main_type_t<idx_t>& mo)
+{
+	assert(!mo.m_nodes.empty());
+	return mo.m_nodes[s_root_node];
+}
+
+template<typename idx_t>
+file_info_t<idx_t> const& get_root(main_type_t<idx_t> const& mo)
+{
+	assert(!mo.m_nodes.empty());
+	return mo.m_nodes[s_root_node];
+}
+
+template<typename idx_t>
+std::uint32_t get_node_idx(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi)
+{
+	auto const idx = &fi - mo.m_nodes.data();
+	assert(idx >= 0 && idx < static_cast<std::ptrdiff_t>(mo.m_nodes.size()));
+	return static_cast<std::uint32_t>(idx);
+}
+
+template<typename idx_t>
+module_info_t<idx_t>& get_module(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi)
+{
+	return mo.m_modules[fi.m_module];
+}
+
+template<typename idx_t>
+module_info_t<idx_t> const& get_module(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi)
+{
+	return mo.m_modules[fi.m_module];
+}
+
+template<typename idx_t>
+file_info_t<idx_t>* get_orig_instance(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi)
+{
+	return const_cast<file_info_t<idx_t>*>(get_orig_instance(static_cast<main_type_t<idx_t> const&>(mo), fi));
+}
+
+template<typename idx_t>
+file_info_t<idx_t> const* get_orig_instance(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi)
+{
+	if(fi.m_module == s_missing_module)
+	{
+		return nullptr;
+	}
+	std::uint32_t const orig_node = mo.m_modules[fi.m_module].m_orig_node;
+	if(orig_node == get_node_idx(mo, fi))
+	{
+		return nullptr;
+	}
+	return &mo.m_nodes[orig_node];
+}
+
+template<typename idx_t>
+idx_t get_child_count(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi)
+{
+	if(fi.m_module == s_missing_module || get_orig_instance(mo, fi) != nullptr)
+	{
+		return 0;
+	}
+	return mo.m_modules[fi.m_module].m_import_table.m_dll_count;
+}
+
+template<typename idx_t>
+file_info_t<idx_t>* get_children(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi)
+{
+	if(get_child_count(mo, fi) == 0)
+	{
+		return nullptr;
+	}
+	return mo.m_nodes.data() + mo.m_modules[fi.m_module].m_first_child;
+}
+
+template<typename idx_t>
+idx_t get_dll_idx(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi)
+{
+	auto const idx = static_cast<std::int64_t>(get_node_idx(mo, fi)) - mo.m_modules[fi.m_parent_module].m_first_child;
+	assert(idx >= 0 && idx < mo.m_modules[fi.m_parent_module].m_import_table.m_dll_count);
+	return static_cast<idx_t>(idx);
+}
+
+
+#define INSTANTIATE_PROCESSOR(idx_t) \
+	template void init<idx_t>(module_info_t<idx_t>* const mi); \
+	template void init<idx_t>(module_info_t<idx_t>* const mi, int const count); \
+	template void init<idx_t>(file_info_t<idx_t>* const fi); \
+	template void init<idx_t>(file_info_t<idx_t>* const fi, int const count); \
+	template bool process<idx_t>(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, mapping_cache& mappings, main_type_t<idx_t>* const mo_out); \
+	template bool process<idx_t>(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, mapping_cache& mappings, main_type_t<idx_t>* const mo_out); \
+	template bool materialize<idx_t>(main_type_t<idx_t>& mo, mapping_cache& mappings, file_info_t<idx_t>& fi, file_info_t<idx_t>& sub_fi); \
+	template bool materialize_importers<idx_t>(main_type_t<idx_t>& mo, mapping_cache& mappings, std::uint32_t const module, std::vector<std::uint32_t>* const loaded_out); \
+	template bool materialize_all<idx_t>(main_type_t<idx_t>& mo, mapping_cache& mappings, process_control const* const control); \
+	template file_info_t<idx_t>& get_root<idx_t>(main_type_t<idx_t>& mo); \
+	template file_info_t<idx_t> const& get_root<idx_t>(main_type_t<idx_t> const& mo); \
+	template std::uint32_t get_node_idx<idx_t>(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi); \
+	template module_info_t<idx_t>& get_module<idx_t>(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi); \
+	template module_info_t<idx_t> const& get_module<idx_t>(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi); \
+	template file_info_t<idx_t>* get_orig_instance<idx_t>(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi); \
+	template file_info_t<idx_t> const* get_orig_instance<idx_t>(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi); \
+	template idx_t get_child_count<idx_t>(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi); \
+	template file_info_t<idx_t>* get_children<idx_t>(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi); \
+	template idx_t get_dll_idx<idx_t>(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
+
+INSTANTIATE_PROCESSOR(std::uint16_t)
+INSTANTIATE_PROCESSOR(std::uint32_t)
+
+#undef INSTANTIATE_PROCESSOR
@@ -1,31 +1,190 @@
 #pragma once
 
+#include "../nogui/latency_histogram.h"
+#include "../nogui/mapping_cache.h"
 #include "../nogui/memory_manager.h"
 #include "../nogui/my_string_handle.h"
 #include "../nogui/pe.h"
 
+#include <atomic>
 #include <cstdint>
+#include <vector>
 
 
-struct file_info
+class traversal_hints;
+
+
+enum class truncation : std::uint8_t
+{
+	none,
+	modules,
+	depth,
+	bytes,
+	time,
+	parse_time,
+};
+
+static constexpr std::uint32_t const s_missing_module = 0;
+static constexpr std::uint32_t const s_root_module = 1;
+static constexpr std::uint32_t const s_root_node = 0;
+
+// Stored once per module. Modules and nodes form the dependency graph in CSR form,
+// the edges of a module are the m_import_table.m_dll_count nodes starting at m_first_child.
+// The idx_t parameter is the width of per-module import, export and DLL indexes, the GUI
+// uses the 32-bit layout so it never hits the 0xFFFF limits of the compact 16-bit one.
+template<typename idx_t>
+struct module_info_t
 {
-	void* m_tree_item;
-	file_info* m_fis;
-	file_info* m_orig_instance;
 	wstring_handle m_file_path;
+	pe_import_table_info_t<idx_t> m_import_table;
+	pe_export_table_info_t<idx_t> m_export_table;
+	idx_t const* m_enpt;
+	std::uint32_t m_first_child;
+	std::uint32_t m_orig_node;
+	idx_t m_enpt_count;
 	bool m_is_32_bit;
-	pe_import_table_info m_import_table;
-	pe_export_table_info m_export_table;
-	std::uint16_t* m_matched_imports;
+	bool m_tables_loaded;
+	bool m_importers_matched;
+	truncation m_truncation;
+};
+typedef module_info_t<std::uint16_t> module_info;
+typedef module_info_t<std::uint32_t> module_info_32;
+template<typename idx_t> void init(module_info_t<idx_t>* const mi);
+template<typename idx_t> void init(module_info_t<idx_t>* const mi, int const count);
+
+// One per import edge. The tree is a projection of the graph, only the node that is its
+// module's m_orig_node expands the module's edges, the other nodes are duplicates.
+template<typename idx_t>
+struct file_info_t
+{
+	idx_t* m_matched_imports;
+	std::uint32_t m_module;
+	std::uint32_t m_parent_module;
+	bool m_matched;
+};
+typedef file_info_t<std::uint16_t> file_info;
+typedef file_info_t<std::uint32_t> file_info_32;
+template<typename idx_t> void init(file_info_t<idx_t>* const fi);
+template<typename idx_t> void init(file_info_t<idx_t>* const fi, int const count);
+
+enum class process_mode : std::uint8_t
+{
+	full,
+	closure,
+};
+
+enum class read_backend : std::uint8_t
+{
+	mapped,
+	selective,
+};
+
+struct process_budget
+{
+	int m_max_modules;
+	int m_max_depth;
+	std::uint64_t m_max_bytes;
+	std::uint32_t m_max_time_ms;
+	std::uint32_t m_max_file_parse_ms;
 };
-void init(file_info* const fi);
-void init(file_info* const fi, int const count);
 
-struct main_type
+// While materializing, m_modules_parsed is the number of modules in the graph and the walk
+// fields are zero.
+struct process_progress
 {
-	file_info m_fi;
+	int m_modules_parsed;
+	int m_modules_truncated;
+	int m_modules_materialized;
+	int m_queue_depth;
+	std::uint64_t m_bytes_read;
+};
+typedef void(*process_progress_fn_t)(process_progress const& progress, void* const param);
+
+enum class process_event_kind : std::uint8_t
+{
+	module_parsed,
+	edge_resolved,
+	edge_unresolved,
+	edge_matched,
+};
+
+struct process_event
+{
+	process_event_kind m_kind;
+	std::uint32_t m_parent;
+	std::uint32_t m_index;
+	std::uint32_t m_node;
+	std::uint32_t m_module;
+	wstring_handle m_file_path;
+	string_handle m_dll_name;
+	std::uint16_t m_machine;
+	std::uint32_t m_import_count;
+	std::uint32_t m_missing_imports;
+};
+typedef bool(*process_event_fn_t)(process_event const& event, void* const param);
+
+struct process_control
+{
+	std::atomic<bool> const* m_cancel;
+	process_progress_fn_t m_progress_fn;
+	void* m_progress_param;
+	process_event_fn_t m_event_fn;
+	void* m_event_param;
+	traversal_hints const* m_hints;
+	process_budget m_budget;
+};
+
+// Latency of each step of the graph walk. Only the prefetch reads run on other threads,
+// locating, opening and parsing run one file at a time on the calling thread.
+struct stage_stats
+{
+	int m_prefetch_threads;
+	int m_prefetch_misses;
+	latency_histogram m_locate;
+	latency_histogram m_prefetch_read;
+	latency_histogram m_open;
+	latency_histogram m_parse;
+};
+void init(stage_stats* const stats);
+void stage_stats_to_string(stage_stats const& stats, std::wstring& str);
+
+template<typename idx_t>
+struct main_type_t
+{
+	std::vector<module_info_t<idx_t>> m_modules;
+	std::vector<file_info_t<idx_t>> m_nodes;
 	memory_manager m_mm;
+	pe_parse_policy m_policy = pe_parse_policy::strict;
+	read_backend m_backend = read_backend::mapped;
+	stage_stats m_stage_stats = {};
+	#if WANT_ALLOCATOR_STATS == 1
+	std::uint64_t m_hash_computations = 0;
+	#endif
 };
+typedef main_type_t<std::uint16_t> main_type;
+typedef main_type_t<std::uint32_t> main_type_32;
+
 
+// The walk maps files through mappings, later materialize calls with the same cache reuse those views.
+// The cache is keyed by file paths owned by mo_out, so it must not outlive it.
+template<typename idx_t> bool process(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, mapping_cache& mappings, main_type_t<idx_t>* const mo_out);
+template<typename idx_t> bool process(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, mapping_cache& mappings, main_type_t<idx_t>* const mo_out);
+template<typename idx_t> bool materialize(main_type_t<idx_t>& mo, mapping_cache& mappings, file_info_t<idx_t>& fi, file_info_t<idx_t>& sub_fi);
+// Matches every edge into the module, so its m_are_used marks are complete also in closure mode.
+// Appends the importers whose tables got loaded by this call to loaded_out.
+template<typename idx_t> bool materialize_importers(main_type_t<idx_t>& mo, mapping_cache& mappings, std::uint32_t const module, std::vector<std::uint32_t>* const loaded_out);
+// Matches every edge and validates every export table, after that nothing in mo changes lazily
+// and it can be shared read-only between threads. Reports progress after each module and returns
+// false when control cancels.
+template<typename idx_t> bool materialize_all(main_type_t<idx_t>& mo, mapping_cache& mappings, process_control const* const control);
 
-bool process(std::vector<std::wstring> const& file_paths, main_type* const mo_out);
+template<typename idx_t> file_info_t<idx_t>& get_root(main_type_t<idx_t>& mo);
+template<typename idx_t> file_info_t<idx_t> const& get_root(main_type_t<idx_t> const& mo);
+template<typename idx_t> std::uint32_t get_node_idx(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> module_info_t<idx_t>& get_module(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> module_info_t<idx_t> const& get_module(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> file_info_t<idx_t>* get_orig_instance(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> file_info_t<idx_t> const* get_orig_instance(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> idx_t get_child_count(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> file_info_t<idx_t>* get_children(main_type_t<idx_t>& mo, file_info_t<idx_t> const& fi);
+template<typename idx_t> idx_t get_dll_idx(main_type_t<idx_t> const& mo, file_info_t<idx_t> const& fi);
@@ -6,12 +6,17 @@
 #include "../nogui/assert.h"
 #include "../nogui/dependency_locator.h"
 #include "../nogui/file_name_provider.h"
-#include "../nogui/memory_mapped_file.h"
+#include "../nogui/mapping_cache.h"
 #include "../nogui/pe2.h"
+#include "../nogui/prefetcher.h"
+#include "../nogui/selective_file.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <iterator>
+#include <memory>
+#include <utility>
 
 
 static constexpr wchar_t const s_dummy_textw_r[] = L"";
@@ -22,121 +27,420 @@ static constexpr string const s_dummy_texta_s = {s_dummy_texta_r, static_cast<in
 static constexpr string_handle const s_dummy_texta_h = {&s_dummy_texta_s};
 
 
-bool process_impl(std::vector<std::wstring> const& file_paths, file_info& fi, memory_manager& mm)
+template<typename idx_t>
+bool process_impl(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, std::vector<module_info_t<idx_t>>& modules, std::vector<file_info_t<idx_t>>& nodes, memory_manager& mm, mapping_cache& mappings, stage_stats& stats, bool* const canceled_out)
 {
-	WARN_M_R(file_paths.size() < 0xFFFF, L"Too many files to process.", false);
-	std::uint16_t const n = static_cast<std::uint16_t>(file_paths.size());
-	file_info* const fis = mm.m_alc.allocate_objects<file_info>(n);
-	init(fis, n);
-	string_handle* const dll_names = mm.m_alc.allocate_objects<string_handle>(n);
+	assert(canceled_out);
+	*canceled_out = false;
+	WARN_M_R(file_paths.size() < pe_invalid_idx_v<idx_t>, L"Too many files to process.", false);
+	idx_t const n = static_cast<idx_t>(file_paths.size());
+	modules.clear();
+	modules.resize(s_root_module + 1);
+	init(modules.data(), static_cast<int>(modules.size()));
+	nodes.clear();
+	nodes.resize(s_root_node + 1 + n);
+	init(nodes.data(), static_cast<int>(nodes.size()));
+	nodes[s_root_node].m_module = s_root_module;
+	string_handle* const dll_names = mm.m_alc.allocate_objects<string_handle>(n, allocation_tag::import_tables);
 	std::fill(dll_names, dll_names + n, s_dummy_texta_h);
-	std::uint16_t* const import_counts = mm.m_alc.allocate_objects<std::uint16_t>(n);
-	std::fill(import_counts, import_counts + n, std::uint16_t{0});
-	init(&fi);
-	fi.m_fis = fis;
-	fi.m_file_path = s_dummy_textw_h;
-	fi.m_import_table.m_dll_count = n;
-	fi.m_import_table.m_non_delay_dll_count = n;
-	fi.m_import_table.m_dll_names = dll_names;
-	fi.m_import_table.m_import_counts = import_counts;
+	idx_t* const import_counts = mm.m_alc.allocate_objects<idx_t>(n, allocation_tag::import_tables);
+	std::fill(import_counts, import_counts + n, idx_t{0});
+	module_info_t<idx_t>& root = modules[s_root_module];
+	root.m_file_path = s_dummy_textw_h;
+	root.m_import_table.m_dll_count = n;
+	root.m_import_table.m_non_delay_dll_count = n;
+	root.m_import_table.m_dll_names = dll_names;
+	root.m_import_table.m_import_counts = import_counts;
+	root.m_first_child = s_root_node + 1;
+	root.m_orig_node = s_root_node;
+	root.m_tables_loaded = true;
 	allocator tmpalc;
-	tmp_type to;
+	std::unique_ptr<prefetcher> pf;
+	if(backend == read_backend::selective)
+	{
+		pf = std::make_unique<prefetcher>(prefetcher::default_worker_count());
+	}
+	init(&stats);
+	stats.m_prefetch_threads = pf ? pf->worker_count() : 0;
+	tmp_type<idx_t> to;
+	to.m_policy = policy;
+	to.m_mode = mode;
+	to.m_backend = backend;
+	to.m_modules = &modules;
+	to.m_nodes = &nodes;
 	to.m_mm = &mm;
+	to.m_mappings = &mappings;
+	to.m_prefetcher = pf.get();
+	to.m_stats = &stats;
+	to.m_control = control;
+	to.m_budget = control ? control->m_budget : process_budget{};
+	to.m_begin = std::chrono::steady_clock::now();
+	to.m_depth = 0;
+	to.m_queue.set_hints(control ? control->m_hints : nullptr);
+	to.m_progress = process_progress{};
+	to.m_canceled = false;
 	to.m_tmp_alc = &tmpalc;
-	for(std::uint16_t i = 0; i != n; ++i)
+	for(idx_t i = 0; i != n; ++i)
 	{
-		file_info& sub_fi = fi.m_fis[i];
+		std::uint32_t const sub_node = s_root_node + 1 + i;
+		nodes[sub_node].m_parent_module = s_root_module;
 		int const path_len = static_cast<int>(file_paths[i].size());
 		wchar_t const* const cstr = file_paths[i].c_str();
 		wstring_handle const normalized = file_name_provider::get_correct_file_name(cstr, path_len, to.m_mm->m_wstrs, to.m_mm->m_alc);
 		dependency_locator& dl = to.m_dl;
 		dl.m_main_path = normalized;
 		assert(to.m_queue.empty());
-		to.m_queue.push_back({normalized, &sub_fi});
+		to.m_queue.push({normalized, wstring_handle{}, sub_node, 0});
 		bool const step = step_1(to);
+		if(to.m_canceled)
+		{
+			*canceled_out = true;
+			return false;
+		}
 		WARN_M_R(step, L"Failed to step_1.", false);
 	}
-	pair_root(fi, to);
+	if(pf)
+	{
+		pf->get_read_histogram(&stats.m_prefetch_read);
+		stats.m_prefetch_misses = pf->miss_count();
+	}
+	if(mode == process_mode::full)
+	{
+		pair_root(to);
+		if(to.m_canceled)
+		{
+			*canceled_out = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename idx_t>
+bool materialize_impl(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, file_info_t<idx_t>& sub_fi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings)
+{
+	if(sub_fi.m_matched)
+	{
+		return true;
+	}
+	bool const mi_loaded = load_tables(mi, policy, backend, mm, mappings);
+	WARN_M_R(mi_loaded, L"Failed to load_tables.", false);
+	bool const sub_mi_loaded = load_tables(sub_mi, policy, backend, mm, mappings);
+	WARN_M_R(sub_mi_loaded, L"Failed to load_tables.", false);
+	enptr_type<idx_t> const enpt{sub_mi.m_enpt, sub_mi.m_enpt_count};
+	pair_imports_with_exports(mi, dll_idx, sub_mi, enpt);
+	pair_exports_with_imports(mi, dll_idx, sub_mi, sub_fi, mm.m_alc);
+	sub_fi.m_matched = true;
+	return true;
+}
+
+template<typename idx_t>
+bool load_tables(module_info_t<idx_t>& mi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings)
+{
+	if(mi.m_tables_loaded || mi.m_file_path.m_string == nullptr)
+	{
+		return true;
+	}
+	allocator tmp_alc;
+	pe_image img;
+	pe_import_table_info_t<idx_t> iti;
+	pe_export_table_info_t<idx_t> eti;
+	idx_t const* enpt = nullptr;
+	idx_t enpt_count = 0;
+	pe_tables_t<idx_t> tables;
+	tables.m_policy = policy;
+	tables.m_dll_names_only = false;
+	tables.m_tmp_alc = &tmp_alc;
+	tables.m_iti_out = &iti;
+	tables.m_eti_out = &eti;
+	tables.m_enpt_count_out = &enpt_count;
+	tables.m_enpt_out = &enpt;
+	tables.m_rti_out = nullptr;
+	{
+		selective_file sf;
+		std::shared_ptr<memory_mapped_file> mmf;
+		bool const opened = open_image(mi.m_file_path, backend, mappings, nullptr, sf, mmf, &img);
+		WARN_M_R(opened, L"Failed to open_image.", false);
+		bool const tables_processed = pe_process_all(img, mm, &tables);
+		WARN_M_R(tables_processed, L"Failed to pe_process_all.", false);
+	}
+	WARN_M_R(iti.m_dll_count == mi.m_import_table.m_dll_count, L"File changed since it was processed.", false);
+	iti.m_dll_names = mi.m_import_table.m_dll_names;
+	mi.m_import_table = iti;
+	mi.m_export_table = eti;
+	idx_t* const enpt_copy = mm.m_alc.allocate_objects<idx_t>(enpt_count, allocation_tag::export_tables);
+	std::copy(enpt, enpt + enpt_count, enpt_copy);
+	mi.m_enpt = enpt_copy;
+	mi.m_enpt_count = enpt_count;
+	mi.m_tables_loaded = true;
+	return true;
+}
+
+bool open_image(wstring_handle const& file_path, read_backend const backend, mapping_cache& mappings, prefetcher* const pf, selective_file& sf, std::shared_ptr<memory_mapped_file>& mmf, pe_image* const img_out)
+{
+	assert(img_out);
+	if(pf != nullptr)
+	{
+		assert(backend == read_backend::selective);
+		selective_file prefetched;
+		bool const taken = pf->take(file_path, &prefetched);
+		if(taken)
+		{
+			sf = std::move(prefetched);
+			bool const hdrs_processed = pe_process_fetched_headers(sf, img_out);
+			WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
+			return true;
+		}
+	}
+	if(backend == read_backend::selective)
+	{
+		sf = selective_file(file_path.m_string->m_str);
+		WARN_M_R(sf.begin() != nullptr, L"Failed to selective_file.", false);
+		bool const hdrs_processed = pe_process_headers(sf, false, img_out);
+		WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
+		return true;
+	}
+	mmf = mappings.get(file_path);
+	WARN_M_R(mmf != nullptr, L"Failed to get mapping.", false);
+	bool const hdrs_processed = pe_process_headers(*mmf, false, img_out);
+	WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
 	return true;
 }
 
 
-bool step_1(tmp_type& to)
+template<typename idx_t>
+bool is_canceled(tmp_type<idx_t> const& to)
+{
+	return to.m_canceled || (to.m_control && to.m_control->m_cancel && to.m_control->m_cancel->load());
+}
+
+template<typename idx_t>
+truncation check_budget(tmp_type<idx_t> const& to)
+{
+	process_budget const& budget = to.m_budget;
+	if(budget.m_max_modules != 0 && to.m_progress.m_modules_parsed >= budget.m_max_modules)
+	{
+		return truncation::modules;
+	}
+	if(budget.m_max_depth != 0 && to.m_depth > budget.m_max_depth)
+	{
+		return truncation::depth;
+	}
+	if(budget.m_max_bytes != 0 && to.m_progress.m_bytes_read >= budget.m_max_bytes)
+	{
+		return truncation::bytes;
+	}
+	if(budget.m_max_time_ms != 0 && std::chrono::steady_clock::now() - to.m_begin >= std::chrono::milliseconds{budget.m_max_time_ms})
+	{
+		return truncation::time;
+	}
+	return truncation::none;
+}
+
+template<typename idx_t>
+void emit_event(tmp_type<idx_t>& to, process_event const& event)
+{
+	if(to.m_canceled || !to.m_control || !to.m_control->m_event_fn)
+	{
+		return;
+	}
+	bool const keep_going = to.m_control->m_event_fn(event, to.m_control->m_event_param);
+	if(!keep_going)
+	{
+		to.m_canceled = true;
+	}
+}
+
+
+template<typename idx_t>
+bool step_1(tmp_type<idx_t>& to)
 {
 	while(!to.m_queue.empty())
 	{
-		auto const& e = to.m_queue.front();
-		wstring_handle const file_path = e.first;
-		file_info* const fi = e.second;
-		assert(fi != nullptr);
-		to.m_queue.pop_front();
-		bool const step = step_2(file_path, *fi, to);
+		if(is_canceled(to))
+		{
+			to.m_canceled = true;
+			return false;
+		}
+		traversal_entry const e = to.m_queue.pop();
+		to.m_depth = e.m_depth;
+		bool const step = step_2(e.m_file_path, e.m_node, to);
 		WARN_M_R(step, L"Failed to step_2.", false);
 	}
 	return true;
 }
 
-bool step_2(wstring_handle const& file_path, file_info& fi, tmp_type& to)
+template<typename idx_t>
+bool step_2(wstring_handle const& file_path, std::uint32_t const node, tmp_type<idx_t>& to)
 {
+	std::vector<module_info_t<idx_t>>& modules = *to.m_modules;
+	std::vector<file_info_t<idx_t>>& nodes = *to.m_nodes;
 	auto const it = to.m_map.find(file_path);
 	if(it != to.m_map.end())
 	{
-		assert(it->second->m_orig_instance);
-		fi.m_orig_instance = it->second->m_orig_instance;
+		nodes[node].m_module = it->second->m_module;
 		return true;
 	}
-	fi.m_file_path = file_path;
-	pe_headers hdrs;
-	std::uint16_t const* enpt;
-	std::uint16_t enpt_count;
-	pe_tables tables;
+	WARN_M_R(modules.size() < 0xFFFFFFFF, L"Too many modules to process.", false);
+	std::uint32_t const module = static_cast<std::uint32_t>(modules.size());
+	modules.emplace_back();
+	module_info_t<idx_t>& mi = modules.back();
+	init(&mi);
+	mi.m_file_path = file_path;
+	mi.m_orig_node = node;
+	nodes[node].m_module = module;
+	truncation const budget_exceeded = check_budget(to);
+	if(budget_exceeded != truncation::none)
+	{
+		mi.m_truncation = budget_exceeded;
+		mi.m_tables_loaded = true;
+		++to.m_progress.m_modules_truncated;
+		// Later edges to the same path become duplicates of this module.
+		allocator& tmp_alc = *to.m_tmp_alc;
+		fat_type<idx_t>* const fo = tmp_alc.allocate_objects<fat_type<idx_t>>(1);
+		fo->m_module = module;
+		fo->m_enpt.m_table = nullptr;
+		fo->m_enpt.m_count = 0;
+		to.m_map[file_path] = fo;
+		return true;
+	}
+	pe_image img;
+	std::uint16_t machine;
+	bool parse_too_long;
+	bool const closure_only = to.m_mode == process_mode::closure;
+	idx_t const* enpt = nullptr;
+	idx_t enpt_count = 0;
+	pe_tables_t<idx_t> tables;
+	tables.m_policy = to.m_policy;
+	tables.m_dll_names_only = closure_only;
 	tables.m_tmp_alc = to.m_tmp_alc;
-	tables.m_iti_out = &fi.m_import_table;
-	tables.m_eti_out = &fi.m_export_table;
+	tables.m_iti_out = &mi.m_import_table;
+	tables.m_eti_out = closure_only ? nullptr : &mi.m_export_table;
 	tables.m_enpt_count_out = &enpt_count;
 	tables.m_enpt_out = &enpt;
+	tables.m_rti_out = nullptr;
 	{
-		memory_mapped_file const mmf = memory_mapped_file(file_path.m_string->m_str);
-		WARN_M_R(mmf.begin() != nullptr, L"Failed to memory_mapped_file.", false);
-		bool const hdrs_processed = pe_process_headers(mmf.begin(), mmf.size(), &hdrs);
-		WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
-		fi.m_is_32_bit = pe_is_32_bit(hdrs.m_coff->m_32.m_standard);
-		bool const tables_processed = pe_process_all(mmf.begin(), mmf.size(), *to.m_mm, &tables);
+		selective_file sf;
+		std::shared_ptr<memory_mapped_file> mmf;
+		auto const open_begin = std::chrono::steady_clock::now();
+		bool const opened = open_image(file_path, to.m_backend, *to.m_mappings, to.m_prefetcher, sf, mmf, &img);
+		WARN_M_R(opened, L"Failed to open_image.", false);
+		mi.m_is_32_bit = img.m_is_32;
+		machine = img.m_coff->m_32.m_coff.m_machine;
+		auto const parse_begin = std::chrono::steady_clock::now();
+		bool const tables_processed = pe_process_all(img, *to.m_mm, &tables);
 		WARN_M_R(tables_processed, L"Failed to pe_process_all.", false);
+		auto const parse_end = std::chrono::steady_clock::now();
+		latency_histogram_add(&to.m_stats->m_open, parse_begin - open_begin);
+		latency_histogram_add(&to.m_stats->m_parse, parse_end - parse_begin);
+		parse_too_long = to.m_budget.m_max_file_parse_ms != 0 && parse_end - parse_begin >= std::chrono::milliseconds{to.m_budget.m_max_file_parse_ms};
+		to.m_progress.m_bytes_read += sf.begin() != nullptr ? sf.bytes_read() : img.m_mapped_size;
 	}
+	mi.m_tables_loaded = !closure_only;
 	assert(to.m_map.find(file_path) == to.m_map.end());
-	fat_type* const fo = to.m_tmp_alc->allocate_objects<fat_type>(1);
-	fo->m_orig_instance = &fi;
+	allocator& tmp_alc = *to.m_tmp_alc;
+	fat_type<idx_t>* const fo = tmp_alc.allocate_objects<fat_type<idx_t>>(1);
+	fo->m_module = module;
 	fo->m_enpt.m_table = enpt;
 	fo->m_enpt.m_count = enpt_count;
 	to.m_map[file_path] = fo;
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	file_info* const fis = to.m_mm->m_alc.allocate_objects<file_info>(n);
-	init(fis, n);
-	fi.m_fis = fis;
-	for(std::uint16_t i = 0; i != n; ++i)
+	idx_t const n = mi.m_import_table.m_dll_count;
+	WARN_M_R(nodes.size() + n < 0xFFFFFFFF, L"Too many nodes to process.", false);
+	std::uint32_t const first_child = static_cast<std::uint32_t>(nodes.size());
+	mi.m_first_child = first_child;
+	nodes.resize(first_child + n);
+	init(nodes.data() + first_child, n);
+	for(idx_t i = 0; i != n; ++i)
 	{
-		bool const step = step_3(fi, i, to);
-		WARN_M_R(step, L"Failed to step_3.", false);
+		nodes[first_child + i].m_parent_module = module;
+	}
+	to.m_dl.m_machine = machine;
+	process_event event{};
+	event.m_kind = process_event_kind::module_parsed;
+	event.m_node = node;
+	event.m_module = module;
+	event.m_file_path = file_path;
+	event.m_machine = machine;
+	emit_event(to, event);
+	if(parse_too_long)
+	{
+		// Children are not located, each gets its own path-less module carrying the truncation.
+		for(idx_t i = 0; i != n; ++i)
+		{
+			std::uint32_t const sub_node = first_child + i;
+			nodes[sub_node].m_module = static_cast<std::uint32_t>(modules.size());
+			modules.emplace_back();
+			init(&modules.back());
+			modules.back().m_orig_node = sub_node;
+			modules.back().m_tables_loaded = true;
+			modules.back().m_truncation = truncation::parse_time;
+		}
+		to.m_progress.m_modules_truncated += n;
+	}
+	else
+	{
+		for(idx_t i = 0; i != n; ++i)
+		{
+			bool const step = step_3(module, i, to);
+			WARN_M_R(step, L"Failed to step_3.", false);
+		}
+	}
+	++to.m_progress.m_modules_parsed;
+	to.m_progress.m_queue_depth = to.m_queue.size();
+	if(to.m_control && to.m_control->m_progress_fn)
+	{
+		to.m_control->m_progress_fn(to.m_progress, to.m_control->m_progress_param);
 	}
 	return true;
 }
 
-bool step_3(file_info const& fi, std::uint16_t const i, tmp_type& to)
+template<typename idx_t>
+bool step_3(std::uint32_t const module, idx_t const i, tmp_type<idx_t>& to)
 {
-	file_info& sub_fi = fi.m_fis[i];
+	module_info_t<idx_t> const& mi = (*to.m_modules)[module];
+	std::uint32_t const sub_node = mi.m_first_child + i;
 	dependency_locator& dl = to.m_dl;
-	dl.m_dependency = &fi.m_import_table.m_dll_names[i];
+	dl.m_dependency = &mi.m_import_table.m_dll_names[i];
+	auto const locate_begin = std::chrono::steady_clock::now();
 	bool const located = locate_dependency(dl);
+	latency_histogram_add(&to.m_stats->m_locate, std::chrono::steady_clock::now() - locate_begin);
 	if(located)
 	{
 		std::wstring const& result = dl.m_result;
 		wstring_handle const normalized = file_name_provider::get_correct_file_name(result.c_str(), static_cast<int>(result.size()), to.m_mm->m_wstrs, to.m_mm->m_alc);
-		to.m_queue.push_back({normalized, &sub_fi});
+		to.m_queue.push({normalized, mi.m_file_path, sub_node, to.m_depth + 1});
+		bool const within_depth = to.m_budget.m_max_depth == 0 || to.m_depth + 1 <= to.m_budget.m_max_depth;
+		if(to.m_prefetcher && within_depth && to.m_map.find(normalized) == to.m_map.end())
+		{
+			to.m_prefetcher->prefetch(normalized);
+		}
+		process_event event{};
+		event.m_kind = process_event_kind::edge_resolved;
+		event.m_parent = module;
+		event.m_index = i;
+		event.m_node = sub_node;
+		event.m_file_path = normalized;
+		event.m_dll_name = mi.m_import_table.m_dll_names[i];
+		emit_event(to, event);
 		return true;
 	}
 	else
 	{
+		process_event event{};
+		event.m_kind = process_event_kind::edge_unresolved;
+		event.m_parent = module;
+		event.m_index = i;
+		event.m_node = sub_node;
+		event.m_dll_name = mi.m_import_table.m_dll_names[i];
+		emit_event(to, event);
 		return true;
 	}
 }
+
+
+template bool process_impl<std::uint16_t>(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, std::vector<module_info_t<std::uint16_t>>& modules, std::vector<file_info_t<std::uint16_t>>& nodes, memory_manager& mm, mapping_cache& mappings, stage_stats& stats, bool* const canceled_out);
+template bool process_impl<std::uint32_t>(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, std::vector<module_info_t<std::uint32_t>>& modules, std::vector<file_info_t<std::uint32_t>>& nodes, memory_manager& mm, mapping_cache& mappings, stage_stats& stats, bool* const canceled_out);
+template bool materialize_impl<std::uint16_t>(module_info_t<std::uint16_t>& mi, std::uint16_t const dll_idx, module_info_t<std::uint16_t>& sub_mi, file_info_t<std::uint16_t>& sub_fi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings);
+template bool materialize_impl<std::uint32_t>(module_info_t<std::uint32_t>& mi, std::uint32_t const dll_idx, module_info_t<std::uint32_t>& sub_mi, file_info_t<std::uint32_t>& sub_fi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings);
+template void emit_event<std::uint16_t>(tmp_type<std::uint16_t>& to, process_event const& event);
+template void emit_event<std::uint32_t>(tmp_type<std::uint32_t>& to, process_event const& event);
@@ -2,43 +2,75 @@
 
 
 #include "processor.h"
+#include "traversal_queue.h"
 
 #include "../nogui/allocator.h"
 #include "../nogui/dependency_locator.h"
+#include "../nogui/mapping_cache.h"
 #include "../nogui/memory_manager.h"
 #include "../nogui/my_string_handle.h"
 
+#include <chrono>
 #include <cstdint>
-#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 
+struct pe_image;
+class prefetcher;
+class selective_file;
+
+
+template<typename idx_t>
 struct enptr_type
 {
-	std::uint16_t const* m_table;
-	std::uint16_t m_count;
+	idx_t const* m_table;
+	idx_t m_count;
 };
 
+template<typename idx_t>
 struct fat_type
 {
-	file_info* m_orig_instance;
-	enptr_type m_enpt;
+	std::uint32_t m_module;
+	enptr_type<idx_t> m_enpt;
 };
 
+template<typename idx_t>
 struct tmp_type
 {
+	pe_parse_policy m_policy;
+	process_mode m_mode;
+	read_backend m_backend;
+	std::vector<module_info_t<idx_t>>* m_modules;
+	std::vector<file_info_t<idx_t>>* m_nodes;
 	memory_manager* m_mm;
+	mapping_cache* m_mappings;
+	prefetcher* m_prefetcher;
+	stage_stats* m_stats;
+	process_control const* m_control;
+	process_budget m_budget;
+	std::chrono::steady_clock::time_point m_begin;
+	int m_depth;
+	process_progress m_progress;
+	bool m_canceled;
 	allocator* m_tmp_alc;
-	std::deque<std::pair<wstring_handle, file_info*>> m_queue;
-	std::unordered_map<wstring_handle, fat_type*> m_map;
+	traversal_queue m_queue;
+	std::unordered_map<wstring_handle, fat_type<idx_t>*> m_map;
 	dependency_locator m_dl;
 };
 
 
-bool process_impl(std::vector<std::wstring> const& file_paths, file_info& fi, memory_manager& mm);
+template<typename idx_t> bool process_impl(std::vector<std::wstring> const& file_paths, pe_parse_policy const policy, process_mode const mode, read_backend const backend, process_control const* const control, std::vector<module_info_t<idx_t>>& modules, std::vector<file_info_t<idx_t>>& nodes, memory_manager& mm, mapping_cache& mappings, stage_stats& stats, bool* const canceled_out);
+template<typename idx_t> bool materialize_impl(module_info_t<idx_t>& mi, idx_t const dll_idx, module_info_t<idx_t>& sub_mi, file_info_t<idx_t>& sub_fi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings);
+template<typename idx_t> bool load_tables(module_info_t<idx_t>& mi, pe_parse_policy const policy, read_backend const backend, memory_manager& mm, mapping_cache& mappings);
+bool open_image(wstring_handle const& file_path, read_backend const backend, mapping_cache& mappings, prefetcher* const pf, selective_file& sf, std::shared_ptr<memory_mapped_file>& mmf, pe_image* const img_out);
+
+template<typename idx_t> bool is_canceled(tmp_type<idx_t> const& to);
+template<typename idx_t> truncation check_budget(tmp_type<idx_t> const& to);
+template<typename idx_t> void emit_event(tmp_type<idx_t>& to, process_event const& event);
 
-bool step_1(tmp_type& to);
-bool step_2(wstring_handle const& file_path, file_info& fi, tmp_type& to);
-bool step_3(file_info const& fi, std::uint16_t const i, tmp_type& to);
+template<typename idx_t> bool step_1(tmp_type<idx_t>& to);
+template<typename idx_t> bool step_2(wstring_handle const& file_path, std::uint32_t const node, tmp_type<idx_t>& to);
+template<typename idx_t> bool step_3(std::uint32_t const module, idx_t const i, tmp_type<idx_t>& to);
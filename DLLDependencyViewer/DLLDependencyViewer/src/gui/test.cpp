@@ -1,23 +1,97 @@
 #include "test.h"
 
+#include "background_processor.h"
+#include "import_export_matcher.h"
+#include "processor.h"
+#include "processor_impl.h"
+#include "traversal_queue.h"
+
+#include "../nogui/allocator_stats.h"
+#include "../nogui/array_bool.h"
 #include "../nogui/memory_manager.h"
 #include "../nogui/memory_mapped_file.h"
 #include "../nogui/pe.h"
 #include "../nogui/pe2.h"
+#include "../nogui/pe_triage.h"
 #include "../nogui/smart_handle.h"
 #include "../nogui/smart_local_free.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <cwchar>
 #include <filesystem>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "../nogui/my_windows.h"
 #include <shellapi.h>
 
 
 #define s_very_big_int (2'147'483'647)
+static constexpr int const s_stats_progress_interval = 256;
+static constexpr int const s_test_background_files = 16;
+static constexpr std::uint32_t const s_fixture_headers_size = 0x400;
+static constexpr std::uint32_t const s_fixture_section_rva = 0x1000;
+static constexpr std::uint32_t const s_fixture_eat_count = 80'000;
+static constexpr std::uint32_t const s_fixture_name_count = 60'000;
+static constexpr std::uint32_t const s_fixture_zero_entries[] = {60'000, 65'535, 70'000};
+
+
+struct background_test_state
+{
+	background_processor* m_bp;
+	bool m_cancel;
+	bool m_cancel_materialize;
+	bool m_done;
+	bool m_processed;
+};
+
+template<typename idx_t>
+struct test_tables
+{
+	pe_import_table_info_t<idx_t> m_iti;
+	pe_export_table_info_t<idx_t> m_eti;
+	idx_t m_enpt_count;
+	idx_t const* m_enpt;
+	pe_resources_table_info m_rti;
+};
+
+struct test_fixture_import
+{
+	char const* m_name;
+	std::uint16_t m_ordinal_or_hint;
+};
+
+struct event_test_state
+{
+	bool m_stop;
+	int m_modules_parsed;
+	std::uint32_t m_edges_resolved;
+	std::uint32_t m_edges_unresolved;
+	std::uint32_t m_edges_matched;
+	std::uint64_t m_missing_imports;
+};
+
+
+static void test_background_processor(std::vector<std::wstring> const& file_paths);
+static void test_process_events(std::vector<std::wstring> const& file_paths);
+static void test_truncated_modules(std::vector<std::wstring> const& file_paths);
+static void test_traversal_queue();
+static void test_generated_export_table();
+template<typename idx_t> static bool test_process_tables(pe_image const& img, memory_manager& mm, allocator& tmp_alc, test_tables<idx_t>* const tables_out);
+static std::uint32_t test_fixture_raw(std::uint32_t const rva);
+static std::uint32_t test_fixture_alloc(std::vector<std::byte>& image, std::uint32_t const size);
+template<typename t> static void test_fixture_put(std::vector<std::byte>& image, std::uint32_t const raw, t const value);
+static std::uint32_t test_fixture_string(std::vector<std::byte>& image, char const* const str);
+static void test_fixture_headers(std::vector<std::byte>& image, bool const is_dll, std::uint32_t const export_rva, std::uint32_t const export_size, std::uint32_t const import_rva, std::uint32_t const import_size);
+static std::vector<std::byte> test_fixture_exporter();
+static std::vector<std::byte> test_fixture_importer(test_fixture_import const* const imports, int const count);
 
 
 void test()
@@ -26,7 +100,7 @@ void test()
 	int argc;
 	wchar_t** const argv = CommandLineToArgvW(cmd_line, &argc);
 	smart_local_free const sp_argv(reinterpret_cast<void*>(argv));
-	if(argc != 3)
+	if(argc != 3 && argc != 4)
 	{
 		return;
 	}
@@ -34,6 +108,17 @@ void test()
 	{
 		return;
 	}
+	pe_triage_filter filter{};
+	if(argc == 4)
+	{
+		bool const filter_parsed = pe_triage_parse_filter(argv[3], &filter);
+		if(!filter_parsed)
+		{
+			OutputDebugStringW(L"Unknown triage filter.\n");
+			return;
+		}
+	}
+	std::vector<std::wstring> file_paths;
 	std::filesystem::recursive_directory_iterator dir_it(argv[2], std::filesystem::directory_options::skip_permission_denied);
 	for(auto const& e : dir_it)
 	{
@@ -42,75 +127,592 @@ void test()
 		{
 			continue;
 		}
-		memory_mapped_file const mmf(p.c_str());
-		if(mmf.begin() == nullptr)
+		pe_triage_info info;
+		bool const triaged = pe_triage_file(p.c_str(), &info);
+		if(!triaged)
 		{
 			continue;
 		}
-		if(mmf.size() < 2)
+		if(!pe_triage_matches(info, filter))
 		{
 			continue;
 		}
-		if(reinterpret_cast<char const*>(mmf.begin())[0] != 'M')
+		memory_mapped_file mmf(p.c_str());
+		if(mmf.begin() == nullptr)
 		{
 			continue;
 		}
-		if(reinterpret_cast<char const*>(mmf.begin())[1] != 'Z')
+		pe_image img;
+		bool const hdrs_processed = pe_process_headers(mmf, true, &img);
+		if(!hdrs_processed)
 		{
+			OutputDebugStringW(p.c_str());
+			OutputDebugStringW(L"\n");
 			continue;
 		}
-		if(mmf.size() < 128)
+		memory_manager mm;
+		allocator tmp_alc;
+		test_tables<std::uint16_t> tables;
+		test_tables<std::uint32_t> tables_32;
+		bool const tables_processed = test_process_tables(img, mm, tmp_alc, &tables) || test_process_tables(img, mm, tmp_alc, &tables_32);
+		if(!tables_processed)
 		{
+			OutputDebugStringW(p.c_str());
+			OutputDebugStringW(L"\n");
 			continue;
 		}
-		std::uint16_t const& new_header_offset = *reinterpret_cast<std::uint16_t const*>(mmf.begin() + 60);
-		if(mmf.size() < new_header_offset + 4)
+		if(file_paths.size() != s_test_background_files)
 		{
-			continue;
+			file_paths.push_back(p.wstring());
 		}
-		std::uint32_t const& new_header_header = *reinterpret_cast<std::uint32_t const*>(mmf.begin() + new_header_offset);
-		if(new_header_header != 0x00004550)
+	}
+	test_background_processor(file_paths);
+	test_process_events(file_paths);
+	test_truncated_modules(file_paths);
+	test_traversal_queue();
+	test_generated_export_table();
+}
+
+static void test_background_processor(std::vector<std::wstring> const& file_paths)
+{
+	if(file_paths.size() < 2)
+	{
+		return;
+	}
+	auto const progress_fn = [](process_progress const& progress, void* const param)
+	{
+		background_test_state& state = *static_cast<background_test_state*>(param);
+		if(state.m_cancel || (state.m_cancel_materialize && progress.m_modules_materialized != 0))
 		{
-			continue;
+			state.m_bp->cancel();
 		}
-		memory_manager mm;
-		pe_header_info hi;
-		pe_resources_table_info rs;
-		std::uint16_t enpt_count;
-		std::uint16_t const* enpt;
-		allocator enpt_alloc;
-		try
+	};
+	auto const done_fn = [](bool const processed, void* const param)
+	{
+		background_test_state& state = *static_cast<background_test_state*>(param);
+		state.m_done = true;
+		state.m_processed = processed;
+	};
+	background_processor bp;
+	background_test_state state{&bp, false, false, false, false};
+	bp.start(file_paths, pe_parse_policy::strict, process_mode::closure, read_backend::mapped, process_budget{}, progress_fn, done_fn, &state);
+	bp.wait();
+	std::shared_ptr<main_type_32 const> const first = bp.get_published();
+	if(!state.m_done || !state.m_processed || !first)
+	{
+		OutputDebugStringW(L"Background processor did not publish.\n");
+		return;
+	}
+	for(file_info_32 const& fi : first->m_nodes)
+	{
+		if(&fi != &get_root(*first) && fi.m_module != s_missing_module && !fi.m_matched)
 		{
-			hi = pe_process_header(mmf.begin(), mmf.size());
+			OutputDebugStringW(L"Background processor published an unmatched edge.\n");
+			return;
 		}
-		catch(wchar_t const* const&)
+	}
+	state = background_test_state{&bp, true, false, false, false};
+	bp.start(file_paths, pe_parse_policy::strict, process_mode::closure, read_backend::mapped, process_budget{}, progress_fn, done_fn, &state);
+	bp.wait();
+	if(!state.m_done || state.m_processed || bp.get_published() != first)
+	{
+		OutputDebugStringW(L"Background processor replaced the snapshot on cancel.\n");
+		return;
+	}
+	state = background_test_state{&bp, false, true, false, false};
+	bp.start(file_paths, pe_parse_policy::strict, process_mode::closure, read_backend::mapped, process_budget{}, progress_fn, done_fn, &state);
+	bp.wait();
+	if(!state.m_done || state.m_processed || bp.get_published() != first)
+	{
+		OutputDebugStringW(L"Background processor replaced the snapshot on cancel while materializing.\n");
+		return;
+	}
+	state = background_test_state{&bp, false, false, false, false};
+	bp.start(file_paths, pe_parse_policy::strict, process_mode::closure, read_backend::mapped, process_budget{}, progress_fn, done_fn, &state);
+	bp.wait();
+	std::shared_ptr<main_type_32 const> const second = bp.get_published();
+	if(!state.m_processed || !second || second == first || second->m_modules.size() != first->m_modules.size() || second->m_nodes.size() != first->m_nodes.size())
+	{
+		OutputDebugStringW(L"Background processor did not publish after restart.\n");
+		return;
+	}
+}
+
+static void test_process_events(std::vector<std::wstring> const& file_paths)
+{
+	if(file_paths.empty())
+	{
+		return;
+	}
+	auto const event_fn = [](process_event const& event, void* const param) -> bool
+	{
+		event_test_state& state = *static_cast<event_test_state*>(param);
+		switch(event.m_kind)
 		{
-			OutputDebugStringW(p.c_str());
-			OutputDebugStringW(L"\n");
-			continue;
+			case process_event_kind::module_parsed:
+			{
+				++state.m_modules_parsed;
+			}
+			break;
+			case process_event_kind::edge_resolved:
+			{
+				++state.m_edges_resolved;
+			}
+			break;
+			case process_event_kind::edge_unresolved:
+			{
+				++state.m_edges_unresolved;
+			}
+			break;
+			case process_event_kind::edge_matched:
+			{
+				++state.m_edges_matched;
+				state.m_missing_imports += event.m_missing_imports;
+			}
+			break;
 		}
-		pe_import_table_info iti;
-		pe_export_table_info eti;
-		pe_tables tables;
-		tables.m_tmp_alc = &enpt_alloc;
-		tables.m_iti_out = &iti;
-		tables.m_eti_out = &eti;
-		tables.m_enpt_count_out = &enpt_count;
-		tables.m_enpt_out = &enpt;
-		bool const tables_processed = pe_process_all(mmf.begin(), mmf.size(), mm, &tables);
-		if(!tables_processed)
+		return !state.m_stop;
+	};
+	process_control control{};
+	control.m_event_fn = event_fn;
+	event_test_state stop_state{};
+	stop_state.m_stop = true;
+	control.m_event_param = &stop_state;
+	auto const stopped_mo = std::make_unique<main_type_32>();
+	mapping_cache stopped_mappings;
+	bool const stopped_processed = process(file_paths, pe_parse_policy::strict, process_mode::full, read_backend::mapped, &control, stopped_mappings, stopped_mo.get());
+	if(stopped_processed || stop_state.m_modules_parsed != 1)
+	{
+		OutputDebugStringW(L"Event consumer did not stop processing.\n");
+		return;
+	}
+	event_test_state state{};
+	control.m_event_param = &state;
+	auto const mo = std::make_unique<main_type_32>();
+	mapping_cache mappings;
+	bool const processed = process(file_paths, pe_parse_policy::strict, process_mode::full, read_backend::mapped, &control, mappings, mo.get());
+	if(!processed)
+	{
+		OutputDebugStringW(L"Failed to process.\n");
+		return;
+	}
+	std::uint32_t edges = 0;
+	std::uint64_t missing_imports = 0;
+	for(std::uint32_t i = s_root_module + 1; i != static_cast<std::uint32_t>(mo->m_modules.size()); ++i)
+	{
+		pe_import_table_info_32 const& iti = mo->m_modules[i].m_import_table;
+		for(std::uint32_t j = 0; j != iti.m_dll_count; ++j)
 		{
-			OutputDebugStringW(p.c_str());
-			OutputDebugStringW(L"\n");
+			missing_imports += std::count(iti.m_matched_exports[j], iti.m_matched_exports[j] + iti.m_import_counts[j], pe_invalid_idx_v<std::uint32_t>);
+		}
+		edges += iti.m_dll_count;
+	}
+	// Unresolved edges are matched against the missing module, so every edge gets an edge_matched event.
+	if(state.m_modules_parsed == 0 || state.m_edges_resolved + state.m_edges_unresolved != edges || state.m_edges_matched != edges || state.m_missing_imports != missing_imports)
+	{
+		OutputDebugStringW(L"Event counts do not match the processed graph.\n");
+	}
+}
+
+static void test_truncated_modules(std::vector<std::wstring> const& file_paths)
+{
+	if(file_paths.empty())
+	{
+		return;
+	}
+	process_control control{};
+	control.m_budget.m_max_modules = 1;
+	auto const mo = std::make_unique<main_type_32>();
+	mapping_cache mappings;
+	bool const processed = process(file_paths, pe_parse_policy::strict, process_mode::full, read_backend::mapped, &control, mappings, mo.get());
+	if(!processed)
+	{
+		OutputDebugStringW(L"Failed to process with a module budget.\n");
+		return;
+	}
+	std::vector<wstring_handle> paths;
+	for(module_info_32 const& mi : mo->m_modules)
+	{
+		if(mi.m_file_path.m_string)
+		{
+			paths.push_back(mi.m_file_path);
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+	if(std::adjacent_find(paths.begin(), paths.end()) != paths.end())
+	{
+		OutputDebugStringW(L"Module budget truncated the same file into several modules.\n");
+	}
+}
+
+static void test_traversal_queue()
+{
+	static wchar_t const* const s_names[] = {L"a.dll", L"b.dll", L"c.dll", L"d.dll", L"e.dll"};
+	static constexpr int const s_count = static_cast<int>(std::size(s_names));
+	wstring strings[s_count];
+	for(int i = 0; i != s_count; ++i)
+	{
+		strings[i] = wstring{s_names[i], static_cast<int>(std::wcslen(s_names[i])), 0};
+	}
+	traversal_hints hints;
+	traversal_queue queue;
+	queue.set_hints(&hints);
+	for(int i = 0; i != s_count; ++i)
+	{
+		queue.push(traversal_entry{wstring_handle{&strings[i]}, wstring_handle{}, static_cast<std::uint32_t>(i), 0});
+	}
+	std::vector<std::uint32_t> popped;
+	hints.set_focus({L"B.DLL", L"d.dll"});
+	popped.push_back(queue.pop().m_node);
+	hints.set_focus({L"e.dll"});
+	while(!queue.empty())
+	{
+		popped.push_back(queue.pop().m_node);
+	}
+	static constexpr std::uint32_t const s_expected[] = {1, 4, 0, 2, 3};
+	if(!std::equal(popped.begin(), popped.end(), std::begin(s_expected), std::end(s_expected)))
+	{
+		OutputDebugStringW(L"Traversal queue popped in wrong order.\n");
+	}
+}
+
+static void test_generated_export_table()
+{
+	static constexpr test_fixture_import const s_imports[] =
+	{
+		{"e00000", 0},
+		{"e31337", 31'337},
+		{"e59999", 0},
+		{"nosuch", 0},
+		{nullptr, 2},
+		{nullptr, 60'001},
+		{nullptr, 60'002},
+	};
+	static constexpr std::uint32_t const s_expected_ordinals[] = {1, 31'338, 60'000, pe_invalid_idx_v<std::uint32_t>, 2, pe_invalid_idx_v<std::uint32_t>, 60'002};
+	static constexpr int const s_import_count = static_cast<int>(std::size(s_imports));
+	static_assert(std::size(s_expected_ordinals) == std::size(s_imports));
+
+	std::vector<std::byte> const exporter = test_fixture_exporter();
+	std::vector<std::byte> const importer = test_fixture_importer(s_imports, s_import_count);
+	pe_image exporter_img;
+	pe_image importer_img;
+	bool const exporter_parsed = pe_process_headers(exporter.data(), exporter.size(), exporter.size(), &exporter_img);
+	bool const importer_parsed = pe_process_headers(importer.data(), importer.size(), importer.size(), &importer_img);
+	if(!exporter_parsed || !importer_parsed)
+	{
+		OutputDebugStringW(L"Generated images failed to parse.\n");
+		return;
+	}
+	memory_manager mm;
+	allocator tmp_alc;
+	test_tables<std::uint16_t> exporter_tables_16;
+	bool const exporter_16_processed = test_process_tables(exporter_img, mm, tmp_alc, &exporter_tables_16);
+	if(exporter_16_processed)
+	{
+		OutputDebugStringW(L"Generated export table fit the 16-bit layout.\n");
+		return;
+	}
+	test_tables<std::uint32_t> exporter_tables;
+	test_tables<std::uint32_t> importer_tables;
+	bool const exporter_processed = test_process_tables(exporter_img, mm, tmp_alc, &exporter_tables);
+	bool const importer_processed = test_process_tables(importer_img, mm, tmp_alc, &importer_tables);
+	if(!exporter_processed || !importer_processed)
+	{
+		OutputDebugStringW(L"Generated images failed to process.\n");
+		return;
+	}
+
+	// The export address table has 80,000 entries, three of them are zero and are not exports.
+	pe_export_table_info_32 const& eti = exporter_tables.m_eti;
+	std::uint32_t const export_count = s_fixture_eat_count - static_cast<std::uint32_t>(std::size(s_fixture_zero_entries));
+	bool const ordinals_sorted = std::adjacent_find(eti.m_ordinals, eti.m_ordinals + eti.m_count, std::greater_equal<std::uint32_t>{}) == eti.m_ordinals + eti.m_count;
+	if(eti.m_count != export_count || exporter_tables.m_enpt_count != s_fixture_name_count || !ordinals_sorted || eti.m_ordinals[0] != 1 || eti.m_ordinals[eti.m_count - 1] != s_fixture_eat_count)
+	{
+		OutputDebugStringW(L"Generated export table has wrong exports.\n");
+		return;
+	}
+	for(std::uint32_t const zero_entry : s_fixture_zero_entries)
+	{
+		if(std::binary_search(eti.m_ordinals, eti.m_ordinals + eti.m_count, zero_entry + 1))
+		{
+			OutputDebugStringW(L"Generated export table kept a zero entry.\n");
+			return;
 		}
-		try
+	}
+
+	wstring const dll_path{L"big.dll", 7, 0};
+	module_info_32 mi;
+	init(&mi);
+	mi.m_import_table = importer_tables.m_iti;
+	module_info_32 sub_mi;
+	init(&sub_mi);
+	sub_mi.m_file_path = wstring_handle{&dll_path};
+	sub_mi.m_export_table = eti;
+	file_info_32 sub_fi;
+	init(&sub_fi);
+	if(mi.m_import_table.m_dll_count != 1 || mi.m_import_table.m_import_counts[0] != s_import_count)
+	{
+		OutputDebugStringW(L"Generated import table has wrong imports.\n");
+		return;
+	}
+	pair_imports_with_exports(mi, std::uint32_t{0}, sub_mi, enptr_type<std::uint32_t>{exporter_tables.m_enpt, exporter_tables.m_enpt_count});
+	pair_exports_with_imports(mi, std::uint32_t{0}, sub_mi, sub_fi, mm.m_alc);
+	int matched_count = 0;
+	for(int i = 0; i != s_import_count; ++i)
+	{
+		std::uint32_t const matched = mi.m_import_table.m_matched_exports[0][i];
+		bool const is_matched = matched != pe_invalid_idx_v<std::uint32_t>;
+		std::uint32_t const ordinal = is_matched ? eti.m_ordinals[matched] : pe_invalid_idx_v<std::uint32_t>;
+		if(ordinal != s_expected_ordinals[i] || (is_matched && sub_fi.m_matched_imports[matched] != static_cast<std::uint32_t>(i)))
 		{
-			rs = pe_process_resource_table(mmf.begin(), mmf.size(), hi, mm);
+			OutputDebugStringW(L"Generated import matched the wrong export.\n");
+			return;
 		}
-		catch(wchar_t const* const&)
+		matched_count += is_matched ? 1 : 0;
+	}
+	if(array_bool_count(eti.m_are_used, eti.m_count) != matched_count)
+	{
+		OutputDebugStringW(L"Generated export table has wrong used exports.\n");
+	}
+}
+
+template<typename idx_t>
+static bool test_process_tables(pe_image const& img, memory_manager& mm, allocator& tmp_alc, test_tables<idx_t>* const tables_out)
+{
+	assert(tables_out);
+	pe_tables_t<idx_t> tables;
+	tables.m_policy = pe_parse_policy::strict;
+	tables.m_dll_names_only = false;
+	tables.m_tmp_alc = &tmp_alc;
+	tables.m_iti_out = &tables_out->m_iti;
+	tables.m_eti_out = &tables_out->m_eti;
+	tables.m_enpt_count_out = &tables_out->m_enpt_count;
+	tables.m_enpt_out = &tables_out->m_enpt;
+	tables.m_rti_out = &tables_out->m_rti;
+	return pe_process_all(img, mm, &tables);
+}
+
+static std::uint32_t test_fixture_raw(std::uint32_t const rva)
+{
+	return rva - s_fixture_section_rva + s_fixture_headers_size;
+}
+
+static std::uint32_t test_fixture_alloc(std::vector<std::byte>& image, std::uint32_t const size)
+{
+	std::uint32_t const raw = (static_cast<std::uint32_t>(image.size()) + 7) & ~std::uint32_t{7};
+	image.resize(raw + size);
+	return raw - s_fixture_headers_size + s_fixture_section_rva;
+}
+
+template<typename t>
+static void test_fixture_put(std::vector<std::byte>& image, std::uint32_t const raw, t const value)
+{
+	assert(raw + sizeof(value) <= image.size());
+	std::memcpy(image.data() + raw, &value, sizeof(value));
+}
+
+static std::uint32_t test_fixture_string(std::vector<std::byte>& image, char const* const str)
+{
+	std::uint32_t const size = static_cast<std::uint32_t>(std::strlen(str) + 1);
+	std::uint32_t const rva = test_fixture_alloc(image, size);
+	std::memcpy(image.data() + test_fixture_raw(rva), str, size);
+	return rva;
+}
+
+static void test_fixture_headers(std::vector<std::byte>& image, bool const is_dll, std::uint32_t const export_rva, std::uint32_t const export_size, std::uint32_t const import_rva, std::uint32_t const import_size)
+{
+	image.resize((image.size() + 0x1ff) & ~std::size_t{0x1ff});
+	std::uint32_t const section_size = static_cast<std::uint32_t>(image.size()) - s_fixture_headers_size;
+	std::uint32_t const coff = 0x80;
+	std::uint32_t const opt = coff + 24;
+	std::uint32_t const dirs = opt + 112;
+	std::uint32_t const sct = opt + 240;
+	test_fixture_put(image, 0x00, std::uint16_t{0x5a4d});
+	test_fixture_put(image, 0x3c, coff);
+	test_fixture_put(image, coff + 0, std::uint32_t{0x00004550});
+	test_fixture_put(image, coff + 4, std::uint16_t{0x8664});
+	test_fixture_put(image, coff + 6, std::uint16_t{1});
+	test_fixture_put(image, coff + 20, std::uint16_t{240});
+	test_fixture_put(image, coff + 22, static_cast<std::uint16_t>(is_dll ? 0x2022 : 0x0022));
+	test_fixture_put(image, opt + 0, std::uint16_t{0x020b});
+	test_fixture_put(image, opt + 4, section_size);
+	test_fixture_put(image, opt + 20, s_fixture_section_rva);
+	test_fixture_put(image, opt + 24, std::uint64_t{0x180000000});
+	test_fixture_put(image, opt + 32, std::uint32_t{0x1000});
+	test_fixture_put(image, opt + 36, std::uint32_t{0x200});
+	test_fixture_put(image, opt + 40, std::uint16_t{6});
+	test_fixture_put(image, opt + 48, std::uint16_t{6});
+	test_fixture_put(image, opt + 56, s_fixture_section_rva + ((section_size + 0xfff) & ~std::uint32_t{0xfff}));
+	test_fixture_put(image, opt + 60, s_fixture_headers_size);
+	test_fixture_put(image, opt + 68, std::uint16_t{3});
+	test_fixture_put(image, opt + 70, std::uint16_t{0x0160});
+	test_fixture_put(image, opt + 72, std::uint64_t{0x100000});
+	test_fixture_put(image, opt + 80, std::uint64_t{0x1000});
+	test_fixture_put(image, opt + 88, std::uint64_t{0x100000});
+	test_fixture_put(image, opt + 96, std::uint64_t{0x1000});
+	test_fixture_put(image, opt + 108, std::uint32_t{16});
+	test_fixture_put(image, dirs + 0, export_rva);
+	test_fixture_put(image, dirs + 4, export_size);
+	test_fixture_put(image, dirs + 8, import_rva);
+	test_fixture_put(image, dirs + 12, import_size);
+	std::memcpy(image.data() + sct, ".text", 5);
+	test_fixture_put(image, sct + 8, section_size);
+	test_fixture_put(image, sct + 12, s_fixture_section_rva);
+	test_fixture_put(image, sct + 16, section_size);
+	test_fixture_put(image, sct + 20, s_fixture_headers_size);
+	test_fixture_put(image, sct + 36, std::uint32_t{0x60000020});
+}
+
+// Names are only reachable through the 16-bit export ordinal table, so they cover the first
+// 60,000 addresses. The zero entries and the ordinals above 65,535 are all unnamed.
+static std::vector<std::byte> test_fixture_exporter()
+{
+	std::vector<std::byte> image(s_fixture_headers_size);
+	std::uint32_t const edt = test_fixture_alloc(image, 40);
+	std::uint32_t const eat = test_fixture_alloc(image, 4 * s_fixture_eat_count);
+	std::uint32_t const enpt = test_fixture_alloc(image, 4 * s_fixture_name_count);
+	std::uint32_t const eot = test_fixture_alloc(image, 2 * s_fixture_name_count);
+	std::uint32_t const dll_name = test_fixture_string(image, "big.dll");
+	for(std::uint32_t i = 0; i != s_fixture_name_count; ++i)
+	{
+		char name[16];
+		int const printed = std::snprintf(name, std::size(name), "e%05u", static_cast<unsigned>(i));
+		assert(printed > 0);
+		std::uint32_t const name_rva = test_fixture_string(image, name);
+		test_fixture_put(image, test_fixture_raw(enpt) + 4 * i, name_rva);
+		test_fixture_put(image, test_fixture_raw(eot) + 2 * i, static_cast<std::uint16_t>(i));
+	}
+	std::uint32_t const edt_size = static_cast<std::uint32_t>(image.size()) - test_fixture_raw(edt);
+	std::uint32_t const code = test_fixture_alloc(image, 16);
+	for(std::uint32_t i = 0; i != s_fixture_eat_count; ++i)
+	{
+		bool const is_zero = std::find(std::begin(s_fixture_zero_entries), std::end(s_fixture_zero_entries), i) != std::end(s_fixture_zero_entries);
+		test_fixture_put(image, test_fixture_raw(eat) + 4 * i, is_zero ? std::uint32_t{0} : code);
+	}
+	test_fixture_put(image, test_fixture_raw(edt) + 12, dll_name);
+	test_fixture_put(image, test_fixture_raw(edt) + 16, std::uint32_t{1});
+	test_fixture_put(image, test_fixture_raw(edt) + 20, s_fixture_eat_count);
+	test_fixture_put(image, test_fixture_raw(edt) + 24, s_fixture_name_count);
+	test_fixture_put(image, test_fixture_raw(edt) + 28, eat);
+	test_fixture_put(image, test_fixture_raw(edt) + 32, enpt);
+	test_fixture_put(image, test_fixture_raw(edt) + 36, eot);
+	test_fixture_headers(image, true, edt, edt_size, 0, 0);
+	return image;
+}
+
+static std::vector<std::byte> test_fixture_importer(test_fixture_import const* const imports, int const count)
+{
+	std::vector<std::byte> image(s_fixture_headers_size);
+	std::uint32_t const idt = test_fixture_alloc(image, 2 * 20);
+	std::uint32_t const ilt = test_fixture_alloc(image, 8 * (count + 1));
+	std::uint32_t const iat = test_fixture_alloc(image, 8 * (count + 1));
+	std::uint32_t const dll_name = test_fixture_string(image, "big.dll");
+	for(int i = 0; i != count; ++i)
+	{
+		std::uint64_t entry;
+		if(imports[i].m_name)
 		{
-			OutputDebugStringW(p.c_str());
-			OutputDebugStringW(L"\n");
+			std::uint32_t const len = static_cast<std::uint32_t>(std::strlen(imports[i].m_name) + 1);
+			std::uint32_t const hint_name = test_fixture_alloc(image, 2 + len);
+			test_fixture_put(image, test_fixture_raw(hint_name), imports[i].m_ordinal_or_hint);
+			std::memcpy(image.data() + test_fixture_raw(hint_name) + 2, imports[i].m_name, len);
+			entry = hint_name;
+		}
+		else
+		{
+			entry = (std::uint64_t{1} << 63) | imports[i].m_ordinal_or_hint;
 		}
+		test_fixture_put(image, test_fixture_raw(ilt) + 8 * i, entry);
+		test_fixture_put(image, test_fixture_raw(iat) + 8 * i, entry);
+	}
+	test_fixture_put(image, test_fixture_raw(idt) + 0, ilt);
+	test_fixture_put(image, test_fixture_raw(idt) + 12, dll_name);
+	test_fixture_put(image, test_fixture_raw(idt) + 16, iat);
+	test_fixture_headers(image, false, 0, 0, idt, 2 * 20);
+	return image;
+}
+
+#if WANT_ALLOCATOR_STATS == 1
+template<typename idx_t>
+static void print_stats(main_type_t<idx_t> const& mo)
+{
+	allocator_stats st;
+	mo.m_mm.get_stats(&st);
+	std::wstring str;
+	allocator_stats_to_string(st, str);
+	str.append(L"String hash computations: ");
+	str.append(std::to_wstring(mo.m_hash_computations));
+	str.append(L"\r\n");
+	stage_stats_to_string(mo.m_stage_stats, str);
+	std::uint64_t used_exports = 0;
+	std::uint64_t ordinal_imports = 0;
+	for(std::uint32_t i = s_root_module + 1; i != static_cast<std::uint32_t>(mo.m_modules.size()); ++i)
+	{
+		module_info_t<idx_t> const& mi = mo.m_modules[i];
+		used_exports += array_bool_count(mi.m_export_table.m_are_used, mi.m_export_table.m_count);
+		for(idx_t j = 0; j != mi.m_import_table.m_dll_count; ++j)
+		{
+			ordinal_imports += array_bool_count(mi.m_import_table.m_are_ordinals[j], mi.m_import_table.m_import_counts[j]);
+		}
+	}
+	str.append(L"Used exports: ");
+	str.append(std::to_wstring(used_exports));
+	str.append(L"\r\n");
+	str.append(L"Ordinal imports: ");
+	str.append(std::to_wstring(ordinal_imports));
+	str.append(L"\r\n");
+	OutputDebugStringW(str.c_str());
+}
+#endif
+
+void stats()
+{
+	#if WANT_ALLOCATOR_STATS == 1
+	wchar_t const* const cmd_line = GetCommandLineW();
+	int argc;
+	wchar_t** const argv = CommandLineToArgvW(cmd_line, &argc);
+	smart_local_free const sp_argv(reinterpret_cast<void*>(argv));
+	if(argc < 3)
+	{
+		return;
+	}
+	if(std::wcsncmp(argv[1], s_cmd_arg_stats, std::size(s_cmd_arg_stats) - 1) != 0)
+	{
+		return;
+	}
+	std::vector<std::wstring> const file_paths(argv + 2, argv + argc);
+	auto const progress_fn = [](process_progress const& progress, void* const /*param*/)
+	{
+		if(progress.m_modules_materialized != 0)
+		{
+			if(progress.m_modules_materialized % s_stats_progress_interval != 0)
+			{
+				return;
+			}
+			wchar_t buff[128];
+			int const printed = std::swprintf(buff, std::size(buff), L"Materialized %d of %d modules.\n", progress.m_modules_materialized, progress.m_modules_parsed);
+			assert(printed >= 0);
+			OutputDebugStringW(buff);
+			return;
+		}
+		if(progress.m_modules_parsed % s_stats_progress_interval != 0)
+		{
+			return;
+		}
+		wchar_t buff[128];
+		int const printed = std::swprintf(buff, std::size(buff), L"Parsed %d modules, %d queued, %llu bytes read.\n", progress.m_modules_parsed, progress.m_queue_depth, static_cast<unsigned long long>(progress.m_bytes_read));
+		assert(printed >= 0);
+		OutputDebugStringW(buff);
+	};
+	background_processor bp;
+	bp.start(file_paths, pe_parse_policy::strict, process_mode::full, read_backend::mapped, process_budget{}, progress_fn, nullptr, nullptr);
+	bp.wait();
+	std::shared_ptr<main_type_32 const> const mo = bp.get_published();
+	if(!mo)
+	{
+		OutputDebugStringW(L"Failed to process.\n");
+		return;
 	}
+	print_stats(*mo);
+	#endif
 }
@@ -2,6 +2,8 @@
 
 
 static constexpr wchar_t const s_cmd_arg_test[] = L"/test";
+static constexpr wchar_t const s_cmd_arg_stats[] = L"/stats";
 
 
 void test();
+void stats();
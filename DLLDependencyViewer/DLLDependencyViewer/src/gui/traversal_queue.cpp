@@ -0,0 +1,131 @@
+#include "traversal_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+traversal_hints::traversal_hints() :
+	m_mutex(),
+	m_file_paths(),
+	m_generation(0)
+{
+}
+
+traversal_hints::~traversal_hints()
+{
+}
+
+void traversal_hints::set_focus(std::vector<std::wstring> const& file_paths)
+{
+	std::lock_guard<std::mutex> lck(m_mutex);
+	m_file_paths = file_paths;
+	m_generation.fetch_add(1);
+}
+
+std::uint64_t traversal_hints::get_generation() const
+{
+	return m_generation.load();
+}
+
+std::uint64_t traversal_hints::get_focus(std::vector<std::wstring>* const file_paths_out) const
+{
+	assert(file_paths_out);
+	std::lock_guard<std::mutex> lck(m_mutex);
+	*file_paths_out = m_file_paths;
+	return m_generation.load();
+}
+
+
+traversal_queue::traversal_queue() :
+	m_hints(),
+	m_generation(),
+	m_order(),
+	m_focus_storage(),
+	m_focus_strings(),
+	m_focus(),
+	m_focused(),
+	m_normal()
+{
+}
+
+traversal_queue::~traversal_queue()
+{
+}
+
+void traversal_queue::set_hints(traversal_hints const* const hints)
+{
+	m_hints = hints;
+	m_generation = 0;
+}
+
+void traversal_queue::push(traversal_entry const& entry)
+{
+	enqueue(traversal_queue_entry{entry, m_order++});
+}
+
+traversal_entry traversal_queue::pop()
+{
+	assert(!empty());
+	if(m_hints && m_hints->get_generation() != m_generation)
+	{
+		refresh_focus();
+	}
+	std::deque<traversal_queue_entry>& level = m_focused.empty() ? m_normal : m_focused;
+	traversal_entry const entry = level.front().m_entry;
+	level.pop_front();
+	return entry;
+}
+
+bool traversal_queue::empty() const
+{
+	return m_focused.empty() && m_normal.empty();
+}
+
+int traversal_queue::size() const
+{
+	return static_cast<int>(m_focused.size() + m_normal.size());
+}
+
+void traversal_queue::enqueue(traversal_queue_entry const& entry)
+{
+	if(is_focused(entry.m_entry))
+	{
+		m_focused.push_back(entry);
+	}
+	else
+	{
+		m_normal.push_back(entry);
+	}
+}
+
+bool traversal_queue::is_focused(traversal_entry const& entry) const
+{
+	if(m_focus.empty())
+	{
+		return false;
+	}
+	return m_focus.find(entry.m_file_path) != m_focus.end() || (entry.m_parent_path.m_string && m_focus.find(entry.m_parent_path) != m_focus.end());
+}
+
+void traversal_queue::refresh_focus()
+{
+	assert(m_hints);
+	m_generation = m_hints->get_focus(&m_focus_storage);
+	m_focus.clear();
+	m_focus_strings.resize(m_focus_storage.size());
+	for(int i = 0; i != static_cast<int>(m_focus_storage.size()); ++i)
+	{
+		m_focus_strings[i] = wstring{m_focus_storage[i].c_str(), static_cast<int>(m_focus_storage[i].size()), 0};
+		m_focus.insert(wstring_handle{&m_focus_strings[i]});
+	}
+	std::vector<traversal_queue_entry> entries;
+	entries.reserve(m_focused.size() + m_normal.size());
+	std::merge(m_focused.begin(), m_focused.end(), m_normal.begin(), m_normal.end(), std::back_inserter(entries), [](traversal_queue_entry const& a, traversal_queue_entry const& b){ return a.m_order < b.m_order; });
+	m_focused.clear();
+	m_normal.clear();
+	for(auto const& entry : entries)
+	{
+		enqueue(entry);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+
+#include "../nogui/my_string_handle.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+class traversal_hints
+{
+public:
+	traversal_hints();
+	traversal_hints(traversal_hints const&) = delete;
+	traversal_hints& operator=(traversal_hints const&) = delete;
+	~traversal_hints();
+public:
+	void set_focus(std::vector<std::wstring> const& file_paths);
+	std::uint64_t get_generation() const;
+	std::uint64_t get_focus(std::vector<std::wstring>* const file_paths_out) const;
+private:
+	mutable std::mutex m_mutex;
+	std::vector<std::wstring> m_file_paths;
+	std::atomic<std::uint64_t> m_generation;
+};
+
+
+struct traversal_entry
+{
+	wstring_handle m_file_path;
+	wstring_handle m_parent_path;
+	std::uint32_t m_node;
+	int m_depth;
+};
+
+struct traversal_queue_entry
+{
+	traversal_entry m_entry;
+	std::uint64_t m_order;
+};
+
+
+class traversal_queue
+{
+public:
+	traversal_queue();
+	traversal_queue(traversal_queue const&) = delete;
+	traversal_queue& operator=(traversal_queue const&) = delete;
+	~traversal_queue();
+public:
+	void set_hints(traversal_hints const* const hints);
+	void push(traversal_entry const& entry);
+	traversal_entry pop();
+	bool empty() const;
+	int size() const;
+private:
+	void enqueue(traversal_queue_entry const& entry);
+	bool is_focused(traversal_entry const& entry) const;
+	void refresh_focus();
+private:
+	traversal_hints const* m_hints;
+	std::uint64_t m_generation;
+	std::uint64_t m_order;
+	std::vector<std::wstring> m_focus_storage;
+	std::vector<wstring> m_focus_strings;
+	std::unordered_set<wstring_handle, wstring_handle_case_insensitive_hash, wstring_handle_case_insensitive_equal> m_focus;
+	std::deque<traversal_queue_entry> m_focused;
+	std::deque<traversal_queue_entry> m_normal;
+};
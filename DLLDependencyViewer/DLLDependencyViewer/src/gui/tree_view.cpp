@@ -33,7 +33,8 @@ tree_view::tree_view(HWND const parent, main_window& mw) :
 	m_hwnd(CreateWindowExW(WS_EX_WINDOWEDGE | WS_EX_CLIENTEDGE, WC_TREEVIEWW, nullptr, WS_VISIBLE | WS_CHILD, 0, 0, 0, 0, parent, nullptr, get_instance(), nullptr)),
 	m_main_window(mw),
 	m_menu(create_menu()),
-	m_string_converter()
+	m_string_converter(),
+	m_tree_items()
 {
 	LRESULT const set_dbl_bfr = SendMessageW(m_hwnd, TVM_SETEXTENDEDSTYLE, TVS_EX_DOUBLEBUFFER, TVS_EX_DOUBLEBUFFER);
 	assert(set_dbl_bfr == S_OK);
@@ -63,14 +64,19 @@ void tree_view::on_notify(NMHDR& nmhdr)
 	{
 		on_selchangedw(nmhdr);
 	}
+	else if(nmhdr.code == TVN_ITEMEXPANDINGW)
+	{
+		on_itemexpandingw(nmhdr);
+	}
 }
 
 void tree_view::on_getdispinfow(NMHDR& nmhdr)
 {
 	NMTVDISPINFOW& di = reinterpret_cast<NMTVDISPINFOW&>(nmhdr);
-	file_info const& tmp_fi = *reinterpret_cast<file_info*>(di.item.lParam);
-	file_info const& fi = tmp_fi.m_orig_instance ? *tmp_fi.m_orig_instance : tmp_fi;
-	file_info const* parent_fi = nullptr;
+	main_type_32 const& mo = m_main_window.m_mo;
+	file_info_32 const& tmp_fi = *reinterpret_cast<file_info_32*>(di.item.lParam);
+	module_info_32 const& fi = get_module(mo, tmp_fi);
+	file_info_32 const* parent_fi = nullptr;
 	HTREEITEM const parent_item = reinterpret_cast<HTREEITEM>(SendMessageW(m_hwnd, TVM_GETNEXTITEM, TVGN_PARENT, reinterpret_cast<LPARAM>(di.item.hItem)));
 	if(parent_item)
 	{
@@ -79,7 +85,7 @@ void tree_view::on_getdispinfow(NMHDR& nmhdr)
 		ti.mask = TVIF_PARAM;
 		LRESULT const got = SendMessageW(m_hwnd, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got == TRUE);
-		parent_fi = reinterpret_cast<file_info*>(ti.lParam);
+		parent_fi = reinterpret_cast<file_info_32*>(ti.lParam);
 	}
 	if((di.item.mask & TVIF_TEXT) != 0)
 	{
@@ -92,10 +98,8 @@ void tree_view::on_getdispinfow(NMHDR& nmhdr)
 		{
 			if(parent_fi)
 			{
-				auto const idx_ = &tmp_fi - parent_fi->m_fis;
-				assert(idx_ >= 0 && idx_ <= 0xFFFF);
-				std::uint16_t const idx = static_cast<std::uint16_t>(idx_);
-				string_handle const& my_name = parent_fi->m_import_table.m_dll_names[idx];
+				std::uint32_t const idx = get_dll_idx(mo, tmp_fi);
+				string_handle const& my_name = get_module(mo, *parent_fi).m_import_table.m_dll_names[idx];
 				di.item.pszText = const_cast<wchar_t*>(m_string_converter.convert(my_name));
 			}
 			else
@@ -110,18 +114,16 @@ void tree_view::on_getdispinfow(NMHDR& nmhdr)
 		bool delay;
 		if(parent_fi)
 		{
-			auto const idx_ = &tmp_fi - parent_fi->m_fis;
-			assert(idx_ >= 0 && idx_ <= 0xFFFF);
-			std::uint16_t const idx = static_cast<std::uint16_t>(idx_);
-			delay = idx >= parent_fi->m_import_table.m_non_delay_dll_count;
+			std::uint32_t const idx = get_dll_idx(mo, tmp_fi);
+			delay = idx >= get_module(mo, *parent_fi).m_import_table.m_non_delay_dll_count;
 		}
 		else
 		{
 			delay = false;
 		}
 		bool const is_32_bit = fi.m_is_32_bit;
-		bool const is_duplicate = tmp_fi.m_orig_instance != nullptr;
-		bool const is_missing = fi.m_file_path.m_string == nullptr;
+		bool const is_duplicate = get_orig_instance(mo, tmp_fi) != nullptr;
+		bool const is_missing = fi.m_file_path.m_string == nullptr || fi.m_truncation != truncation::none;
 		bool const is_delay = delay;
 		if(is_missing)
 		{
@@ -196,6 +198,17 @@ void tree_view::on_selchangedw([[maybe_unused]] NMHDR& nmhdr)
 	m_main_window.on_tree_selchangedw();
 }
 
+void tree_view::on_itemexpandingw(NMHDR& nmhdr)
+{
+	NMTREEVIEWW const& nmtv = reinterpret_cast<NMTREEVIEWW&>(nmhdr);
+	if((nmtv.action & TVE_EXPAND) == 0)
+	{
+		return;
+	}
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(nmtv.itemNew.lParam);
+	insert_children(fi, nmtv.itemNew.hItem);
+}
+
 void tree_view::on_context_menu(LPARAM const lparam)
 {
 	POINT cursor_screen;
@@ -252,9 +265,10 @@ void tree_view::on_context_menu(LPARAM const lparam)
 		ti.mask = TVIF_PARAM;
 		LRESULT const got_item = SendMessageW(m_hwnd, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 		assert(got_item == TRUE);
-		file_info const& tmp_fi = *reinterpret_cast<file_info*>(ti.lParam);
-		file_info const& fi = tmp_fi.m_orig_instance ? *tmp_fi.m_orig_instance : tmp_fi;
-		enable_goto_orig = tmp_fi.m_orig_instance != nullptr;
+		main_type_32 const& mo = m_main_window.m_mo;
+		file_info_32 const& tmp_fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+		module_info_32 const& fi = get_module(mo, tmp_fi);
+		enable_goto_orig = get_orig_instance(mo, tmp_fi) != nullptr;
 		enable_properties = fi.m_file_path.m_string != nullptr;
 	}
 	else
@@ -360,21 +374,27 @@ void tree_view::refresh()
 	LRESULT const deleted = SendMessageW(m_hwnd, TVM_DELETEITEM, 0, reinterpret_cast<LPARAM>(TVI_ROOT));
 	assert(deleted == TRUE);
 
-	file_info& fi = m_main_window.m_mo.m_fi;
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	assert(n >= 1);
-	for(std::uint16_t i = 0; i != n; ++i)
+	main_type_32& mo = m_main_window.m_mo;
+	m_tree_items.assign(mo.m_nodes.size(), nullptr);
+	std::uint32_t const modules_count = static_cast<std::uint32_t>(mo.m_modules.size());
+	for(std::uint32_t i = s_root_module + 1; i != modules_count; ++i)
 	{
-		file_info& sub_fi = fi.m_fis[i];
-		refresh_view_recursive(sub_fi, TVI_ROOT);
+		module_info_32& mi = mo.m_modules[i];
+		m_main_window.request_symbols_from_addresses(mi);
+		m_main_window.request_symbol_undecoration(mi);
 	}
+	file_info_32 const& fi = get_root(mo);
+	std::uint32_t const n = get_child_count(mo, fi);
+	assert(n >= 1);
+	file_info_32* const fis = get_children(mo, fi);
+	insert_children(fi, TVI_ROOT);
 
-	for(std::uint16_t i = 0; i != n; ++i)
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		file_info& sub_fi = fi.m_fis[i];
-		LRESULT const expanded = SendMessageW(m_hwnd, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(sub_fi.m_tree_item));
+		file_info_32 const& sub_fi = fis[i];
+		LRESULT const expanded = SendMessageW(m_hwnd, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(m_tree_items[get_node_idx(mo, sub_fi)]));
 	}
-	HTREEITEM const first = static_cast<HTREEITEM>(fi.m_fis[0].m_tree_item);
+	HTREEITEM const first = static_cast<HTREEITEM>(m_tree_items[get_node_idx(mo, fis[0])]);
 	LRESULT const visibled = SendMessageW(m_hwnd, TVM_ENSUREVISIBLE, 0, reinterpret_cast<LPARAM>(first));
 	LRESULT const selected = SendMessageW(m_hwnd, TVM_SELECTITEM, TVGN_CARET, reinterpret_cast<LPARAM>(first));
 	assert(selected == TRUE);
@@ -424,37 +444,59 @@ smart_menu tree_view::create_menu()
 	return sm;
 }
 
-void tree_view::refresh_view_recursive(file_info& fi, void* const parent_ti)
+void tree_view::insert_children(file_info_32 const& fi, void* const parent_ti)
+{
+	main_type_32& mo = m_main_window.m_mo;
+	std::uint32_t const n = get_child_count(mo, fi);
+	if(n == 0)
+	{
+		return;
+	}
+	file_info_32* const fis = get_children(mo, fi);
+	if(m_tree_items[get_node_idx(mo, fis[0])] != nullptr)
+	{
+		return;
+	}
+	for(std::uint32_t i = 0; i != n; ++i)
+	{
+		file_info_32& sub_fi = fis[i];
+		TVINSERTSTRUCTW tvi;
+		tvi.hParent = reinterpret_cast<HTREEITEM>(parent_ti);
+		tvi.hInsertAfter = TVI_LAST;
+		tvi.itemex.mask = TVIF_TEXT | TVIF_IMAGE | TVIF_PARAM | TVIF_SELECTEDIMAGE | TVIF_CHILDREN;
+		tvi.itemex.hItem = nullptr;
+		tvi.itemex.state = 0;
+		tvi.itemex.stateMask = 0;
+		tvi.itemex.pszText = LPSTR_TEXTCALLBACKW;
+		tvi.itemex.cchTextMax = 0;
+		tvi.itemex.iImage = I_IMAGECALLBACK;
+		tvi.itemex.iSelectedImage = I_IMAGECALLBACK;
+		tvi.itemex.cChildren = get_child_count(mo, sub_fi) != 0 ? 1 : 0;
+		tvi.itemex.lParam = reinterpret_cast<LPARAM>(&sub_fi);
+		tvi.itemex.iIntegral = 0;
+		tvi.itemex.uStateEx = 0;
+		tvi.itemex.hwnd = nullptr;
+		tvi.itemex.iExpandedImage = 0;
+		tvi.itemex.iReserved = 0;
+		HTREEITEM const ti = reinterpret_cast<HTREEITEM>(SendMessageW(m_hwnd, TVM_INSERTITEMW, 0, reinterpret_cast<LPARAM>(&tvi)));
+		assert(ti != nullptr);
+		m_tree_items[get_node_idx(mo, sub_fi)] = ti;
+	}
+}
+
+void* tree_view::get_tree_item(file_info_32 const& fi)
 {
-	TVINSERTSTRUCTW tvi;
-	tvi.hParent = reinterpret_cast<HTREEITEM>(parent_ti);
-	tvi.hInsertAfter = TVI_LAST;
-	tvi.itemex.mask = TVIF_TEXT | TVIF_IMAGE | TVIF_PARAM | TVIF_SELECTEDIMAGE;
-	tvi.itemex.hItem = nullptr;
-	tvi.itemex.state = 0;
-	tvi.itemex.stateMask = 0;
-	tvi.itemex.pszText = LPSTR_TEXTCALLBACKW;
-	tvi.itemex.cchTextMax = 0;
-	tvi.itemex.iImage = I_IMAGECALLBACK;
-	tvi.itemex.iSelectedImage = I_IMAGECALLBACK;
-	tvi.itemex.cChildren = 0;
-	tvi.itemex.lParam = reinterpret_cast<LPARAM>(&fi);
-	tvi.itemex.iIntegral = 0;
-	tvi.itemex.uStateEx = 0;
-	tvi.itemex.hwnd = nullptr;
-	tvi.itemex.iExpandedImage = 0;
-	tvi.itemex.iReserved = 0;
-	HTREEITEM const ti = reinterpret_cast<HTREEITEM>(SendMessageW(m_hwnd, TVM_INSERTITEMW, 0, reinterpret_cast<LPARAM>(&tvi)));
-	assert(ti != nullptr);
-	fi.m_tree_item = ti;
-	m_main_window.request_symbols_from_addresses(fi);
-	m_main_window.request_symbol_undecoration(fi);
-	std::uint16_t const n = fi.m_import_table.m_dll_count;
-	for(std::uint16_t i = 0; i != n; ++i)
-	{
-		file_info& sub_fi = fi.m_fis[i];
-		refresh_view_recursive(sub_fi, ti);
+	main_type_32& mo = m_main_window.m_mo;
+	std::uint32_t const idx = get_node_idx(mo, fi);
+	if(m_tree_items[idx] != nullptr)
+	{
+		return m_tree_items[idx];
 	}
+	file_info_32 const& parent_fi = mo.m_nodes[mo.m_modules[fi.m_parent_module].m_orig_node];
+	void* const parent_ti = get_tree_item(parent_fi);
+	insert_children(parent_fi, parent_ti);
+	assert(m_tree_items[idx] != nullptr);
+	return m_tree_items[idx];
 }
 
 void tree_view::select_original_instance()
@@ -469,12 +511,13 @@ void tree_view::select_original_instance()
 	ti.mask = TVIF_PARAM;
 	LRESULT const got_item = SendMessageW(m_hwnd, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got_item == TRUE);
-	file_info const& fi = *reinterpret_cast<file_info*>(ti.lParam);
-	if(!fi.m_orig_instance)
+	file_info_32 const& fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	file_info_32 const* const orig = get_orig_instance(m_main_window.m_mo, fi);
+	if(!orig)
 	{
 		return;
 	}
-	LRESULT const orig_selected = SendMessageW(m_hwnd, TVM_SELECTITEM, TVGN_CARET, reinterpret_cast<LPARAM>(fi.m_orig_instance->m_tree_item));
+	LRESULT const orig_selected = SendMessageW(m_hwnd, TVM_SELECTITEM, TVGN_CARET, reinterpret_cast<LPARAM>(get_tree_item(*orig)));
 	assert(orig_selected == TRUE);
 }
 
@@ -484,10 +527,11 @@ void tree_view::expand()
 	{
 		static constexpr auto const recursion = [](auto const& self, HWND const hwnd, HTREEITEM const item) -> void
 		{
+			// Expanding first, children are inserted on demand by TVN_ITEMEXPANDINGW.
+			LRESULT const expanded = SendMessageW(hwnd, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(item));
 			HTREEITEM const child_first = reinterpret_cast<HTREEITEM>(SendMessageW(hwnd, TVM_GETNEXTITEM, TVGN_CHILD, reinterpret_cast<LPARAM>(item)));
 			if(child_first)
 			{
-				LRESULT const expanded = SendMessageW(hwnd, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(item));
 				assert(expanded != 0);
 				self(self, hwnd, child_first);
 			}
@@ -608,8 +652,8 @@ void tree_view::properties()
 	LRESULT const got = SendMessageW(m_hwnd, TVM_GETITEMW, 0, reinterpret_cast<LPARAM>(&ti));
 	assert(got == TRUE);
 	assert(ti.lParam);
-	file_info const& tmp_fi = *reinterpret_cast<file_info*>(ti.lParam);
-	file_info const& fi = tmp_fi.m_orig_instance ? *tmp_fi.m_orig_instance : tmp_fi;
+	file_info_32 const& tmp_fi = *reinterpret_cast<file_info_32*>(ti.lParam);
+	module_info_32 const& fi = get_module(m_main_window.m_mo, tmp_fi);
 	if(fi.m_file_path.m_string == nullptr)
 	{
 		return;
@@ -1,10 +1,12 @@
 #pragma once
 
 
+#include "processor.h"
 #include "smart_menu.h"
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "../nogui/string_converter.h"
 
@@ -12,7 +14,6 @@
 
 
 class main_window;
-struct file_info;
 
 
 class tree_view
@@ -30,6 +31,7 @@ public:
 	void on_notify(NMHDR& nmhdr);
 	void on_getdispinfow(NMHDR& nmhdr);
 	void on_selchangedw(NMHDR& nmhdr);
+	void on_itemexpandingw(NMHDR& nmhdr);
 	void on_context_menu(LPARAM const lparam);
 	void on_menu(std::uint16_t const menu_id);
 	void on_menu_orig();
@@ -45,7 +47,8 @@ public:
 	void repaint();
 private:
 	smart_menu create_menu();
-	void refresh_view_recursive(file_info& fi, void* const ti);
+	void insert_children(file_info_32 const& fi, void* const parent_ti);
+	void* get_tree_item(file_info_32 const& fi);
 	void select_original_instance();
 	void expand();
 	void collapse();
@@ -55,4 +58,5 @@ private:
 	main_window& m_main_window;
 	smart_menu const m_menu;
 	string_converter m_string_converter;
+	std::vector<void*> m_tree_items;
 };
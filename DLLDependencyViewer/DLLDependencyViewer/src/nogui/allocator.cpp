@@ -15,6 +15,9 @@ allocator::allocator() noexcept :
 	m_big()
 	#endif
 {
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats_init(&m_stats);
+	#endif
 }
 
 allocator::allocator(allocator&& other) noexcept :
@@ -42,10 +45,16 @@ void allocator::swap(allocator& other) noexcept
 	swap(m_small, other.m_small);
 	swap(m_big, other.m_big);
 	#endif
+	#if WANT_ALLOCATOR_STATS == 1
+	swap(m_stats, other.m_stats);
+	#endif
 }
 
-void* allocator::allocate_bytes(int const size, int const align)
+void* allocator::allocate_bytes(int const size, int const align, [[maybe_unused]] allocation_tag const tag)
 {
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats_on_allocate(&m_stats, size, tag);
+	#endif
 	#if WANT_STANDARD_ALLOCATOR == 1
 	return m_mallocator.allocate_bytes(size, align);
 	#else
@@ -60,3 +69,15 @@ void* allocator::allocate_bytes(int const size, int const align)
 	}
 	#endif
 }
+
+#if WANT_ALLOCATOR_STATS == 1
+void allocator::get_stats(allocator_stats* const stats_out) const
+{
+	assert(stats_out);
+	*stats_out = m_stats;
+	#if WANT_STANDARD_ALLOCATOR == 0
+	m_small.get_stats(stats_out);
+	m_big.get_stats(stats_out);
+	#endif
+}
+#endif
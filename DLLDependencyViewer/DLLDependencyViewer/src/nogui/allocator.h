@@ -4,6 +4,8 @@
 #define WANT_STANDARD_ALLOCATOR 0
 
 
+#include "allocator_stats.h"
+
 #if WANT_STANDARD_ALLOCATOR == 1
 #include "allocator_malloc.h"
 #else
@@ -23,8 +25,11 @@ public:
 	~allocator() noexcept;
 	void swap(allocator& other) noexcept;
 public:
-	void* allocate_bytes(int const size, int const align);
-	template<typename T> T* allocate_objects(int const size) { return static_cast<T*>(allocate_bytes(size * sizeof(T), alignof(T))); }
+	void* allocate_bytes(int const size, int const align, allocation_tag const tag = allocation_tag::other);
+	template<typename T> T* allocate_objects(int const size, allocation_tag const tag = allocation_tag::other) { return static_cast<T*>(allocate_bytes(size * sizeof(T), alignof(T), tag)); }
+	#if WANT_ALLOCATOR_STATS == 1
+	void get_stats(allocator_stats* const stats_out) const;
+	#endif
 private:
 	#if WANT_STANDARD_ALLOCATOR == 1
 	allocator_malloc m_mallocator;
@@ -32,6 +37,9 @@ private:
 	allocator_small m_small;
 	allocator_big m_big;
 	#endif
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats m_stats;
+	#endif
 };
 
 inline void swap(allocator& a, allocator& b) noexcept { a.swap(b); }
@@ -10,6 +10,7 @@
 
 
 static constexpr int const s_allocator_big_state_size = 64 * 1024;
+static constexpr int const s_allocator_big_page_size = 4 * 1024;
 
 
 struct allocator_big_inner_t;
@@ -30,6 +31,9 @@ struct allocator_big_outer_t
 
 
 allocator_big::allocator_big() noexcept :
+	#if WANT_ALLOCATOR_STATS == 1
+	m_committed(0),
+	#endif
 	m_state(nullptr)
 {
 }
@@ -62,12 +66,18 @@ allocator_big::~allocator_big() noexcept
 		BOOL const freed = VirtualFree(old_self, 0, MEM_RELEASE);
 		assert(freed != 0);
 	}
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats_on_decommit(m_committed);
+	#endif
 }
 
 void allocator_big::swap(allocator_big& other) noexcept
 {
 	using std::swap;
 	swap(m_state, other.m_state);
+	#if WANT_ALLOCATOR_STATS == 1
+	swap(m_committed, other.m_committed);
+	#endif
 }
 
 void* allocator_big::allocate_bytes(int const size, [[maybe_unused]] int const align)
@@ -84,6 +94,10 @@ void* allocator_big::allocate_bytes(int const size, [[maybe_unused]] int const a
 		state_1->m_inner.m_prev = self;
 		m_state = state_1;
 		self = state_1;
+		#if WANT_ALLOCATOR_STATS == 1
+		m_committed += s_allocator_big_state_size;
+		allocator_stats_on_commit(s_allocator_big_state_size);
+		#endif
 	}
 	assert(self);
 	assert(self->m_inner.m_free_allocs > 0);
@@ -91,5 +105,24 @@ void* allocator_big::allocate_bytes(int const size, [[maybe_unused]] int const a
 	assert(new_mem_2);
 	self->m_allocs[std::size(self->m_allocs) - self->m_inner.m_free_allocs] = new_mem_2;
 	--self->m_inner.m_free_allocs;
+	#if WANT_ALLOCATOR_STATS == 1
+	std::uint64_t const committed = (static_cast<std::uint64_t>(size) + s_allocator_big_page_size - 1) / s_allocator_big_page_size * s_allocator_big_page_size;
+	m_committed += committed;
+	allocator_stats_on_commit(committed);
+	#endif
 	return new_mem_2;
 }
+
+#if WANT_ALLOCATOR_STATS == 1
+void allocator_big::get_stats(allocator_stats* const stats_in_out) const
+{
+	assert(stats_in_out);
+	stats_in_out->m_committed_bytes += m_committed;
+	allocator_big_outer_t const* self = static_cast<allocator_big_outer_t const*>(m_state);
+	while(self)
+	{
+		stats_in_out->m_big_allocations += static_cast<int>(std::size(self->m_allocs)) - self->m_inner.m_free_allocs;
+		self = self->m_inner.m_prev;
+	}
+}
+#endif
@@ -1,6 +1,11 @@
 #pragma once
 
 
+#include "allocator_stats.h"
+
+#include <cstdint>
+
+
 class allocator_big
 {
 public:
@@ -13,7 +18,13 @@ public:
 	void swap(allocator_big& other) noexcept;
 public:
 	void* allocate_bytes(int const size, int const align);
+	#if WANT_ALLOCATOR_STATS == 1
+	void get_stats(allocator_stats* const stats_in_out) const;
+	#endif
 private:
+	#if WANT_ALLOCATOR_STATS == 1
+	std::uint64_t m_committed;
+	#endif
 	void* m_state;
 };
 
@@ -20,6 +20,10 @@ static constexpr int const s_chunk_usable_size = s_chunk_size - sizeof(header);
 
 
 allocator_small::allocator_small() noexcept :
+	#if WANT_ALLOCATOR_STATS == 1
+	m_allocations(0),
+	m_padding(0),
+	#endif
 	m_state(nullptr)
 {
 }
@@ -45,6 +49,9 @@ allocator_small::~allocator_small() noexcept
 		self = self->m_prev;
 		BOOL const freed = VirtualFree(old_self, 0, MEM_RELEASE);
 		assert(freed != 0);
+		#if WANT_ALLOCATOR_STATS == 1
+		allocator_stats_on_decommit(s_chunk_size);
+		#endif
 	}
 }
 
@@ -52,6 +59,10 @@ void allocator_small::swap(allocator_small& other) noexcept
 {
 	using std::swap;
 	swap(m_state, other.m_state);
+	#if WANT_ALLOCATOR_STATS == 1
+	swap(m_allocations, other.m_allocations);
+	swap(m_padding, other.m_padding);
+	#endif
 }
 
 void* allocator_small::allocate_bytes(int const size, int const align)
@@ -90,6 +101,9 @@ void* allocator_small::allocate_block()
 {
 	void* const new_mem = VirtualAlloc(NULL, s_chunk_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
 	assert(new_mem);
+	#if WANT_ALLOCATOR_STATS == 1
+	allocator_stats_on_commit(s_chunk_size);
+	#endif
 	header* const block = static_cast<header*>(new_mem);
 	block->m_remaining = s_chunk_usable_size;
 	block->m_prev = nullptr;
@@ -114,5 +128,29 @@ void* allocator_small::allocate_from_block(void* const block, int const size, in
 	int const this_alloc_size = size + i;
 	self->m_remaining -= this_alloc_size;
 	assert(self->m_remaining >= 0);
+	#if WANT_ALLOCATOR_STATS == 1
+	++m_allocations;
+	m_padding += i;
+	#endif
 	return ret;
 }
+
+#if WANT_ALLOCATOR_STATS == 1
+void allocator_small::get_stats(allocator_stats* const stats_in_out) const
+{
+	assert(stats_in_out);
+	stats_in_out->m_small_allocations += m_allocations;
+	stats_in_out->m_padding_bytes += m_padding;
+	header const* block = static_cast<header const*>(m_state);
+	while(block)
+	{
+		++stats_in_out->m_small_chunks;
+		stats_in_out->m_committed_bytes += s_chunk_size;
+		if(block != m_state)
+		{
+			stats_in_out->m_tail_waste_bytes += block->m_remaining;
+		}
+		block = block->m_prev;
+	}
+}
+#endif
@@ -1,6 +1,11 @@
 #pragma once
 
 
+#include "allocator_stats.h"
+
+#include <cstdint>
+
+
 class allocator_small
 {
 public:
@@ -13,11 +18,18 @@ public:
 	void swap(allocator_small& other) noexcept;
 public:
 	void* allocate_bytes(int const size, int const align);
+	#if WANT_ALLOCATOR_STATS == 1
+	void get_stats(allocator_stats* const stats_in_out) const;
+	#endif
 private:
 	void* find_block(int const size, int const align);
 	void* allocate_block();
 	void* allocate_from_block(void* const block, int const size, int const align);
 private:
+	#if WANT_ALLOCATOR_STATS == 1
+	std::uint64_t m_allocations;
+	std::uint64_t m_padding;
+	#endif
 	void* m_state;
 };
 
@@ -0,0 +1,97 @@
+#include "allocator_stats.h"
+
+#if WANT_ALLOCATOR_STATS == 1
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+
+static constexpr wchar_t const* const s_allocation_tag_names[] =
+{
+	L"other",
+	L"strings",
+	L"import tables",
+	L"export tables",
+	L"matching",
+	L"tree nodes",
+};
+static_assert(std::size(s_allocation_tag_names) == static_cast<int>(allocation_tag::count));
+
+
+static std::atomic<std::uint64_t> g_allocator_committed{0};
+static std::atomic<std::uint64_t> g_allocator_high_water{0};
+
+
+void allocator_stats_init(allocator_stats* const stats_out)
+{
+	assert(stats_out);
+	std::memset(stats_out, 0, sizeof(*stats_out));
+}
+
+void allocator_stats_on_allocate(allocator_stats* const stats_in_out, int const size, allocation_tag const tag)
+{
+	assert(stats_in_out);
+	assert(tag < allocation_tag::count);
+	stats_in_out->m_requested_bytes += size;
+	stats_in_out->m_tag_bytes[static_cast<int>(tag)] += size;
+	++stats_in_out->m_tag_allocations[static_cast<int>(tag)];
+}
+
+void allocator_stats_on_commit(std::uint64_t const bytes)
+{
+	std::uint64_t const committed = g_allocator_committed.fetch_add(bytes) + bytes;
+	std::uint64_t high_water = g_allocator_high_water.load();
+	while(committed > high_water && !g_allocator_high_water.compare_exchange_weak(high_water, committed))
+	{
+	}
+}
+
+void allocator_stats_on_decommit(std::uint64_t const bytes)
+{
+	assert(g_allocator_committed.load() >= bytes);
+	g_allocator_committed.fetch_sub(bytes);
+}
+
+std::uint64_t allocator_stats_get_committed()
+{
+	return g_allocator_committed.load();
+}
+
+std::uint64_t allocator_stats_get_high_water()
+{
+	return g_allocator_high_water.load();
+}
+
+void allocator_stats_to_string(allocator_stats const& stats, std::wstring& str)
+{
+	auto const line = [&](wchar_t const* const name, std::uint64_t const value)
+	{
+		str.append(name);
+		str.append(L": ");
+		str.append(std::to_wstring(value));
+		str.append(L"\r\n");
+	};
+	line(L"Requested bytes", stats.m_requested_bytes);
+	line(L"Alignment padding bytes", stats.m_padding_bytes);
+	line(L"Tail waste bytes", stats.m_tail_waste_bytes);
+	line(L"Committed bytes", stats.m_committed_bytes);
+	line(L"Small allocations", stats.m_small_allocations);
+	line(L"Small chunks", stats.m_small_chunks);
+	line(L"Big allocations", stats.m_big_allocations);
+	for(int i = 0; i != static_cast<int>(allocation_tag::count); ++i)
+	{
+		str.append(L"Tag ");
+		str.append(s_allocation_tag_names[i]);
+		str.append(L": ");
+		str.append(std::to_wstring(stats.m_tag_bytes[i]));
+		str.append(L" bytes in ");
+		str.append(std::to_wstring(stats.m_tag_allocations[i]));
+		str.append(L" allocations\r\n");
+	}
+	line(L"Process committed bytes", allocator_stats_get_committed());
+	line(L"Process high-water bytes", allocator_stats_get_high_water());
+}
+
+#endif
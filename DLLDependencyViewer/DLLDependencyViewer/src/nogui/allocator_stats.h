@@ -0,0 +1,50 @@
+#pragma once
+
+
+#include <cstdint>
+#include <string>
+
+
+#ifdef _DEBUG
+#define WANT_ALLOCATOR_STATS 1
+#else
+#define WANT_ALLOCATOR_STATS 0
+#endif
+
+
+enum class allocation_tag : std::uint8_t
+{
+	other,
+	strings,
+	import_tables,
+	export_tables,
+	matching,
+	tree_nodes,
+	count
+};
+
+
+#if WANT_ALLOCATOR_STATS == 1
+
+struct allocator_stats
+{
+	std::uint64_t m_requested_bytes;
+	std::uint64_t m_padding_bytes;
+	std::uint64_t m_tail_waste_bytes;
+	std::uint64_t m_committed_bytes;
+	std::uint64_t m_small_allocations;
+	std::uint64_t m_small_chunks;
+	std::uint64_t m_big_allocations;
+	std::uint64_t m_tag_bytes[static_cast<int>(allocation_tag::count)];
+	std::uint64_t m_tag_allocations[static_cast<int>(allocation_tag::count)];
+};
+
+void allocator_stats_init(allocator_stats* const stats_out);
+void allocator_stats_on_allocate(allocator_stats* const stats_in_out, int const size, allocation_tag const tag);
+void allocator_stats_on_commit(std::uint64_t const bytes);
+void allocator_stats_on_decommit(std::uint64_t const bytes);
+std::uint64_t allocator_stats_get_committed();
+std::uint64_t allocator_stats_get_high_water();
+void allocator_stats_to_string(allocator_stats const& stats, std::wstring& str);
+
+#endif
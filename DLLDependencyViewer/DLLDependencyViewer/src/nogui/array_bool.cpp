@@ -1,8 +1,20 @@
 #include "array_bool.h"
 
+#include <bit>
+#include <cassert>
 #include <climits>
 
 
+static constexpr int const s_array_bool_word_bits = static_cast<int>(sizeof(std::uint64_t)) * CHAR_BIT;
+
+
+static std::uint64_t array_bool_low_mask(int const count)
+{
+	assert(count >= 0 && count <= s_array_bool_word_bits);
+	return count == s_array_bool_word_bits ? ~std::uint64_t{0} : ((std::uint64_t{1} << count) - 1);
+}
+
+
 int array_bool_space_needed(int const number_of_bools)
 {
 	if(number_of_bools == 0)
@@ -11,27 +23,85 @@ int array_bool_space_needed(int const number_of_bools)
 	}
 	else
 	{
-		return ((number_of_bools - 1) / (static_cast<int>(sizeof(unsigned)) * CHAR_BIT)) + 1;
+		return ((number_of_bools - 1) / s_array_bool_word_bits) + 1;
 	}
 }
 
-void array_bool_set(unsigned* const arr, int const idx)
+void array_bool_set(std::uint64_t* const arr, int const idx)
+{
+	int const i = idx / s_array_bool_word_bits;
+	int const j = idx % s_array_bool_word_bits;
+	arr[i] |= (std::uint64_t{1} << j);
+}
+
+void array_bool_clr(std::uint64_t* const arr, int const idx)
 {
-	int const i = idx / (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	int const j = idx % (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	arr[i] |= (1u << j);
+	int const i = idx / s_array_bool_word_bits;
+	int const j = idx % s_array_bool_word_bits;
+	arr[i] &=~ (std::uint64_t{1} << j);
 }
 
-void array_bool_clr(unsigned* const arr, int const idx)
+bool array_bool_tst(std::uint64_t const* const arr, int const idx)
 {
-	int const i = idx / (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	int const j = idx % (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	arr[i] &=~ (1u << j);
+	int const i = idx / s_array_bool_word_bits;
+	int const j = idx % s_array_bool_word_bits;
+	return (arr[i] & (std::uint64_t{1} << j)) != 0;
 }
 
-bool array_bool_tst(unsigned const* const arr, int const idx)
+void array_bool_set_bits(std::uint64_t* const arr, int const idx, std::uint64_t const bits, int const count)
 {
-	int const i = idx / (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	int const j = idx % (static_cast<int>(sizeof(unsigned)) * CHAR_BIT);
-	return (arr[i] & (1u << j)) != 0;
+	assert(count >= 0 && count <= s_array_bool_word_bits);
+	if(count == 0)
+	{
+		return;
+	}
+	std::uint64_t const b = bits & array_bool_low_mask(count);
+	int const i = idx / s_array_bool_word_bits;
+	int const j = idx % s_array_bool_word_bits;
+	arr[i] |= b << j;
+	if(j != 0 && count > s_array_bool_word_bits - j)
+	{
+		arr[i + 1] |= b >> (s_array_bool_word_bits - j);
+	}
+}
+
+int array_bool_count(std::uint64_t const* const arr, int const number_of_bools)
+{
+	int const full_words = number_of_bools / s_array_bool_word_bits;
+	int const tail = number_of_bools % s_array_bool_word_bits;
+	int ret = 0;
+	for(int i = 0; i != full_words; ++i)
+	{
+		ret += std::popcount(arr[i]);
+	}
+	if(tail != 0)
+	{
+		ret += std::popcount(arr[full_words] & array_bool_low_mask(tail));
+	}
+	return ret;
+}
+
+int array_bool_find_next(std::uint64_t const* const arr, int const number_of_bools, int const idx)
+{
+	if(idx >= number_of_bools)
+	{
+		return number_of_bools;
+	}
+	int i = idx / s_array_bool_word_bits;
+	std::uint64_t word = arr[i] & ~array_bool_low_mask(idx % s_array_bool_word_bits);
+	int const words = array_bool_space_needed(number_of_bools);
+	for(;;)
+	{
+		if(word != 0)
+		{
+			int const ret = i * s_array_bool_word_bits + std::countr_zero(word);
+			return ret < number_of_bools ? ret : number_of_bools;
+		}
+		++i;
+		if(i == words)
+		{
+			return number_of_bools;
+		}
+		word = arr[i];
+	}
 }
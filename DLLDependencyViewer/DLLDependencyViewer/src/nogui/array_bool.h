@@ -1,7 +1,13 @@
 #pragma once
 
 
+#include <cstdint>
+
+
 int array_bool_space_needed(int const number_of_bools);
-void array_bool_set(unsigned* const arr, int const idx);
-void array_bool_clr(unsigned* const arr, int const idx);
-bool array_bool_tst(unsigned const* const arr, int const idx);
+void array_bool_set(std::uint64_t* const arr, int const idx);
+void array_bool_clr(std::uint64_t* const arr, int const idx);
+bool array_bool_tst(std::uint64_t const* const arr, int const idx);
+void array_bool_set_bits(std::uint64_t* const arr, int const idx, std::uint64_t const bits, int const count);
+int array_bool_count(std::uint64_t const* const arr, int const number_of_bools);
+int array_bool_find_next(std::uint64_t const* const arr, int const number_of_bools, int const idx);
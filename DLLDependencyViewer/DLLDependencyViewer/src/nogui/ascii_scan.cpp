@@ -0,0 +1,267 @@
+#include "ascii_scan.h"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include <immintrin.h>
+#include <intrin.h>
+
+
+static constexpr char const s_ascii_printable_min = 32;
+static constexpr char const s_ascii_printable_max = 126;
+
+
+static ascii_isa ascii_detect_isa()
+{
+	int regs[4];
+	__cpuid(regs, 0);
+	int const max_leaf = regs[0];
+	if(max_leaf < 1)
+	{
+		return ascii_isa::scalar;
+	}
+	__cpuid(regs, 1);
+	bool const has_sse2 = (regs[3] & (1 << 26)) != 0;
+	bool const has_osxsave = (regs[2] & (1 << 27)) != 0;
+	bool const has_avx = (regs[2] & (1 << 28)) != 0;
+	if(!has_sse2)
+	{
+		return ascii_isa::scalar;
+	}
+	if(!has_osxsave || !has_avx || max_leaf < 7)
+	{
+		return ascii_isa::sse2;
+	}
+	bool const has_ymm_state = (_xgetbv(0) & 0x6) == 0x6;
+	if(!has_ymm_state)
+	{
+		return ascii_isa::sse2;
+	}
+	__cpuidex(regs, 7, 0);
+	bool const has_avx2 = (regs[1] & (1 << 5)) != 0;
+	return has_avx2 ? ascii_isa::avx2 : ascii_isa::sse2;
+}
+
+static bool ascii_is_printable_scalar(char const ch)
+{
+	return ch >= s_ascii_printable_min && ch <= s_ascii_printable_max;
+}
+
+static bool ascii_is_printable_8_scalar(char const* const str, int const len)
+{
+	for(int i = 0; i != len; ++i)
+	{
+		if(!ascii_is_printable_scalar(str[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool ascii_scan_z_scalar(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	void const* const nul = std::memchr(str, '\0', max_len);
+	if(!nul)
+	{
+		return false;
+	}
+	int const len = static_cast<int>(static_cast<char const*>(nul) - str);
+	*len_out = len;
+	*is_printable_out = ascii_is_printable_8_scalar(str, len);
+	return true;
+}
+
+static bool ascii_scan_z_sse2(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	// Aligned loads never cross a page boundary, so reading the whole block containing the first and the last byte is safe.
+	__m128i const zero = _mm_setzero_si128();
+	__m128i const lo = _mm_set1_epi8(s_ascii_printable_min);
+	__m128i const hi = _mm_set1_epi8(s_ascii_printable_max);
+	int const misalignment = static_cast<int>(reinterpret_cast<std::uintptr_t>(str) & 0xF);
+	std::uintptr_t const end = reinterpret_cast<std::uintptr_t>(str) + max_len;
+	std::uintptr_t block = reinterpret_cast<std::uintptr_t>(str) - misalignment;
+	unsigned valid_mask = 0xFFFFu << misalignment;
+	unsigned bad_seen = 0;
+	for(; block < end; block += 16, valid_mask = 0xFFFFu)
+	{
+		__m128i const v = _mm_load_si128(reinterpret_cast<__m128i const*>(block));
+		unsigned const nul = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero))) & valid_mask;
+		unsigned const bad = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi8(v, lo), _mm_cmpgt_epi8(v, hi)))) & valid_mask;
+		if(nul != 0)
+		{
+			int const pos = std::countr_zero(nul);
+			int const len = static_cast<int>(block - reinterpret_cast<std::uintptr_t>(str)) + pos;
+			if(len >= max_len)
+			{
+				return false;
+			}
+			*len_out = len;
+			*is_printable_out = bad_seen == 0 && (bad & ((1u << pos) - 1u)) == 0;
+			return true;
+		}
+		bad_seen |= bad;
+	}
+	return false;
+}
+
+static bool ascii_scan_z_avx2(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	__m256i const zero = _mm256_setzero_si256();
+	__m256i const lo = _mm256_set1_epi8(s_ascii_printable_min);
+	__m256i const hi = _mm256_set1_epi8(s_ascii_printable_max);
+	int const misalignment = static_cast<int>(reinterpret_cast<std::uintptr_t>(str) & 0x1F);
+	std::uintptr_t const end = reinterpret_cast<std::uintptr_t>(str) + max_len;
+	std::uintptr_t block = reinterpret_cast<std::uintptr_t>(str) - misalignment;
+	unsigned valid_mask = 0xFFFF'FFFFu << misalignment;
+	unsigned bad_seen = 0;
+	for(; block < end; block += 32, valid_mask = 0xFFFF'FFFFu)
+	{
+		__m256i const v = _mm256_load_si256(reinterpret_cast<__m256i const*>(block));
+		unsigned const nul = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero))) & valid_mask;
+		unsigned const bad = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpgt_epi8(lo, v), _mm256_cmpgt_epi8(v, hi)))) & valid_mask;
+		if(nul != 0)
+		{
+			int const pos = std::countr_zero(nul);
+			int const len = static_cast<int>(block - reinterpret_cast<std::uintptr_t>(str)) + pos;
+			if(len >= max_len)
+			{
+				return false;
+			}
+			*len_out = len;
+			*is_printable_out = bad_seen == 0 && (bad & ((1u << pos) - 1u)) == 0;
+			return true;
+		}
+		bad_seen |= bad;
+	}
+	return false;
+}
+
+static bool ascii_is_printable_8_sse2(char const* const str, int const len)
+{
+	__m128i const lo = _mm_set1_epi8(s_ascii_printable_min);
+	__m128i const hi = _mm_set1_epi8(s_ascii_printable_max);
+	__m128i bad = _mm_setzero_si128();
+	int i = 0;
+	for(; i + 16 <= len; i += 16)
+	{
+		__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i));
+		bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi8(v, lo), _mm_cmpgt_epi8(v, hi)));
+	}
+	return _mm_movemask_epi8(bad) == 0 && ascii_is_printable_8_scalar(str + i, len - i);
+}
+
+static bool ascii_is_printable_8_avx2(char const* const str, int const len)
+{
+	__m256i const lo = _mm256_set1_epi8(s_ascii_printable_min);
+	__m256i const hi = _mm256_set1_epi8(s_ascii_printable_max);
+	__m256i bad = _mm256_setzero_si256();
+	int i = 0;
+	for(; i + 32 <= len; i += 32)
+	{
+		__m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(str + i));
+		bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi8(lo, v), _mm256_cmpgt_epi8(v, hi)));
+	}
+	return _mm256_movemask_epi8(bad) == 0 && ascii_is_printable_8_sse2(str + i, len - i);
+}
+
+static bool ascii_is_printable_16_scalar(std::uint16_t const* const str, int const len)
+{
+	for(int i = 0; i != len; ++i)
+	{
+		if(!(str[i] >= s_ascii_printable_min && str[i] <= s_ascii_printable_max))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool ascii_is_printable_16_sse2(std::uint16_t const* const str, int const len)
+{
+	// Unsigned saturation maps every code unit above 0xFF to 0xFF and every code unit above 0x7FFF to 0x00, both of which are rejected.
+	__m128i const lo = _mm_set1_epi8(s_ascii_printable_min);
+	__m128i const hi = _mm_set1_epi8(s_ascii_printable_max);
+	__m128i bad = _mm_setzero_si128();
+	int i = 0;
+	for(; i + 16 <= len; i += 16)
+	{
+		__m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i + 0));
+		__m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i + 8));
+		__m128i const v = _mm_packus_epi16(a, b);
+		bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi8(v, lo), _mm_cmpgt_epi8(v, hi)));
+	}
+	return _mm_movemask_epi8(bad) == 0 && ascii_is_printable_16_scalar(str + i, len - i);
+}
+
+static ascii_isa ascii_get_isa()
+{
+	static ascii_isa const s_isa = ascii_detect_isa();
+	return s_isa;
+}
+
+
+ascii_isa ascii_get_best_isa()
+{
+	return ascii_get_isa();
+}
+
+bool ascii_scan_z(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	return ascii_scan_z(ascii_get_isa(), str, max_len, len_out, is_printable_out);
+}
+
+bool ascii_scan_z(ascii_isa const isa, char const* const str, int const max_len, int* const len_out, bool* const is_printable_out)
+{
+	assert(str);
+	assert(len_out);
+	assert(is_printable_out);
+	if(max_len <= 0)
+	{
+		return false;
+	}
+	if(isa == ascii_isa::avx2)
+	{
+		return ascii_scan_z_avx2(str, max_len, len_out, is_printable_out);
+	}
+	else if(isa == ascii_isa::sse2)
+	{
+		return ascii_scan_z_sse2(str, max_len, len_out, is_printable_out);
+	}
+	else
+	{
+		return ascii_scan_z_scalar(str, max_len, len_out, is_printable_out);
+	}
+}
+
+bool ascii_is_printable(char const* const str, int const len)
+{
+	ascii_isa const isa = ascii_get_isa();
+	if(isa == ascii_isa::avx2)
+	{
+		return ascii_is_printable_8_avx2(str, len);
+	}
+	else if(isa == ascii_isa::sse2)
+	{
+		return ascii_is_printable_8_sse2(str, len);
+	}
+	else
+	{
+		return ascii_is_printable_8_scalar(str, len);
+	}
+}
+
+bool ascii_is_printable(std::uint16_t const* const str, int const len)
+{
+	ascii_isa const isa = ascii_get_isa();
+	if(isa == ascii_isa::scalar)
+	{
+		return ascii_is_printable_16_scalar(str, len);
+	}
+	else
+	{
+		return ascii_is_printable_16_sse2(str, len);
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+
+#include <cstdint>
+
+
+enum class ascii_isa
+{
+	scalar,
+	sse2,
+	avx2,
+};
+
+
+ascii_isa ascii_get_best_isa();
+bool ascii_scan_z(char const* const str, int const max_len, int* const len_out, bool* const is_printable_out);
+bool ascii_scan_z(ascii_isa const isa, char const* const str, int const max_len, int* const len_out, bool* const is_printable_out);
+bool ascii_is_printable(char const* const str, int const len);
+bool ascii_is_printable(std::uint16_t const* const str, int const len);
@@ -81,8 +81,8 @@ void dbg_provider::get_symbols_from_addresses_task(symbols_from_addresses_param_
 		assert(unloaded != FALSE);
 	});
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
 		DWORD64 displacement;
 		union symbol_info_t
@@ -111,10 +111,10 @@ void dbg_provider::get_undecorated_from_decorated_e_task(undecorated_from_decora
 		return;
 	}
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		std::uint16_t const idx = param.m_indexes[i];
+		std::uint32_t const idx = param.m_indexes[i];
 		string_handle const& name = param.m_eti->m_names[idx];
 		std::array<char, 8 * 1024> buff;
 		DWORD const undecorated = m_dbghelp.m_fn_UnDecorateSymbolName(cbegin(name), buff.data(), static_cast<int>(buff.size()), UNDNAME_COMPLETE);
@@ -132,10 +132,10 @@ void dbg_provider::get_undecorated_from_decorated_i_task(undecorated_from_decora
 		return;
 	}
 	assert(param.m_indexes.size() == param.m_strings.size());
-	std::uint16_t const n = static_cast<std::uint16_t>(param.m_indexes.size());
-	for(std::uint16_t i = 0; i != n; ++i)
+	std::uint32_t const n = static_cast<std::uint32_t>(param.m_indexes.size());
+	for(std::uint32_t i = 0; i != n; ++i)
 	{
-		std::uint16_t const idx = param.m_indexes[i];
+		std::uint32_t const idx = param.m_indexes[i];
 		string_handle const& name = param.m_iti->m_names[param.m_dll_idx][idx];
 		std::array<char, 8 * 1024> buff;
 		DWORD const undecorated = m_dbghelp.m_fn_UnDecorateSymbolName(cbegin(name), buff.data(), static_cast<int>(buff.size()), UNDNAME_COMPLETE);
@@ -13,25 +13,25 @@
 struct symbols_from_addresses_param_t
 {
 	wstring_handle m_module_path;
-	pe_export_table_info* m_eti;
-	std::vector<std::uint16_t> m_indexes;
+	pe_export_table_info_32* m_eti;
+	std::vector<std::uint32_t> m_indexes;
 	std::vector<std::string> m_strings;
 	void* m_data;
 };
 
 struct undecorated_from_decorated_e_param_t
 {
-	pe_export_table_info const* m_eti;
-	std::vector<std::uint16_t> m_indexes;
+	pe_export_table_info_32 const* m_eti;
+	std::vector<std::uint32_t> m_indexes;
 	std::vector<std::string> m_strings;
 	void* m_data;
 };
 
 struct undecorated_from_decorated_i_param_t
 {
-	pe_import_table_info const* m_iti;
-	std::uint16_t m_dll_idx;
-	std::vector<std::uint16_t> m_indexes;
+	pe_import_table_info_32 const* m_iti;
+	std::uint32_t m_dll_idx;
+	std::vector<std::uint32_t> m_indexes;
 	std::vector<std::string> m_strings;
 	void* m_data;
 };
@@ -1,15 +1,32 @@
 #include "dependency_locator.h"
 
 #include "known_dlls.h"
+#include "pe_triage.h"
 #include "unicode.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <iterator>
 
 #include "my_windows.h"
 
 
+static constexpr std::uint16_t const s_machine_i386 = 0x014c;
+static constexpr std::uint16_t const s_machine_amd64 = 0x8664;
+static constexpr std::uint16_t const s_machine_arm64 = 0xaa64;
+static constexpr std::uint16_t const s_machine_arm64ec = 0xa641;
+static constexpr std::uint16_t const s_machine_arm64x = 0xa64e;
+#ifdef _M_IX86
+static constexpr wchar_t const s_sysnative_folder_name[] = LR"---(\Sysnative)---";
+#endif
+
+
+bool is_importer_32_bit(dependency_locator const& self);
+UINT get_importer_system_directory(dependency_locator const& self, wchar_t* const buff, UINT const size);
+bool is_machine_compatible(std::uint16_t const importer, std::uint16_t const candidate);
+
+
 bool locate_dependency(dependency_locator& self)
 {
 	if(locate_dependency_sxs(self)) return true;
@@ -37,7 +54,8 @@ bool locate_dependency_known_dlls(dependency_locator& self)
 	std::transform(begin(dependency), end(dependency), begin(tmpn), [](auto const& e){ return to_lowercase(e); });
 	string const dll_name_s{tmpn.c_str(), static_cast<int>(tmpn.size())};
 	string_handle const dll_name_sh{&dll_name_s};
-	std::vector<std::string> const& known_dll_names = get_known_dll_names_sorted_lowercase_ascii();
+	bool const is_32_bit = is_importer_32_bit(self);
+	std::vector<std::string> const& known_dll_names = get_known_dll_names_sorted_lowercase_ascii(is_32_bit);
 	auto const it = std::lower_bound(known_dll_names.begin(), known_dll_names.end(), dll_name_sh, [](auto const& e, auto const& v){ string const e_s{e.c_str(), static_cast<int>(e.size())}; return string_handle{&e_s} < v; });
 	if(it == known_dll_names.end())
 	{
@@ -48,7 +66,13 @@ bool locate_dependency_known_dlls(dependency_locator& self)
 	{
 		return false;
 	}
-	self.m_result = std::filesystem::path{get_knonw_dlls_path()}.append(*it);
+	std::filesystem::path& tmp_path = self.m_tmp_path;
+	tmp_path.assign(get_knonw_dlls_path(is_32_bit)).append(*it);
+	if(!locate_dependency_accept(self, tmp_path))
+	{
+		return false;
+	}
+	self.m_result = tmp_path;
 	return true;
 }
 
@@ -58,7 +82,7 @@ bool locate_dependency_application_dir(dependency_locator& self)
 	string_handle const& dependency = *self.m_dependency;
 	std::filesystem::path& tmp_path = self.m_tmp_path;
 	tmp_path.assign(begin(main_path), end(main_path)).replace_filename({begin(dependency), end(dependency)});
-	if(!std::filesystem::exists(tmp_path))
+	if(!locate_dependency_accept(self, tmp_path))
 	{
 		return false;
 	}
@@ -71,11 +95,11 @@ bool locate_dependency_system32(dependency_locator& self)
 	string_handle const& dependency = *self.m_dependency;
 	std::filesystem::path& tmp_path = self.m_tmp_path;
 	std::array<wchar_t, 32 * 1024> buff;
-	UINT const got_sys = GetSystemDirectoryW(buff.data(), static_cast<UINT>(buff.size()));
+	UINT const got_sys = get_importer_system_directory(self, buff.data(), static_cast<UINT>(buff.size()));
 	assert(got_sys != 0);
 	assert(got_sys < static_cast<UINT>(buff.size()));
-	tmp_path.assign(buff.data(), buff.data() + got_sys).replace_filename({begin(dependency), end(dependency)});
-	if(!std::filesystem::exists(tmp_path))
+	tmp_path.assign(buff.data(), buff.data() + got_sys).append(begin(dependency), end(dependency));
+	if(!locate_dependency_accept(self, tmp_path))
 	{
 		return false;
 	}
@@ -97,8 +121,8 @@ bool locate_dependency_windows(dependency_locator& self)
 	UINT const got_win = GetWindowsDirectoryW(buff.data(), static_cast<UINT>(buff.size()));
 	assert(got_win != 0);
 	assert(got_win < static_cast<UINT>(buff.size()));
-	tmp_path.assign(buff.data(), buff.data() + got_win).replace_filename({begin(dependency), end(dependency)});
-	if(!std::filesystem::exists(tmp_path))
+	tmp_path.assign(buff.data(), buff.data() + got_win).append(begin(dependency), end(dependency));
+	if(!locate_dependency_accept(self, tmp_path))
 	{
 		return false;
 	}
@@ -114,8 +138,8 @@ bool locate_dependency_current_dir(dependency_locator& self)
 	DWORD const got_currdir = GetCurrentDirectoryW(static_cast<DWORD>(buff.size()), buff.data());
 	assert(got_currdir != 0);
 	assert(got_currdir < static_cast<DWORD>(buff.size()));
-	tmp_path.assign(buff.data(), buff.data() + got_currdir).replace_filename({begin(dependency), end(dependency)});
-	if(!std::filesystem::exists(tmp_path))
+	tmp_path.assign(buff.data(), buff.data() + got_currdir).append(begin(dependency), end(dependency));
+	if(!locate_dependency_accept(self, tmp_path))
 	{
 		return false;
 	}
@@ -137,7 +161,7 @@ bool locate_dependency_environment_path(dependency_locator& self)
 	{
 		auto const it = std::find(start, buff_end, L';');
 		tmp_path.assign(start, it).append(begin(dependency), end(dependency));
-		if(std::filesystem::exists(tmp_path))
+		if(locate_dependency_accept(self, tmp_path))
 		{
 			self.m_result = tmp_path;
 			return true;
@@ -150,3 +174,81 @@ bool locate_dependency_environment_path(dependency_locator& self)
 	}
 	return false;
 }
+
+bool locate_dependency_accept(dependency_locator& self, std::filesystem::path const& path)
+{
+	if(self.m_machine == 0)
+	{
+		return std::filesystem::exists(path);
+	}
+	auto it = self.m_machines.find(path.native());
+	if(it == self.m_machines.end())
+	{
+		pe_triage_info info;
+		bool const triaged = pe_triage_file(path.c_str(), &info);
+		std::uint16_t const machine = !triaged ? std::uint16_t{0} : info.m_is_hybrid ? s_machine_arm64x : info.m_machine;
+		it = self.m_machines.emplace(path.native(), machine).first;
+	}
+	return is_machine_compatible(self.m_machine, it->second);
+}
+
+
+bool is_importer_32_bit(dependency_locator const& self)
+{
+	return self.m_machine == s_machine_i386;
+}
+
+UINT get_importer_system_directory(dependency_locator const& self, wchar_t* const buff, UINT const size)
+{
+	if(is_importer_32_bit(self))
+	{
+		// SysWOW64 on 64-bit Windows, there is no such directory on 32-bit Windows.
+		UINT const got_wow = GetSystemWow64DirectoryW(buff, size);
+		if(got_wow != 0)
+		{
+			return got_wow;
+		}
+		return GetSystemDirectoryW(buff, size);
+	}
+	#if defined _M_IX86
+	if(self.m_machine != 0 && is_wow64())
+	{
+		// System32 is redirected to SysWOW64 for this process, Sysnative is the real one.
+		UINT const got_win = GetWindowsDirectoryW(buff, size);
+		UINT const len = static_cast<UINT>(std::size(s_sysnative_folder_name));
+		if(got_win == 0 || got_win + len > size)
+		{
+			return 0;
+		}
+		std::copy(std::cbegin(s_sysnative_folder_name), std::cend(s_sysnative_folder_name), buff + got_win);
+		return got_win + len - 1;
+	}
+	#elif defined _M_X64
+	#else
+		#error Unknown architecture.
+	#endif
+	return GetSystemDirectoryW(buff, size);
+}
+
+bool is_machine_compatible(std::uint16_t const importer, std::uint16_t const candidate)
+{
+	if(candidate == importer)
+	{
+		return true;
+	}
+	switch(importer)
+	{
+		case s_machine_amd64:
+		case s_machine_arm64ec:
+		{
+			return candidate == s_machine_amd64 || candidate == s_machine_arm64ec || candidate == s_machine_arm64x;
+		}
+		break;
+		case s_machine_arm64:
+		{
+			return candidate == s_machine_arm64x;
+		}
+		break;
+	}
+	return false;
+}
@@ -3,17 +3,21 @@
 
 #include "my_string_handle.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <unordered_map>
 
 
 struct dependency_locator
 {
 	wstring_handle m_main_path;
 	string_handle const* m_dependency;
+	std::uint16_t m_machine;
 	std::wstring m_result;
 	std::string m_tmpn;
 	std::filesystem::path m_tmp_path;
+	std::unordered_map<std::wstring, std::uint16_t> m_machines;
 };
 
 
@@ -27,3 +31,4 @@ bool locate_dependency_system16(dependency_locator& self);
 bool locate_dependency_windows(dependency_locator& self);
 bool locate_dependency_current_dir(dependency_locator& self);
 bool locate_dependency_environment_path(dependency_locator& self);
+bool locate_dependency_accept(dependency_locator& self, std::filesystem::path const& path);
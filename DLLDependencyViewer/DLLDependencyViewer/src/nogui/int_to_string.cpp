@@ -7,7 +7,7 @@
 #include <cwchar>
 
 
-wchar_t const* ordinal_to_string(std::uint16_t const ordinal, string_converter& converter)
+wchar_t const* ordinal_to_string(std::uint32_t const ordinal, string_converter& converter)
 {
 	std::wstring& tmpstr = converter.m_strings[converter.m_index++ % converter.m_strings.size()];
 	ordinal_to_string(ordinal, tmpstr);
@@ -21,11 +21,11 @@ wchar_t const* rva_to_string(std::uint32_t const rva, string_converter& converte
 	return tmpstr.c_str();
 }
 
-void ordinal_to_string(std::uint16_t const ordinal, std::wstring& str)
+void ordinal_to_string(std::uint32_t const ordinal, std::wstring& str)
 {
-	static_assert(sizeof(ordinal) == sizeof(unsigned short int), "");
-	std::array<wchar_t, 15> buff;
-	int const formatted = std::swprintf(buff.data(), buff.size(), L"%hu (0x%04hx)", static_cast<unsigned short int>(ordinal), static_cast<unsigned short int>(ordinal));
+	static_assert(sizeof(ordinal) == sizeof(unsigned int), "");
+	std::array<wchar_t, 24> buff;
+	int const formatted = std::swprintf(buff.data(), buff.size(), L"%u (0x%04x)", static_cast<unsigned int>(ordinal), static_cast<unsigned int>(ordinal));
 	assert(formatted >= 0);
 	str.assign(buff.data(), buff.data() + formatted);
 }
@@ -6,6 +6,7 @@
 #include "unicode.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -25,17 +26,33 @@
 
 
 static constexpr wchar_t const s_known_dlls_folder_name[] = LR"---(\KnownDlls)---";
-#ifdef _M_IX86
 static constexpr wchar_t const s_known_dlls_folder_name32[] = LR"---(\KnownDlls32)---";
+#ifdef _M_IX86
+static constexpr wchar_t const s_sysnative_folder_name[] = LR"---(\Sysnative)---";
 #endif
 static constexpr wchar_t const s_directory_item_type_name_section[] = L"Section";
 static constexpr wchar_t const s_directory_item_type_name_symlink[] = L"SymbolicLink";
 static constexpr wchar_t const s_known_dlls_symlink_name[] = L"KnownDllPath";
 
 
-static std::wstring* g_known_dll_path = nullptr;
-static std::vector<std::wstring>* g_known_dll_names = nullptr;
-static std::vector<std::string>* g_known_dll_names_sorted_lowercase_ascii = nullptr;
+struct known_dlls_t
+{
+	std::wstring m_path;
+	std::vector<std::wstring> m_names;
+	std::vector<std::string> m_names_sorted_lowercase_ascii;
+};
+
+struct nt_directory_fns_t
+{
+	decltype(&NtOpenDirectoryObject) m_open_directory;
+	decltype(&NtQueryDirectoryObject) m_query_directory;
+	decltype(&NtOpenSymbolicLinkObject) m_open_symlink;
+	decltype(&NtQuerySymbolicLinkObject) m_query_symlink;
+};
+
+
+static known_dlls_t* g_known_dlls = nullptr;
+static known_dlls_t* g_known_dlls_32 = nullptr;
 
 
 struct buffer_t
@@ -49,9 +66,7 @@ struct buffer_t
 };
 
 
-#ifdef _M_IX86
-bool is_wow64();
-#endif
+bool read_known_dlls(nt_directory_fns_t const& fns, wchar_t const* const folder_name, int const folder_name_len, known_dlls_t* const known_dlls_out);
 bool is_section(OBJECT_DIRECTORY_INFORMATION const& odi);
 bool is_symlink(OBJECT_DIRECTORY_INFORMATION const& odi);
 bool is_known_dll_path(OBJECT_DIRECTORY_INFORMATION const& odi);
@@ -59,17 +74,12 @@ bool is_known_dll_path(OBJECT_DIRECTORY_INFORMATION const& odi);
 
 bool init_known_dlls()
 {
-	std::wstring known_dll_path;
-	std::vector<std::wstring> known_dll_names;
-	std::vector<std::string> known_dll_names_sorted_lowercase_ascii;
 	auto fn_if_failure = mk::make_scope_exit([]()
 	{
-		assert(!g_known_dll_path);
-		assert(!g_known_dll_names);
-		assert(!g_known_dll_names_sorted_lowercase_ascii);
-		g_known_dll_path = new std::wstring{};
-		g_known_dll_names = new std::vector<std::wstring>{};
-		g_known_dll_names_sorted_lowercase_ascii = new std::vector<std::string>{};
+		assert(!g_known_dlls);
+		assert(!g_known_dlls_32);
+		g_known_dlls = new known_dlls_t{};
+		g_known_dlls_32 = new known_dlls_t{};
 	});
 
 	HMODULE const ntdll = GetModuleHandleW(L"ntdll.dll");
@@ -77,36 +87,114 @@ bool init_known_dlls()
 
 	auto const NtOpenDirectoryObject_proc = GetProcAddress(ntdll, "NtOpenDirectoryObject");
 	WARN_M_R(NtOpenDirectoryObject_proc != 0, L"NtOpenDirectoryObject not found inside ntdll.dll.", false);
-	auto const NtOpenDirectoryObject_fn = reinterpret_cast<decltype(&NtOpenDirectoryObject)>(NtOpenDirectoryObject_proc);
 
 	auto const NtQueryDirectoryObject_proc = GetProcAddress(ntdll, "NtQueryDirectoryObject");
 	WARN_M_R(NtQueryDirectoryObject_proc != 0, L"NtQueryDirectoryObject not found inside ntdll.dll.", false);
-	auto const NtQueryDirectoryObject_fn = reinterpret_cast<decltype(&NtQueryDirectoryObject)>(NtQueryDirectoryObject_proc);
 
 	auto const NtOpenSymbolicLinkObject_proc = GetProcAddress(ntdll, "NtOpenSymbolicLinkObject");
 	WARN_M_R(NtOpenSymbolicLinkObject_proc != 0, L"NtOpenSymbolicLinkObject not found inside ntdll.dll.", false);
-	auto const NtOpenSymbolicLinkObject_fn = reinterpret_cast<decltype(&NtOpenSymbolicLinkObject)>(NtOpenSymbolicLinkObject_proc);
 
 	auto const NtQuerySymbolicLinkObject_proc = GetProcAddress(ntdll, "NtQuerySymbolicLinkObject");
 	WARN_M_R(NtQuerySymbolicLinkObject_proc != 0, L"NtQuerySymbolicLinkObject not found inside ntdll.dll.", false);
-	auto const NtQuerySymbolicLinkObject_fn = reinterpret_cast<decltype(&NtQuerySymbolicLinkObject)>(NtQuerySymbolicLinkObject_proc);
+
+	nt_directory_fns_t fns;
+	fns.m_open_directory = reinterpret_cast<decltype(&NtOpenDirectoryObject)>(NtOpenDirectoryObject_proc);
+	fns.m_query_directory = reinterpret_cast<decltype(&NtQueryDirectoryObject)>(NtQueryDirectoryObject_proc);
+	fns.m_open_symlink = reinterpret_cast<decltype(&NtOpenSymbolicLinkObject)>(NtOpenSymbolicLinkObject_proc);
+	fns.m_query_symlink = reinterpret_cast<decltype(&NtQuerySymbolicLinkObject)>(NtQuerySymbolicLinkObject_proc);
 
 	#if defined _M_IX86
-	bool const iswow64 = is_wow64();
-	auto const& known_dlls_folder_name = iswow64 ? s_known_dlls_folder_name32 : s_known_dlls_folder_name;
-	int const known_dlls_folder_name_len = static_cast<int>(iswow64 ? std::size(s_known_dlls_folder_name32) : std::size(s_known_dlls_folder_name)) - 1;
+	bool const os_is_64_bit = is_wow64();
 	#elif defined _M_X64
-	auto const& known_dlls_folder_name = s_known_dlls_folder_name;
-	int const known_dlls_folder_name_len = static_cast<int>(std::size(s_known_dlls_folder_name)) - 1;
+	bool const os_is_64_bit = true;
 	#else
 		#error Unknown architecture.
 	#endif
 
+	// \KnownDlls holds the native DLLs, \KnownDlls32 the WOW64 ones and exists only on 64-bit Windows.
+	known_dlls_t known_dlls;
+	bool const read = read_known_dlls(fns, s_known_dlls_folder_name, static_cast<int>(std::size(s_known_dlls_folder_name)) - 1, &known_dlls);
+	WARN_M_R(read, L"Failed to read_known_dlls.", false);
+	known_dlls_t known_dlls_32;
+	if(os_is_64_bit)
+	{
+		bool const read_32 = read_known_dlls(fns, s_known_dlls_folder_name32, static_cast<int>(std::size(s_known_dlls_folder_name32)) - 1, &known_dlls_32);
+		WARN_M_R(read_32, L"Failed to read_known_dlls.", false);
+	}
+
+	#if defined _M_IX86
+	if(os_is_64_bit)
+	{
+		// The native KnownDllPath is System32, which the file system redirects to SysWOW64 for this process.
+		std::array<wchar_t, 32 * 1024> buff;
+		UINT const got_win = GetWindowsDirectoryW(buff.data(), static_cast<UINT>(buff.size()));
+		WARN_M_R(got_win != 0 && got_win < static_cast<UINT>(buff.size()), L"Failed to GetWindowsDirectoryW.", false);
+		known_dlls.m_path.assign(buff.data(), got_win).append(s_sysnative_folder_name);
+	}
+	#elif defined _M_X64
+	#else
+		#error Unknown architecture.
+	#endif
+
+	fn_if_failure.reset();
+	assert(!g_known_dlls);
+	assert(!g_known_dlls_32);
+	g_known_dlls = new known_dlls_t{std::move(known_dlls)};
+	g_known_dlls_32 = new known_dlls_t{std::move(known_dlls_32)};
+	return true;
+}
+
+void deinit_known_dlls()
+{
+	assert(g_known_dlls);
+	assert(g_known_dlls_32);
+	delete g_known_dlls;
+	delete g_known_dlls_32;
+	g_known_dlls = nullptr;
+	g_known_dlls_32 = nullptr;
+}
+
+
+static known_dlls_t const& get_known_dlls(bool const is_32_bit)
+{
+	assert(g_known_dlls);
+	assert(g_known_dlls_32);
+	// On 32-bit Windows there is no \KnownDlls32 and the native list is the 32-bit one.
+	if(is_32_bit && !g_known_dlls_32->m_path.empty())
+	{
+		return *g_known_dlls_32;
+	}
+	return *g_known_dlls;
+}
+
+std::wstring const& get_knonw_dlls_path(bool const is_32_bit)
+{
+	return get_known_dlls(is_32_bit).m_path;
+}
+
+std::vector<std::wstring> const& get_known_dll_names(bool const is_32_bit)
+{
+	return get_known_dlls(is_32_bit).m_names;
+}
+
+std::vector<std::string> const& get_known_dll_names_sorted_lowercase_ascii(bool const is_32_bit)
+{
+	return get_known_dlls(is_32_bit).m_names_sorted_lowercase_ascii;
+}
+
+
+bool read_known_dlls(nt_directory_fns_t const& fns, wchar_t const* const folder_name, int const folder_name_len, known_dlls_t* const known_dlls_out)
+{
+	assert(known_dlls_out);
+	std::wstring known_dll_path;
+	std::vector<std::wstring> known_dll_names;
+	std::vector<std::string> known_dll_names_sorted_lowercase_ascii;
+
 	HANDLE knonw_dll_dir;
 	UNICODE_STRING name;
-	name.Length = static_cast<USHORT>(known_dlls_folder_name_len * sizeof(wchar_t));
+	name.Length = static_cast<USHORT>(folder_name_len * sizeof(wchar_t));
 	name.MaximumLength = name.Length;
-	name.Buffer = const_cast<wchar_t*>(known_dlls_folder_name);
+	name.Buffer = const_cast<wchar_t*>(folder_name);
 	OBJECT_ATTRIBUTES oa_1{};
 	oa_1.Length = sizeof(oa_1);
 	oa_1.RootDirectory = nullptr;
@@ -114,7 +202,7 @@ bool init_known_dlls()
 	oa_1.Attributes = 0;
 	oa_1.SecurityDescriptor = nullptr;
 	oa_1.SecurityQualityOfService = nullptr;
-	NTSTATUS const opened_1 = NtOpenDirectoryObject_fn(&knonw_dll_dir, DIRECTORY_QUERY, &oa_1);
+	NTSTATUS const opened_1 = fns.m_open_directory(&knonw_dll_dir, DIRECTORY_QUERY, &oa_1);
 	WARN_M_R(opened_1 == 0, L"NtOpenDirectoryObject failed.", false);
 	smart_handle const s_knonw_dll_dir(knonw_dll_dir);
 
@@ -125,7 +213,7 @@ bool init_known_dlls()
 		buffer_t buff_1;
 		ULONG context;
 		ULONG ret_len;
-		NTSTATUS const queried_1 = NtQueryDirectoryObject_fn(knonw_dll_dir, &buff_1, sizeof(buff_1), TRUE, restart, &context, &ret_len);
+		NTSTATUS const queried_1 = fns.m_query_directory(knonw_dll_dir, &buff_1, sizeof(buff_1), TRUE, restart, &context, &ret_len);
 		restart = FALSE;
 		WARN_M_R(queried_1 == 0 || queried_1 == STATUS_NO_MORE_ENTRIES, L"NtQueryDirectoryObject failed.", false);
 		if(queried_1 == STATUS_NO_MORE_ENTRIES)
@@ -148,7 +236,7 @@ bool init_known_dlls()
 			oa_2.Attributes = 0;
 			oa_2.SecurityDescriptor = nullptr;
 			oa_2.SecurityQualityOfService = nullptr;
-			NTSTATUS const opened_2 = NtOpenSymbolicLinkObject_fn(&symlink, GENERIC_READ, &oa_2);
+			NTSTATUS const opened_2 = fns.m_open_symlink(&symlink, GENERIC_READ, &oa_2);
 			WARN_M_R(opened_2 == 0, L"NtOpenSymbolicLinkObject failed.", false);
 			smart_handle const s_symlink(symlink);
 			wchar_t buff_2[1 * 1024];
@@ -157,7 +245,7 @@ bool init_known_dlls()
 			target.MaximumLength = static_cast<USHORT>((std::size(buff_2) - 1) * sizeof(wchar_t));
 			target.Buffer = buff_2;
 			ULONG len;
-			NTSTATUS const queried_2 = NtQuerySymbolicLinkObject_fn(symlink, &target, &len);
+			NTSTATUS const queried_2 = fns.m_query_symlink(symlink, &target, &len);
 			WARN_M_R(queried_2 == 0, L"NtQuerySymbolicLinkObject failed.", false);
 			WARN_M_R(target.Length % 2 == 0, L"Bad string length.", false);
 			known_dll_path.assign(target.Buffer, target.Length / 2);
@@ -175,48 +263,12 @@ bool init_known_dlls()
 	});
 	std::sort(known_dll_names_sorted_lowercase_ascii.begin(), known_dll_names_sorted_lowercase_ascii.end());
 
-	fn_if_failure.reset();
-	assert(!g_known_dll_path);
-	assert(!g_known_dll_names);
-	assert(!g_known_dll_names_sorted_lowercase_ascii);
-	g_known_dll_path = new std::wstring{std::move(known_dll_path)};
-	g_known_dll_names = new std::vector<std::wstring>{std::move(known_dll_names)};
-	g_known_dll_names_sorted_lowercase_ascii = new std::vector<std::string>{std::move(known_dll_names_sorted_lowercase_ascii)};
+	known_dlls_out->m_path = std::move(known_dll_path);
+	known_dlls_out->m_names = std::move(known_dll_names);
+	known_dlls_out->m_names_sorted_lowercase_ascii = std::move(known_dll_names_sorted_lowercase_ascii);
 	return true;
 }
 
-void deinit_known_dlls()
-{
-	assert(g_known_dll_path);
-	assert(g_known_dll_names);
-	assert(g_known_dll_names_sorted_lowercase_ascii);
-	delete g_known_dll_path;
-	delete g_known_dll_names;
-	delete g_known_dll_names_sorted_lowercase_ascii;
-	g_known_dll_path = nullptr;
-	g_known_dll_names = nullptr;
-	g_known_dll_names_sorted_lowercase_ascii = nullptr;
-}
-
-
-std::wstring const& get_knonw_dlls_path()
-{
-	assert(g_known_dll_path);
-	return *g_known_dll_path;
-}
-
-std::vector<std::wstring> const& get_known_dll_names()
-{
-	assert(g_known_dll_names);
-	return *g_known_dll_names;
-}
-
-std::vector<std::string> const& get_known_dll_names_sorted_lowercase_ascii()
-{
-	assert(g_known_dll_names_sorted_lowercase_ascii);
-	return *g_known_dll_names_sorted_lowercase_ascii;
-}
-
 
 #if defined _M_IX86
 bool is_wow64()
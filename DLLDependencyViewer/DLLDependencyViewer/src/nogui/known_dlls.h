@@ -8,6 +8,11 @@
 bool init_known_dlls();
 void deinit_known_dlls();
 
-std::wstring const& get_knonw_dlls_path();
-std::vector<std::wstring> const& get_known_dll_names();
-std::vector<std::string> const& get_known_dll_names_sorted_lowercase_ascii();
+// The is_32_bit lists are the WOW64 ones on 64-bit Windows and the native ones on 32-bit Windows.
+std::wstring const& get_knonw_dlls_path(bool const is_32_bit);
+std::vector<std::wstring> const& get_known_dll_names(bool const is_32_bit);
+std::vector<std::string> const& get_known_dll_names_sorted_lowercase_ascii(bool const is_32_bit);
+
+#ifdef _M_IX86
+bool is_wow64();
+#endif
@@ -0,0 +1,68 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+
+void latency_histogram_init(latency_histogram* const histogram_out)
+{
+	assert(histogram_out);
+	std::memset(histogram_out, 0, sizeof(*histogram_out));
+}
+
+void latency_histogram_add(latency_histogram* const histogram_in_out, std::chrono::steady_clock::duration const duration)
+{
+	assert(histogram_in_out);
+	std::uint64_t const us = static_cast<std::uint64_t>(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+	int const bucket = std::min(static_cast<int>(std::bit_width(us)), s_latency_histogram_buckets - 1);
+	++histogram_in_out->m_count;
+	histogram_in_out->m_total_us += us;
+	histogram_in_out->m_max_us = std::max(histogram_in_out->m_max_us, us);
+	++histogram_in_out->m_buckets[bucket];
+}
+
+void latency_histogram_merge(latency_histogram* const histogram_in_out, latency_histogram const& other)
+{
+	assert(histogram_in_out);
+	histogram_in_out->m_count += other.m_count;
+	histogram_in_out->m_total_us += other.m_total_us;
+	histogram_in_out->m_max_us = std::max(histogram_in_out->m_max_us, other.m_max_us);
+	for(int i = 0; i != s_latency_histogram_buckets; ++i)
+	{
+		histogram_in_out->m_buckets[i] += other.m_buckets[i];
+	}
+}
+
+std::uint64_t latency_histogram_percentile_us(latency_histogram const& histogram, int const percent)
+{
+	assert(percent >= 0 && percent <= 100);
+	std::uint64_t const wanted = (histogram.m_count * percent + 99) / 100;
+	std::uint64_t seen = 0;
+	for(int i = 0; i != s_latency_histogram_buckets; ++i)
+	{
+		seen += histogram.m_buckets[i];
+		if(seen >= wanted && seen != 0)
+		{
+			return std::min(i == 0 ? std::uint64_t{0} : (std::uint64_t{1} << i) - 1, histogram.m_max_us);
+		}
+	}
+	return histogram.m_max_us;
+}
+
+void latency_histogram_to_string(latency_histogram const& histogram, wchar_t const* const name, std::wstring& str)
+{
+	str.append(name);
+	str.append(L": ");
+	str.append(std::to_wstring(histogram.m_count));
+	str.append(L" samples, mean ");
+	str.append(std::to_wstring(histogram.m_count == 0 ? 0 : histogram.m_total_us / histogram.m_count));
+	str.append(L" us, p50 <= ");
+	str.append(std::to_wstring(latency_histogram_percentile_us(histogram, 50)));
+	str.append(L" us, p99 <= ");
+	str.append(std::to_wstring(latency_histogram_percentile_us(histogram, 99)));
+	str.append(L" us, max ");
+	str.append(std::to_wstring(histogram.m_max_us));
+	str.append(L" us\r\n");
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+static constexpr int const s_latency_histogram_buckets = 24;
+
+
+struct latency_histogram
+{
+	std::uint64_t m_count;
+	std::uint64_t m_total_us;
+	std::uint64_t m_max_us;
+	std::uint64_t m_buckets[s_latency_histogram_buckets];
+};
+
+void latency_histogram_init(latency_histogram* const histogram_out);
+void latency_histogram_add(latency_histogram* const histogram_in_out, std::chrono::steady_clock::duration const duration);
+void latency_histogram_merge(latency_histogram* const histogram_in_out, latency_histogram const& other);
+std::uint64_t latency_histogram_percentile_us(latency_histogram const& histogram, int const percent);
+void latency_histogram_to_string(latency_histogram const& histogram, wchar_t const* const name, std::wstring& str);
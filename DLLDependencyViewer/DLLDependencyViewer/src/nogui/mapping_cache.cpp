@@ -0,0 +1,80 @@
+#include "mapping_cache.h"
+
+#include "assert.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+
+static constexpr int const s_mapping_cache_max_views = 32;
+static constexpr std::uint64_t const s_mapping_cache_max_bytes = 256ull * 1024ull * 1024ull;
+
+
+mapping_cache::mapping_cache() noexcept :
+	m_entries(),
+	m_clock(0)
+{
+}
+
+mapping_cache::mapping_cache(mapping_cache&& other) noexcept :
+	mapping_cache()
+{
+	swap(other);
+}
+
+mapping_cache& mapping_cache::operator=(mapping_cache&& other) noexcept
+{
+	swap(other);
+	return *this;
+}
+
+mapping_cache::~mapping_cache() noexcept
+{
+}
+
+void mapping_cache::swap(mapping_cache& other) noexcept
+{
+	using std::swap;
+	swap(m_entries, other.m_entries);
+	swap(m_clock, other.m_clock);
+}
+
+std::shared_ptr<memory_mapped_file> mapping_cache::get(wstring_handle const& file_path)
+{
+	assert(file_path.m_string);
+	++m_clock;
+	auto const it = std::find_if(m_entries.begin(), m_entries.end(), [&](entry const& e){ return e.m_file_path == file_path; });
+	if(it != m_entries.end())
+	{
+		it->m_last_use = m_clock;
+		return it->m_mmf;
+	}
+	std::shared_ptr<memory_mapped_file> mmf = std::make_shared<memory_mapped_file>(file_path.m_string->m_str);
+	WARN_M_R(mmf->begin() != nullptr, L"Failed to memory_mapped_file.", nullptr);
+	std::uint64_t const size = static_cast<std::uint64_t>(mmf->size());
+	evict(size);
+	m_entries.push_back({file_path, mmf, m_clock});
+	return mmf;
+}
+
+void mapping_cache::clear()
+{
+	m_entries.clear();
+}
+
+void mapping_cache::evict(std::uint64_t const incoming_bytes)
+{
+	std::uint64_t bytes = 0;
+	for(entry const& e : m_entries)
+	{
+		bytes += static_cast<std::uint64_t>(e.m_mmf->size());
+	}
+	while(!m_entries.empty() && (static_cast<int>(m_entries.size()) >= s_mapping_cache_max_views || bytes + incoming_bytes > s_mapping_cache_max_bytes))
+	{
+		auto const it = std::min_element(m_entries.begin(), m_entries.end(), [](entry const& a, entry const& b){ return a.m_last_use < b.m_last_use; });
+		bytes -= static_cast<std::uint64_t>(it->m_mmf->size());
+		*it = std::move(m_entries.back());
+		m_entries.pop_back();
+	}
+}
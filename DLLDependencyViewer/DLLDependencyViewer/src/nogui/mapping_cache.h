@@ -0,0 +1,40 @@
+#pragma once
+
+
+#include "memory_mapped_file.h"
+#include "my_string_handle.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+class mapping_cache
+{
+public:
+	mapping_cache() noexcept;
+	mapping_cache(mapping_cache const&) = delete;
+	mapping_cache(mapping_cache&& other) noexcept;
+	mapping_cache& operator=(mapping_cache const&) = delete;
+	mapping_cache& operator=(mapping_cache&& other) noexcept;
+	~mapping_cache() noexcept;
+	void swap(mapping_cache& other) noexcept;
+public:
+	// The returned mapping stays alive as long as the caller holds it, even if the cache evicts it or is cleared meanwhile.
+	std::shared_ptr<memory_mapped_file> get(wstring_handle const& file_path);
+	void clear();
+private:
+	struct entry
+	{
+		wstring_handle m_file_path;
+		std::shared_ptr<memory_mapped_file> m_mmf;
+		std::uint64_t m_last_use;
+	};
+private:
+	void evict(std::uint64_t const incoming_bytes);
+private:
+	std::vector<entry> m_entries;
+	std::uint64_t m_clock;
+};
+
+inline void swap(mapping_cache& a, mapping_cache& b) noexcept { a.swap(b); }
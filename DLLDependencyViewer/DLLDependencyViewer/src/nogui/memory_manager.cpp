@@ -1,5 +1,6 @@
 #include "memory_manager.h"
 
+#include <cassert>
 #include <utility>
 
 
@@ -33,3 +34,11 @@ void memory_manager::swap(memory_manager& other) noexcept
 	swap(m_strs, other.m_strs);
 	swap(m_wstrs, other.m_wstrs);
 }
+
+#if WANT_ALLOCATOR_STATS == 1
+void memory_manager::get_stats(allocator_stats* const stats_out) const
+{
+	assert(stats_out);
+	m_alc.get_stats(stats_out);
+}
+#endif
@@ -15,6 +15,10 @@ public:
 	memory_manager& operator=(memory_manager&& other) noexcept;
 	~memory_manager() noexcept;
 	void swap(memory_manager& other) noexcept;
+public:
+	#if WANT_ALLOCATOR_STATS == 1
+	void get_stats(allocator_stats* const stats_out) const;
+	#endif
 public:
 	allocator m_alc;
 	unique_strings m_strs;
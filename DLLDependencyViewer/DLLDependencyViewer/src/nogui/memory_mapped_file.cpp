@@ -10,7 +10,8 @@
 
 
 #define s_very_big_int (2'147'483'647)
-static constexpr int const s_max_file_size = s_very_big_int;
+static constexpr int const s_max_view_size = s_very_big_int;
+static constexpr int const s_initial_window_size = 1 * 1024 * 1024;
 
 
 void mapped_view_deleter::operator()(void const* const ptr) const
@@ -24,33 +25,35 @@ memory_mapped_file::memory_mapped_file() noexcept :
 	m_file(),
 	m_mapping(),
 	m_view(),
-	m_size()
+	m_size(),
+	m_file_size()
 {
 }
 
 memory_mapped_file::memory_mapped_file(wchar_t const* const file_name) :
 	memory_mapped_file()
 {
-	HANDLE const file = CreateFileW(file_name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	HANDLE const file = CreateFileW(file_name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
 	WARN_M_RV(file != INVALID_HANDLE_VALUE, L"Failed to CreateFileW.");
 	smart_handle s_file(file);
 	LARGE_INTEGER size;
 	BOOL const got_size = GetFileSizeEx(file, &size);
 	assert(got_size != 0);
-	WARN_M_RV(size.HighPart == 0, L"File is too big.");
-	WARN_M_RV(size.LowPart != 0, L"File is empty.");
-	WARN_M_RV(size.LowPart <= s_max_file_size, L"File is too big.");
+	WARN_M_RV(size.QuadPart != 0, L"File is empty.");
+	std::uint64_t const file_size = static_cast<std::uint64_t>(size.QuadPart);
+	int const view_size = file_size <= static_cast<std::uint64_t>(s_max_view_size) ? static_cast<int>(file_size) : s_initial_window_size;
 	HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
 	WARN_M_RV(mapping != nullptr, L"Failed to CreateFileMappingW.");
 	smart_handle s_mapping(mapping);
-	void const* const ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
-	WARN_M_RV(mapping != nullptr, L"Failed to MapViewOfFile.");
+	void const* const ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(view_size));
+	WARN_M_RV(ptr != nullptr, L"Failed to MapViewOfFile.");
 	smart_mapped_view s_view(ptr);
 
 	m_file = std::move(s_file);
 	m_mapping = std::move(s_mapping);
 	m_view = std::move(s_view);
-	m_size = static_cast<int>(size.LowPart);
+	m_size = view_size;
+	m_file_size = file_size;
 }
 
 memory_mapped_file::memory_mapped_file(memory_mapped_file&& other) noexcept :
@@ -76,6 +79,7 @@ void memory_mapped_file::swap(memory_mapped_file& other) noexcept
 	swap(m_mapping, other.m_mapping);
 	swap(m_view, other.m_view);
 	swap(m_size, other.m_size);
+	swap(m_file_size, other.m_file_size);
 }
 
 std::byte const* memory_mapped_file::begin() const
@@ -92,3 +96,29 @@ int memory_mapped_file::size() const
 {
 	return m_size;
 }
+
+std::uint64_t memory_mapped_file::file_size() const
+{
+	return m_file_size;
+}
+
+bool memory_mapped_file::is_windowed() const
+{
+	return static_cast<std::uint64_t>(m_size) != m_file_size;
+}
+
+bool memory_mapped_file::extend(std::uint64_t const size)
+{
+	assert(m_mapping);
+	std::uint64_t const new_size = std::min(size, m_file_size);
+	if(new_size <= static_cast<std::uint64_t>(m_size))
+	{
+		return true;
+	}
+	WARN_M_R(new_size <= static_cast<std::uint64_t>(s_max_view_size), L"Window is too big.", false);
+	void const* const ptr = MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(new_size));
+	WARN_M_R(ptr != nullptr, L"Failed to MapViewOfFile.", false);
+	m_view.reset(ptr);
+	m_size = static_cast<int>(new_size);
+	return true;
+}
@@ -4,6 +4,7 @@
 #include "smart_handle.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 
@@ -30,11 +31,15 @@ public:
 	std::byte const* begin() const;
 	std::byte const* end() const;
 	int size() const;
+	std::uint64_t file_size() const;
+	bool is_windowed() const;
+	bool extend(std::uint64_t const size);
 private:
 	smart_handle m_file;
 	smart_handle m_mapping;
 	smart_mapped_view m_view;
 	int m_size;
+	std::uint64_t m_file_size;
 };
 
 inline void swap(memory_mapped_file& a, memory_mapped_file& b) noexcept { a.swap(b); }
@@ -1,6 +1,6 @@
 #include "my_string.h"
 
-#include "fnv1a.h"
+#include "wyhash.h"
 
 #include <cassert>
 #include <cstdint>
@@ -8,13 +8,31 @@
 #include <cwchar>
 
 
+#if WANT_ALLOCATOR_STATS == 1
+static thread_local std::uint64_t g_string_hash_computations = 0;
+#endif
+
+
+#if WANT_ALLOCATOR_STATS == 1
+std::uint64_t string_hash_get_computations()
+{
+	return g_string_hash_computations;
+}
+#endif
+
+
 template<typename char_t>
 std::size_t basic_string_hash<char_t>::operator()(basic_string<char_t> const& obj) const
 {
-	fnv1a_state hash;
-	fnv1a_hash_init(hash);
-	fnv1a_hash_process(hash, obj.m_str, obj.m_len * sizeof(char_t));
-	return fnv1a_hash_finish(hash);
+	if(obj.m_hash != 0)
+	{
+		return obj.m_hash;
+	}
+	#if WANT_ALLOCATOR_STATS == 1
+	++g_string_hash_computations;
+	#endif
+	std::size_t const hash = static_cast<std::size_t>(wyhash(obj.m_str, obj.m_len * sizeof(char_t)));
+	return hash != 0 ? hash : 1;
 }
 
 template struct basic_string_hash<char>;
@@ -24,14 +42,11 @@ template struct basic_string_hash<wchar_t>;
 template<typename char_t>
 std::size_t basic_string_case_insensitive_hash<char_t>::operator()(basic_string<char_t> const& obj) const
 {
-	fnv1a_state hash;
-	fnv1a_hash_init(hash);
-	for(int i = 0; i != obj.m_len; ++i)
-	{
-		char_t const ch = (obj.m_str[i] | 0b0010'0000);
-		fnv1a_hash_process(hash, &ch, 1 * sizeof(char_t));
-	}
-	return fnv1a_hash_finish(hash);
+	#if WANT_ALLOCATOR_STATS == 1
+	++g_string_hash_computations;
+	#endif
+	static constexpr std::uint64_t const s_fold_mask = sizeof(char_t) == 1 ? 0x2020'2020'2020'2020uLL : sizeof(char_t) == 2 ? 0x0020'0020'0020'0020uLL : 0x0000'0020'0000'0020uLL;
+	return static_cast<std::size_t>(wyhash_folded(obj.m_str, obj.m_len * sizeof(char_t), s_fold_mask));
 }
 
 template struct basic_string_case_insensitive_hash<char>;
@@ -54,6 +69,10 @@ bool basic_string_equal<char_t>::operator()(basic_string<char_t> const& a, basic
 	{
 		return false;
 	}
+	if(a.m_hash != 0 && b.m_hash != 0 && a.m_hash != b.m_hash)
+	{
+		return false;
+	}
 	return std::memcmp(a.m_str, b.m_str, a.m_len * sizeof(char_t)) == 0;
 }
 
@@ -1,7 +1,10 @@
 #pragma once
 
 
+#include "allocator_stats.h"
+
 #include <cstddef>
+#include <cstdint>
 
 
 template<typename char_t>
@@ -18,6 +21,7 @@ public:
 public:
 	char_t const* m_str;
 	int m_len;
+	std::size_t m_hash;
 };
 
 template<typename char_t> inline char_t const* begin (basic_string<char_t> const& obj) { return obj.begin (); }
@@ -40,6 +44,10 @@ struct basic_string_hash
 typedef basic_string_hash<char> string_hash;
 typedef basic_string_hash<wchar_t> wstring_hash;
 
+#if WANT_ALLOCATOR_STATS == 1
+std::uint64_t string_hash_get_computations();
+#endif
+
 
 template<typename char_t>
 struct basic_string_case_insensitive_hash
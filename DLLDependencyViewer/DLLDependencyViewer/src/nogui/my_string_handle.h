@@ -36,8 +36,8 @@ template<typename char_t> struct basic_string_handle_case_insensitive_equal{ std
 typedef basic_string_handle_case_insensitive_equal<char> string_handle_case_insensitive_equal;
 typedef basic_string_handle_case_insensitive_equal<wchar_t> wstring_handle_case_insensitive_equal;
 
-namespace std { template<> struct hash<basic_string_handle<char>>{ std::size_t operator()(basic_string_handle<char> const& obj) const { return basic_string_hash<char>{}(*obj.m_string); } }; }
-namespace std { template<> struct hash<basic_string_handle<wchar_t>>{ std::size_t operator()(basic_string_handle<wchar_t> const& obj) const { return basic_string_hash<wchar_t>{}(*obj.m_string); } }; }
+namespace std { template<> struct hash<basic_string_handle<char>>{ std::size_t operator()(basic_string_handle<char> const& obj) const { return obj.m_string->m_hash != 0 ? obj.m_string->m_hash : basic_string_hash<char>{}(*obj.m_string); } }; }
+namespace std { template<> struct hash<basic_string_handle<wchar_t>>{ std::size_t operator()(basic_string_handle<wchar_t> const& obj) const { return obj.m_string->m_hash != 0 ? obj.m_string->m_hash : basic_string_hash<wchar_t>{}(*obj.m_string); } }; }
 
 typedef basic_string_handle<char> string_handle;
 typedef basic_string_handle<wchar_t> wstring_handle;
@@ -7,39 +7,47 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
-#include <utility>
 #include <vector>
 
 
-struct section_header;
 class memory_manager;
 
 
-struct pe_header_info
+enum class pe_parse_policy : std::uint8_t
 {
-	std::byte const* m_file_data;
-	std::uint32_t m_file_size;
-	std::uint16_t m_pe_header_start;
-	bool m_is_pe32;
-	std::uint64_t m_image_base;
-	std::uint32_t m_data_directory_count;
-	std::uint32_t m_data_directory_start;
-	std::uint32_t m_section_count;
-	std::uint32_t m_section_headers_start;
+	strict,
+	fast,
+	deferred,
 };
 
-struct pe_import_table_info
+enum class pe_validation : std::uint8_t
 {
-	std::uint16_t m_dll_count;
-	std::uint16_t m_non_delay_dll_count;
+	skipped,
+	pending,
+	passed,
+	failed,
+};
+
+
+template<typename idx_t>
+inline constexpr idx_t pe_invalid_idx_v = static_cast<idx_t>(~idx_t{0});
+
+
+template<typename idx_t>
+struct pe_import_table_info_t
+{
+	idx_t m_dll_count;
+	idx_t m_non_delay_dll_count;
 	string_handle const* m_dll_names;
-	std::uint16_t const* m_import_counts;
-	unsigned const* const* m_are_ordinals;
+	idx_t const* m_import_counts;
+	std::uint64_t const* const* m_are_ordinals;
 	std::uint16_t const* const* m_ordinals_or_hints;
 	string_handle const* const* m_names;
 	string_handle* const* m_undecorated_names;
-	std::uint16_t* const* m_matched_exports;
+	idx_t* const* m_matched_exports;
 };
+typedef pe_import_table_info_t<std::uint16_t> pe_import_table_info;
+typedef pe_import_table_info_t<std::uint32_t> pe_import_table_info_32;
 
 union pe_rva_or_forwarder
 {
@@ -47,18 +55,22 @@ union pe_rva_or_forwarder
 	string_handle m_forwarder;
 };
 
-struct pe_export_table_info
+template<typename idx_t>
+struct pe_export_table_info_t
 {
-	std::uint16_t m_count;
-	std::uint16_t m_ordinal_base;
-	std::uint16_t const* m_ordinals;
-	unsigned const* m_are_rvas;
+	idx_t m_count;
+	idx_t m_ordinal_base;
+	idx_t const* m_ordinals;
+	std::uint64_t const* m_are_rvas;
 	pe_rva_or_forwarder const* m_rvas_or_forwarders;
-	std::uint16_t const* m_hints;
+	idx_t const* m_hints;
 	string_handle* m_names;
 	string_handle* m_undecorated_names;
-	unsigned* m_are_used;
+	std::uint64_t* m_are_used;
+	pe_validation m_validation;
 };
+typedef pe_export_table_info_t<std::uint16_t> pe_export_table_info;
+typedef pe_export_table_info_t<std::uint32_t> pe_export_table_info_32;
 
 struct pe_resource_string_or_id
 {
@@ -85,8 +97,3 @@ struct pe_resources_table_info
 	std::vector<pe_resource> m_resources;
 };
 
-
-pe_header_info pe_process_header(std::byte const* const file_data, int const file_size);
-pe_resources_table_info pe_process_resource_table(std::byte const* const file_data, int const file_size, pe_header_info const& hi, memory_manager& mm);
-
-std::pair<section_header const*, std::uint32_t> convert_rva_to_disk_ptr(std::uint32_t const rva, pe_header_info const& hi, section_header const* const section = nullptr);
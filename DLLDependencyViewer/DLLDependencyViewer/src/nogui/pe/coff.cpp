@@ -83,10 +83,10 @@ static constexpr std::uint16_t s_image_file_up_system_only         	= 0x4000; //
 static constexpr std::uint16_t s_image_file_bytes_reversed_hi      	= 0x8000; // IMAGE_FILE_BYTES_REVERSED_HI      	Big endian: the MSB precedes the LSB in memory. This flag is deprecated and should be zero.
 
 
-pe_e_parse_coff_header pe_parse_coff_header(std::byte const* const file_data, int const file_size, pe_coff_header const** const header_out)
+pe_e_parse_coff_header pe_parse_coff_header(std::byte const* const file_data, std::uint64_t const file_size, pe_coff_header const** const header_out)
 {
 	pe_dos_header const& dosheader = *reinterpret_cast<pe_dos_header const*>(file_data + 0);
-	WARN_M_R(file_size >= static_cast<int>(dosheader.m_pe_offset + sizeof(pe_coff_header)), L"File is too small to contain coff_header.", pe_e_parse_coff_header::file_too_small);
+	WARN_M_R(file_size >= static_cast<std::uint64_t>(dosheader.m_pe_offset + sizeof(pe_coff_header)), L"File is too small to contain coff_header.", pe_e_parse_coff_header::file_too_small);
 	pe_coff_header const& header = *reinterpret_cast<pe_coff_header const*>(file_data + dosheader.m_pe_offset);
 	WARN_M_R(header.m_signature == s_coff_signature, L"COFF signature not found.", pe_e_parse_coff_header::file_not_coff);
 	WARN_M_R(std::find(std::cbegin(s_image_file_machines), std::cend(s_image_file_machines), header.m_machine) != std::end(s_image_file_machines), L"Unknown machine type.", pe_e_parse_coff_header::unknown_machine_type);
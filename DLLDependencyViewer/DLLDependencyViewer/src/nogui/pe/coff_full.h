@@ -82,4 +82,4 @@ enum class pe_e_directory_table
 };
 
 
-bool pe_parse_coff_full_32_64(std::byte const* const file_data, int const file_size, pe_coff_full_32_64 const** const header_out);
+bool pe_parse_coff_full_32_64(std::byte const* const file_data, std::uint64_t const mapped_size, std::uint64_t const file_size, pe_coff_full_32_64 const** const header_out);
@@ -5,6 +5,7 @@
 #include <cstdint>
 
 
+struct pe_image;
 struct pe_string;
 
 
@@ -41,7 +42,7 @@ static_assert(sizeof(pe_export_address_entry) == 0x4, "");
 struct pe_export_address_table
 {
 	pe_export_address_entry const* m_table;
-	std::uint16_t m_count;
+	std::uint32_t m_count;
 };
 
 
@@ -55,7 +56,7 @@ static_assert(sizeof(pe_export_name_pointer_entry) == 0x4, "");
 struct pe_export_name_pointer_table
 {
 	pe_export_name_pointer_entry const* m_table;
-	std::uint16_t m_count;
+	std::uint32_t m_count;
 };
 
 
@@ -70,12 +71,11 @@ bool operator==(pe_export_ordinal_entry const& a, pe_export_ordinal_entry const&
 struct pe_export_ordinal_table
 {
 	pe_export_ordinal_entry const* m_table;
-	std::uint16_t m_count;
+	std::uint32_t m_count;
 };
 
 
-bool pe_parse_export_directory_table(std::byte const* const file_data, int const file_size, pe_export_directory_table* const edt_out);
-bool pe_parse_export_name_pointer_table(std::byte const* const file_data, int const file_size, pe_export_directory_table const& edt, pe_export_name_pointer_table* const enpt_out);
-bool pe_parse_export_ordinal_table(std::byte const* const file_data, int const file_size, pe_export_directory_table const& edt, pe_export_ordinal_table* const eot_out);
-bool pe_parse_export_address_table(std::byte const* const file_data, int const file_size, pe_export_directory_table const& edt, pe_export_address_table* const eat_out);
-bool pe_parse_export_address_name(std::byte const* const file_data, int const file_size, pe_export_name_pointer_table const& enpt, pe_export_ordinal_table const& eot, std::uint16_t const& idx, std::uint16_t* const hint_out, pe_string* const ean_out);
+bool pe_parse_export_directory_table(pe_image const& img, pe_export_directory_table* const edt_out);
+bool pe_parse_export_name_pointer_table(pe_image const& img, pe_export_directory_table const& edt, pe_export_name_pointer_table* const enpt_out);
+bool pe_parse_export_ordinal_table(pe_image const& img, pe_export_directory_table const& edt, pe_export_ordinal_table* const eot_out);
+bool pe_parse_export_address_table(pe_image const& img, pe_export_directory_table const& edt, pe_export_address_table* const eat_out);
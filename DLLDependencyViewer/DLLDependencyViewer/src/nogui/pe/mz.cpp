@@ -8,7 +8,7 @@
 static constexpr std::uint16_t const s_mz_signature = 0x5a4d; // MZ
 
 
-pe_e_parse_mz_header pe_parse_mz_header(std::byte const* const file_data, int const file_size, pe_dos_header const** const header_out)
+pe_e_parse_mz_header pe_parse_mz_header(std::byte const* const file_data, std::uint64_t const file_size, pe_dos_header const** const header_out)
 {
 	assert(header_out);
 	WARN_M_R(file_size >= sizeof(pe_dos_header), L"File is too small to contain dos_header.", pe_e_parse_mz_header::file_too_small);
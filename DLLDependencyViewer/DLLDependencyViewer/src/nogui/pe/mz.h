@@ -39,4 +39,4 @@ static_assert(sizeof(pe_dos_header) == 62, "");
 static_assert(sizeof(pe_dos_header) == 0x3e, "");
 
 
-pe_e_parse_mz_header pe_parse_mz_header(std::byte const* const file_data, int const file_size, pe_dos_header const** const header_out);
+pe_e_parse_mz_header pe_parse_mz_header(std::byte const* const file_data, std::uint64_t const file_size, pe_dos_header const** const header_out);
@@ -1,56 +1,165 @@
 #include "pe_util.h"
 
+#include "../ascii_scan.h"
 #include "../assert.h"
 #include "mz.h"
 
 #include <algorithm>
+#include <cassert>
+#include <iterator>
 
 
-std::uint32_t pe_find_object_in_raw(std::byte const* const file_data, int const /* file_size */, std::uint32_t const obj_va, std::uint32_t const obj_size, pe_section_header const*& sct)
+bool pe_parse_image(std::byte const* const file_data, std::uint64_t const mapped_size, std::uint64_t const file_size, pe_image* const image_out)
 {
-	pe_dos_header const& dos_hdr = *reinterpret_cast<pe_dos_header const*>(file_data + 0);
-	pe_coff_full_32_64 const& coff_hdr = *reinterpret_cast<pe_coff_full_32_64 const*>(file_data + dos_hdr.m_pe_offset);
-	bool const is_32 = pe_is_32_bit(coff_hdr.m_32.m_standard);
-	std::uint32_t const data_dir_cnt = is_32 ? coff_hdr.m_32.m_windows.m_data_directory_count : coff_hdr.m_64.m_windows.m_data_directory_count;
-	std::uint32_t const sect_tbl_cnt = is_32 ? coff_hdr.m_32.m_coff.m_section_count : coff_hdr.m_64.m_coff.m_section_count;
-	pe_section_header const* const sect_tbl = reinterpret_cast<pe_section_header const*>(file_data + dos_hdr.m_pe_offset + (is_32 ? sizeof(pe_coff_full_32) : sizeof(pe_coff_full_64)) + data_dir_cnt * sizeof(pe_data_directory));
-	for(std::uint32_t i = 0; i != sect_tbl_cnt; ++i)
+	assert(image_out);
+	pe_dos_header const* dos_hdr;
+	pe_e_parse_mz_header const dos_parsed = pe_parse_mz_header(file_data, mapped_size, &dos_hdr);
+	WARN_M_R(dos_parsed == pe_e_parse_mz_header::ok, L"Failed to parse MZ header.", false);
+	pe_coff_full_32_64 const* coff_hdr;
+	bool const coff_parsed = pe_parse_coff_full_32_64(file_data, mapped_size, file_size, &coff_hdr);
+	WARN_M_R(coff_parsed, L"Failed to parse COFF header.", false);
+	bool const is_32 = pe_is_32_bit(coff_hdr->m_32.m_standard);
+	std::uint32_t const data_dir_cnt = is_32 ? coff_hdr->m_32.m_windows.m_data_directory_count : coff_hdr->m_64.m_windows.m_data_directory_count;
+	std::uint32_t const data_dir_offset = dos_hdr->m_pe_offset + (is_32 ? sizeof(pe_coff_full_32) : sizeof(pe_coff_full_64));
+	image_out->m_file_data = file_data;
+	image_out->m_mapped_size = mapped_size;
+	image_out->m_file_size = file_size;
+	image_out->m_dos = dos_hdr;
+	image_out->m_coff = coff_hdr;
+	image_out->m_is_32 = is_32;
+	image_out->m_image_base = is_32 ? coff_hdr->m_32.m_windows.m_image_base : coff_hdr->m_64.m_windows.m_image_base;
+	image_out->m_data_directory_count = data_dir_cnt;
+	image_out->m_data_directories = reinterpret_cast<pe_data_directory const*>(file_data + data_dir_offset);
+	image_out->m_section_count = is_32 ? coff_hdr->m_32.m_coff.m_section_count : coff_hdr->m_64.m_coff.m_section_count;
+	image_out->m_sections = reinterpret_cast<pe_section_header const*>(file_data + data_dir_offset + data_dir_cnt * sizeof(pe_data_directory));
+	image_out->m_fetched_ranges = nullptr;
+	image_out->m_fetched_range_count = 0;
+	return true;
+}
+
+pe_data_directory const* pe_find_data_directory(pe_image const& img, pe_e_directory_table const dir)
+{
+	if(!(static_cast<std::uint32_t>(dir) < img.m_data_directory_count))
+	{
+		return nullptr;
+	}
+	return img.m_data_directories + static_cast<int>(dir);
+}
+
+int pe_find_required_sections(pe_image const& img, bool const with_resources, pe_section_header const** const sections_out)
+{
+	assert(sections_out);
+	static constexpr pe_e_directory_table const s_directories[] =
+	{
+		pe_e_directory_table::export_table,
+		pe_e_directory_table::import_table,
+		pe_e_directory_table::iat,
+		pe_e_directory_table::delay_import_descriptor,
+		pe_e_directory_table::resource_table,
+	};
+	static_assert(std::size(s_directories) <= s_pe_required_sections_max);
+	int count = 0;
+	for(pe_e_directory_table const dir : s_directories)
 	{
-		pe_section_header const& sect = sect_tbl[i];
-		if(obj_va >= sect.m_virtual_address && obj_va < sect.m_virtual_address + sect.m_raw_size)
+		if(dir == pe_e_directory_table::resource_table && !with_resources)
+		{
+			continue;
+		}
+		pe_data_directory const* const data_dir = pe_find_data_directory(img, dir);
+		if(!data_dir || data_dir->m_va == 0 || data_dir->m_size == 0)
+		{
+			continue;
+		}
+		pe_section_header const* const sect_begin = img.m_sections;
+		pe_section_header const* const sect_end = img.m_sections + img.m_section_count;
+		pe_section_header const* const it = std::upper_bound(sect_begin, sect_end, data_dir->m_va, [](std::uint32_t const& va, pe_section_header const& sect){ return va < sect.m_virtual_address; });
+		if(it == sect_begin)
+		{
+			continue;
+		}
+		pe_section_header const* const sect = it - 1;
+		if(std::find(sections_out, sections_out + count, sect) != sections_out + count)
 		{
-			std::uint32_t const offset_iniside_sect = obj_va - sect.m_virtual_address;
-			std::uint32_t const obj_raw = sect.m_raw_ptr + offset_iniside_sect;
-			WARN_M_R(obj_raw + obj_size <= sect.m_raw_ptr + sect.m_raw_size, L"Object does not fin in section raw size.", 0);
-			sct = &sect;
-			return obj_raw;
+			continue;
 		}
+		sections_out[count] = sect;
+		++count;
 	}
-	WARN_M_R(false, L"Object not found in any section.", 0);
+	return count;
+}
+
+std::uint64_t pe_find_headers_size(pe_image const& img)
+{
+	return static_cast<std::uint64_t>(reinterpret_cast<std::byte const*>(img.m_sections + img.m_section_count) - img.m_file_data);
+}
+
+std::uint64_t pe_find_required_extent(pe_image const& img, bool const with_resources)
+{
+	pe_section_header const* sections[s_pe_required_sections_max];
+	int const count = pe_find_required_sections(img, with_resources, sections);
+	std::uint64_t extent = pe_find_headers_size(img);
+	for(int i = 0; i != count; ++i)
+	{
+		extent = std::max(extent, std::uint64_t{sections[i]->m_raw_ptr} + std::uint64_t{sections[i]->m_raw_size});
+	}
+	return extent;
+}
+
+bool pe_is_fetched(pe_image const& img, std::uint64_t const raw_begin, std::uint64_t const raw_end)
+{
+	if(!img.m_fetched_ranges)
+	{
+		return true;
+	}
+	pe_raw_range const* const ranges_begin = img.m_fetched_ranges;
+	pe_raw_range const* const ranges_end = img.m_fetched_ranges + img.m_fetched_range_count;
+	pe_raw_range const* const it = std::upper_bound(ranges_begin, ranges_end, raw_begin, [](std::uint64_t const& raw, pe_raw_range const& range){ return raw < range.m_begin; });
+	return it != ranges_begin && raw_end <= (it - 1)->m_end;
+}
+
+std::uint32_t pe_find_object_in_raw(pe_image const& img, std::uint32_t const obj_va, std::uint64_t const obj_size, pe_section_header const*& sct)
+{
+	pe_section_header const* const sect_begin = img.m_sections;
+	pe_section_header const* const sect_end = img.m_sections + img.m_section_count;
+	pe_section_header const* const it = std::upper_bound(sect_begin, sect_end, obj_va, [](std::uint32_t const& va, pe_section_header const& sect){ return va < sect.m_virtual_address; });
+	WARN_M_R(it != sect_begin, L"Object not found in any section.", 0);
+	pe_section_header const& sect = *(it - 1);
+	WARN_M_R(std::uint64_t{obj_va} < std::uint64_t{sect.m_virtual_address} + std::uint64_t{sect.m_raw_size}, L"Object not found in any section.", 0);
+	std::uint64_t const sect_raw_end = std::uint64_t{sect.m_raw_ptr} + std::uint64_t{sect.m_raw_size};
+	WARN_M_R(sect_raw_end <= img.m_mapped_size, L"Section is outside of mapped window.", 0);
+	WARN_M_R(pe_is_fetched(img, sect.m_raw_ptr, sect_raw_end), L"Section was not fetched.", 0);
+	std::uint32_t const offset_iniside_sect = obj_va - sect.m_virtual_address;
+	std::uint64_t const obj_raw = std::uint64_t{sect.m_raw_ptr} + std::uint64_t{offset_iniside_sect};
+	WARN_M_R(obj_size <= sect_raw_end - obj_raw, L"Object does not fin in section raw size.", 0);
+	WARN_M_R(obj_raw <= 0xFFFF'FFFFull, L"Object is outside of 32-bit file offsets.", 0);
+	sct = &sect;
+	return static_cast<std::uint32_t>(obj_raw);
 }
 
-bool pe_parse_string_rva(std::byte const* const file_data, int const file_size, std::uint32_t const str_rva, pe_string* const str_out)
+bool pe_parse_string_rva(pe_image const& img, std::uint32_t const str_rva, pe_string* const str_out)
 {
 	assert(str_out);
 	WARN_M_R(str_rva != 0, L"Invalid string.", false);
 	pe_section_header const* sct;
-	std::uint32_t const str_raw = pe_find_object_in_raw(file_data, file_size, str_rva, 2, sct);
+	std::uint32_t const str_raw = pe_find_object_in_raw(img, str_rva, 2, sct);
 	WARN_M_R(str_raw != 0, L"Could not find string in any section.", false);
-	return pe_parse_string_raw(file_data, file_size, str_raw, *sct, str_out);
+	return pe_parse_string_raw(img, str_raw, *sct, str_out);
 }
 
-bool pe_parse_string_raw(std::byte const* const file_data, int const /* file_size */, std::uint32_t const str_raw, pe_section_header const& sct, pe_string* const str_out)
+bool pe_parse_string_raw(pe_image const& img, std::uint32_t const str_raw, pe_section_header const& sct, pe_string* const str_out)
 {
 	assert(str_out);
 	WARN_M_R(str_raw != 0, L"Invalid string.", false);
-	char const* const str = reinterpret_cast<char const*>(file_data + str_raw);
+	char const* const str = reinterpret_cast<char const*>(img.m_file_data + str_raw);
 	static constexpr const std::uint32_t s_str_len_max = 32 * 1024;
-	std::uint32_t const str_len_max = std::min<std::uint32_t>(s_str_len_max, sct.m_raw_ptr + sct.m_raw_size - str_raw);
-	auto const str_end = std::find(str, str + str_len_max, '\0');
-	WARN_M_R(str_end != str + str_len_max, L"Could not find string length.", false);
-	std::uint16_t const str_len = static_cast<std::uint16_t>(str_end - str);
+	std::uint32_t const str_len_max = static_cast<std::uint32_t>(std::min<std::uint64_t>(s_str_len_max, std::uint64_t{sct.m_raw_ptr} + std::uint64_t{sct.m_raw_size} - str_raw));
+	int len;
+	bool is_printable;
+	bool const terminated = ascii_scan_z(str, static_cast<int>(str_len_max), &len, &is_printable);
+	WARN_M_R(terminated, L"Could not find string length.", false);
+	std::uint16_t const str_len = static_cast<std::uint16_t>(len);
 	WARN_M_R(str_len >= 1, L"String is too short.", false);
-	WARN_M_R(pe_is_ascii(str, str_len), L"String is not ASCII.", false);
+	WARN_M_R(is_printable, L"String is not ASCII.", false);
 	str_out->m_str = str;
 	str_out->m_len = str_len;
 	return true;
@@ -58,5 +167,5 @@ bool pe_parse_string_raw(std::byte const* const file_data, int const /* file_siz
 
 bool pe_is_ascii(char const* const& str, int const& len)
 {
-	return std::all_of(str, str + len, [](char const& e){ return e >= 32 && e <= 126; });
+	return ascii_is_printable(str, len);
 }
@@ -2,19 +2,53 @@
 
 
 #include "coff_full.h"
+#include "mz.h"
 
 #include <cstddef>
 #include <cstdint>
 
 
+struct pe_raw_range
+{
+	std::uint64_t m_begin;
+	std::uint64_t m_end;
+};
+
 struct pe_string
 {
 	char const* m_str;
 	int m_len;
 };
 
+static constexpr int const s_pe_required_sections_max = 5;
+
+
+struct pe_image
+{
+	std::byte const* m_file_data;
+	std::uint64_t m_mapped_size;
+	std::uint64_t m_file_size;
+	pe_dos_header const* m_dos;
+	pe_coff_full_32_64 const* m_coff;
+	bool m_is_32;
+	std::uint64_t m_image_base;
+	std::uint32_t m_data_directory_count;
+	pe_data_directory const* m_data_directories;
+	std::uint16_t m_section_count;
+	pe_section_header const* m_sections;
+	// Sorted disjoint raw ranges that hold file data, nullptr when the whole mapped window does.
+	pe_raw_range const* m_fetched_ranges;
+	int m_fetched_range_count;
+};
+
 
-std::uint32_t pe_find_object_in_raw(std::byte const* const file_data, int const file_size, std::uint32_t const obj_va, std::uint32_t const obj_size, pe_section_header const*& sct);
-bool pe_parse_string_rva(std::byte const* const file_data, int const file_size, std::uint32_t const str_rva, pe_string* const str_out);
-bool pe_parse_string_raw(std::byte const* const file_data, int const file_size, std::uint32_t const str_raw, pe_section_header const& sct, pe_string* const str_out);
+bool pe_parse_image(std::byte const* const file_data, std::uint64_t const mapped_size, std::uint64_t const file_size, pe_image* const image_out);
+pe_data_directory const* pe_find_data_directory(pe_image const& img, pe_e_directory_table const dir);
+int pe_find_required_sections(pe_image const& img, bool const with_resources, pe_section_header const** const sections_out);
+std::uint64_t pe_find_headers_size(pe_image const& img);
+std::uint64_t pe_find_required_extent(pe_image const& img, bool const with_resources);
+bool pe_is_fetched(pe_image const& img, std::uint64_t const raw_begin, std::uint64_t const raw_end);
+std::uint32_t pe_find_object_in_raw(pe_image const& img, std::uint32_t const obj_va, std::uint64_t const obj_size, pe_section_header const*& sct);
+bool pe_parse_string_rva(pe_image const& img, std::uint32_t const str_rva, pe_string* const str_out);
+bool pe_parse_string_raw(pe_image const& img, std::uint32_t const str_raw, pe_section_header const& sct, pe_string* const str_out);
 bool pe_is_ascii(char const* const& str, int const& len);
@@ -0,0 +1,92 @@
+#include "resource_table.h"
+
+#include "../assert.h"
+
+
+bool pe_parse_resource_table(pe_image const& img, pe_resource_table* const rt_out)
+{
+	assert(rt_out);
+	pe_data_directory const* const res_tbl = pe_find_data_directory(img, pe_e_directory_table::resource_table);
+	if(!res_tbl || res_tbl->m_size == 0)
+	{
+		rt_out->m_raw = 0;
+		rt_out->m_size = 0;
+		return true;
+	}
+	pe_section_header const* sct;
+	std::uint32_t const res_tbl_raw = pe_find_object_in_raw(img, res_tbl->m_va, res_tbl->m_size, sct);
+	WARN_M_R(res_tbl_raw != 0, L"Resource directory table not found in any section.", false);
+	rt_out->m_raw = res_tbl_raw;
+	rt_out->m_size = res_tbl->m_size;
+	return true;
+}
+
+bool pe_parse_resource_directory(pe_image const& img, pe_resource_table const& rt, std::uint32_t const dir_off, pe_resource_directory* const dir_out)
+{
+	assert(dir_out);
+	WARN_M_R(dir_off <= rt.m_size && rt.m_size - dir_off >= sizeof(pe_resource_directory_header), L"Resource directory does not fit into resource table.", false);
+	pe_resource_directory_header const& hdr = *reinterpret_cast<pe_resource_directory_header const*>(img.m_file_data + rt.m_raw + dir_off);
+	WARN_M(hdr.m_characteristics == 0, L"Resource directory characteristics should be zero.");
+	std::uint32_t const cnt = static_cast<std::uint32_t>(hdr.m_number_of_name_entries) + static_cast<std::uint32_t>(hdr.m_number_of_id_entries);
+	WARN_M_R(cnt <= 0xFFFF, L"Too many resource directory entries.", false);
+	WARN_M_R(rt.m_size - dir_off - sizeof(pe_resource_directory_header) >= cnt * sizeof(pe_resource_directory_entry), L"Resource directory entries do not fit into resource table.", false);
+	dir_out->m_table = reinterpret_cast<pe_resource_directory_entry const*>(img.m_file_data + rt.m_raw + dir_off + sizeof(pe_resource_directory_header));
+	dir_out->m_name_count = hdr.m_number_of_name_entries;
+	dir_out->m_count = static_cast<std::uint16_t>(cnt);
+	return true;
+}
+
+bool pe_parse_resource_name(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_name* const name_out)
+{
+	assert(name_out);
+	assert(idx < dir.m_count);
+	pe_resource_directory_entry const& entry = dir.m_table[idx];
+	bool const is_string = idx < dir.m_name_count;
+	bool const has_string_flag = (entry.m_name_offset_or_id & (1u << 31)) != 0;
+	WARN_M_R(has_string_flag == is_string, L"Resource name entry has wrong kind.", false);
+	name_out->m_is_string = is_string;
+	if(!is_string)
+	{
+		name_out->m_id_or_len = static_cast<std::uint16_t>(entry.m_name_offset_or_id);
+		name_out->m_string = nullptr;
+		return true;
+	}
+	std::uint32_t const str_off = entry.m_name_offset_or_id &~ (1u << 31);
+	WARN_M_R(str_off % sizeof(std::uint16_t) == 0, L"Resource name string is not aligned.", false);
+	WARN_M_R(str_off <= rt.m_size && rt.m_size - str_off >= sizeof(std::uint16_t), L"Resource name string does not fit into resource table.", false);
+	std::uint16_t const str_len = *reinterpret_cast<std::uint16_t const*>(img.m_file_data + rt.m_raw + str_off);
+	WARN_M_R(str_len >= 1, L"Resource name string is too short.", false);
+	WARN_M_R(rt.m_size - str_off - sizeof(std::uint16_t) >= str_len * sizeof(std::uint16_t), L"Resource name string does not fit into resource table.", false);
+	name_out->m_id_or_len = str_len;
+	name_out->m_string = reinterpret_cast<wchar_t const*>(img.m_file_data + rt.m_raw + str_off + sizeof(std::uint16_t));
+	return true;
+}
+
+bool pe_parse_resource_subdirectory(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_directory* const subdir_out)
+{
+	assert(subdir_out);
+	assert(idx < dir.m_count);
+	pe_resource_directory_entry const& entry = dir.m_table[idx];
+	WARN_M_R((entry.m_data_entry_or_subdirectory_offset & (1u << 31)) != 0, L"Resource directory entry is not a subdirectory.", false);
+	std::uint32_t const subdir_off = entry.m_data_entry_or_subdirectory_offset &~ (1u << 31);
+	return pe_parse_resource_directory(img, rt, subdir_off, subdir_out);
+}
+
+bool pe_parse_resource_data(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_data* const data_out)
+{
+	assert(data_out);
+	assert(idx < dir.m_count);
+	pe_resource_directory_entry const& entry = dir.m_table[idx];
+	WARN_M_R((entry.m_data_entry_or_subdirectory_offset & (1u << 31)) == 0, L"Resource directory entry is not a data entry.", false);
+	std::uint32_t const data_entry_off = entry.m_data_entry_or_subdirectory_offset;
+	WARN_M_R(data_entry_off <= rt.m_size && rt.m_size - data_entry_off >= sizeof(pe_resource_data_entry), L"Resource data entry does not fit into resource table.", false);
+	pe_resource_data_entry const& data_entry = *reinterpret_cast<pe_resource_data_entry const*>(img.m_file_data + rt.m_raw + data_entry_off);
+	WARN_M(data_entry.m_reserved == 0, L"Resource data entry reserved field should be zero.");
+	pe_section_header const* sct;
+	std::uint32_t const data_raw = pe_find_object_in_raw(img, data_entry.m_data_rva, data_entry.m_size, sct);
+	WARN_M_R(data_raw != 0, L"Resource data not found in any section.", false);
+	data_out->m_data = img.m_file_data + data_raw;
+	data_out->m_size = data_entry.m_size;
+	data_out->m_code_page = data_entry.m_code_page;
+	return true;
+}
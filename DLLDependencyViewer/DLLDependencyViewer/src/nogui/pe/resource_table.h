@@ -0,0 +1,72 @@
+#pragma once
+
+
+#include "pe_util.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+struct pe_resource_directory_header
+{
+	std::uint32_t m_characteristics;
+	std::uint32_t m_time_date_stamp;
+	std::uint16_t m_major_version;
+	std::uint16_t m_minor_version;
+	std::uint16_t m_number_of_name_entries;
+	std::uint16_t m_number_of_id_entries;
+};
+static_assert(sizeof(pe_resource_directory_header) == 16, "");
+static_assert(sizeof(pe_resource_directory_header) == 0x10, "");
+
+struct pe_resource_directory_entry
+{
+	std::uint32_t m_name_offset_or_id;
+	std::uint32_t m_data_entry_or_subdirectory_offset;
+};
+static_assert(sizeof(pe_resource_directory_entry) == 8, "");
+static_assert(sizeof(pe_resource_directory_entry) == 0x8, "");
+
+struct pe_resource_data_entry
+{
+	std::uint32_t m_data_rva;
+	std::uint32_t m_size;
+	std::uint32_t m_code_page;
+	std::uint32_t m_reserved;
+};
+static_assert(sizeof(pe_resource_data_entry) == 16, "");
+static_assert(sizeof(pe_resource_data_entry) == 0x10, "");
+
+struct pe_resource_table
+{
+	std::uint32_t m_raw;
+	std::uint32_t m_size;
+};
+
+struct pe_resource_directory
+{
+	pe_resource_directory_entry const* m_table;
+	std::uint16_t m_name_count;
+	std::uint16_t m_count;
+};
+
+struct pe_resource_name
+{
+	bool m_is_string;
+	std::uint16_t m_id_or_len;
+	wchar_t const* m_string;
+};
+
+struct pe_resource_data
+{
+	std::byte const* m_data;
+	std::uint32_t m_size;
+	std::uint32_t m_code_page;
+};
+
+
+bool pe_parse_resource_table(pe_image const& img, pe_resource_table* const rt_out);
+bool pe_parse_resource_directory(pe_image const& img, pe_resource_table const& rt, std::uint32_t const dir_off, pe_resource_directory* const dir_out);
+bool pe_parse_resource_name(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_name* const name_out);
+bool pe_parse_resource_subdirectory(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_directory* const subdir_out);
+bool pe_parse_resource_data(pe_image const& img, pe_resource_table const& rt, pe_resource_directory const& dir, int const& idx, pe_resource_data* const data_out);
@@ -4,54 +4,118 @@
 #include "assert.h"
 
 #include <algorithm>
+#include <bit>
 
+#include <emmintrin.h>
 
-bool pe_process_headers(std::byte const* const file_data, int const file_size, pe_headers* const headers_out)
+
+static constexpr std::uint64_t const s_pe_selective_first_fetch = 4 * 1024;
+
+
+bool pe_process_headers(std::byte const* const file_data, std::uint64_t const mapped_size, std::uint64_t const file_size, pe_image* const image_out)
+{
+	assert(image_out);
+	pe_image img;
+	bool const image_parsed = pe_parse_image(file_data, mapped_size, file_size, &img);
+	WARN_M_R(image_parsed, L"Failed to parse PE headers.", false);
+	*image_out = img;
+	return true;
+}
+
+bool pe_process_headers(memory_mapped_file& mmf, bool const with_resources, pe_image* const image_out)
 {
-	pe_dos_header const* dos_header;
-	pe_e_parse_mz_header const dos_parsed = pe_parse_mz_header(file_data, file_size, &dos_header);
+	assert(image_out);
+	bool const hdrs_processed = pe_process_headers(mmf.begin(), mmf.size(), mmf.file_size(), image_out);
+	WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
+	if(!mmf.is_windowed())
+	{
+		return true;
+	}
+	std::uint64_t const extent = pe_find_required_extent(*image_out, with_resources);
+	if(extent <= static_cast<std::uint64_t>(mmf.size()))
+	{
+		return true;
+	}
+	bool const extended = mmf.extend(extent);
+	WARN_M_R(extended, L"Failed to extend mapped window.", false);
+	bool const hdrs_reprocessed = pe_process_headers(mmf.begin(), mmf.size(), mmf.file_size(), image_out);
+	WARN_M_R(hdrs_reprocessed, L"Failed to pe_process_headers.", false);
+	return true;
+}
+
+bool pe_process_headers(selective_file& sf, bool const with_resources, pe_image* const image_out)
+{
+	assert(image_out);
+	bool const page_fetched = sf.fetch(0, s_pe_selective_first_fetch);
+	WARN_M_R(page_fetched, L"Failed to fetch first page.", false);
+	pe_dos_header const* dos_hdr;
+	pe_e_parse_mz_header const dos_parsed = pe_parse_mz_header(sf.begin(), std::min<std::uint64_t>(sf.size(), s_pe_selective_first_fetch), &dos_hdr);
 	WARN_M_R(dos_parsed == pe_e_parse_mz_header::ok, L"Failed to parse MZ header.", false);
-	pe_coff_full_32_64 const* coff_header;
-	bool const coff_parsed = pe_parse_coff_full_32_64(file_data, file_size, &coff_header);
-	WARN_M_R(coff_parsed, L"Failed to parse COFF header.", false);
-	headers_out->m_dos = dos_header;
-	headers_out->m_coff = coff_header;
+	std::uint64_t const coff_end = std::uint64_t{dos_hdr->m_pe_offset} + sizeof(pe_coff_header);
+	bool const coff_fetched = sf.fetch(0, coff_end);
+	WARN_M_R(coff_fetched, L"Failed to fetch COFF header.", false);
+	pe_coff_header const* coff_hdr;
+	pe_e_parse_coff_header const coff_parsed = pe_parse_coff_header(sf.begin(), std::min<std::uint64_t>(sf.size(), coff_end), &coff_hdr);
+	WARN_M_R(coff_parsed == pe_e_parse_coff_header::ok, L"Failed to parse COFF header.", false);
+	std::uint64_t const optional_size = std::max<std::uint64_t>(coff_hdr->m_optional_header_size, sizeof(pe_coff_full_64) - sizeof(pe_coff_header) + 16 * sizeof(pe_data_directory));
+	std::uint64_t const headers_end = coff_end + optional_size + std::uint64_t{coff_hdr->m_section_count} * sizeof(pe_section_header);
+	bool const headers_fetched = sf.fetch(0, headers_end);
+	WARN_M_R(headers_fetched, L"Failed to fetch headers.", false);
+	bool const hdrs_processed = pe_process_headers(sf.begin(), sf.size(), sf.file_size(), image_out);
+	WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
+	pe_section_header const* sections[s_pe_required_sections_max];
+	int const count = pe_find_required_sections(*image_out, with_resources, sections);
+	for(int i = 0; i != count; ++i)
+	{
+		bool const section_fetched = sf.fetch(sections[i]->m_raw_ptr, sections[i]->m_raw_size);
+		WARN_M_R(section_fetched, L"Failed to fetch section.", false);
+	}
+	return pe_process_fetched_headers(sf, image_out);
+}
+
+bool pe_process_fetched_headers(selective_file const& sf, pe_image* const image_out)
+{
+	assert(image_out);
+	bool const hdrs_processed = pe_process_headers(sf.begin(), sf.size(), sf.file_size(), image_out);
+	WARN_M_R(hdrs_processed, L"Failed to pe_process_headers.", false);
+	image_out->m_fetched_ranges = sf.fetched_ranges();
+	image_out->m_fetched_range_count = sf.fetched_range_count();
 	return true;
 }
 
 
-bool pe_process_import_tables(std::byte const* const file_data, int const file_size, pe_import_tables* const tables_out)
+bool pe_process_import_tables(pe_image const& img, pe_import_tables* const tables_out)
 {
 	pe_import_directory_table idt;
-	bool const import_table_parsed = pe_parse_import_table(file_data, file_size, &idt);
+	bool const import_table_parsed = pe_parse_import_table(img, &idt);
 	WARN_M_R(import_table_parsed, L"Failed to parse import table.", false);
 	pe_delay_import_table didt;
-	bool const dimport_table_parsed = pe_parse_delay_import_table(file_data, file_size, &didt);
+	bool const dimport_table_parsed = pe_parse_delay_import_table(img, &didt);
 	WARN_M_R(dimport_table_parsed, L"Failed to parse delay import table.", false);
 	tables_out->m_idt = idt;
 	tables_out->m_didt = didt;
 	return true;
 }
 
-bool pe_process_import_names(std::byte const* const file_data, int const file_size, pe_import_names* const names_in_out)
+bool pe_process_import_names(pe_image const& img, pe_import_names* const names_in_out)
 {
 	assert(names_in_out);
-	std::uint16_t const n1 = names_in_out->m_tables->m_idt.m_count;
-	std::uint16_t const n2 = names_in_out->m_tables->m_didt.m_count;
-	std::uint16_t const n = n1 + n2;
-	string_handle* const strings = names_in_out->m_alc->allocate_objects<string_handle>(n);
+	std::uint32_t const n1 = names_in_out->m_tables->m_idt.m_count;
+	std::uint32_t const n2 = names_in_out->m_tables->m_didt.m_count;
+	std::uint32_t const n = n1 + n2;
+	string_handle* const strings = names_in_out->m_alc->allocate_objects<string_handle>(n, allocation_tag::import_tables);
 	int ii = 0;
-	for(int i = 0; i != n1; ++i, ++ii)
+	for(std::uint32_t i = 0; i != n1; ++i, ++ii)
 	{
 		pe_string dll_name;
-		bool const name_parsed = pe_parse_import_dll_name(file_data, file_size, names_in_out->m_tables->m_idt.m_table[i], &dll_name);
+		bool const name_parsed = pe_parse_import_dll_name(img, names_in_out->m_tables->m_idt.m_table[i], &dll_name);
 		WARN_M_R(name_parsed, L"Failed to parse import DLL name.", false);
 		strings[ii] = names_in_out->m_ustrings->add_string(dll_name.m_str, dll_name.m_len, *names_in_out->m_alc);
 	}
-	for(int i = 0; i != n2; ++i, ++ii)
+	for(std::uint32_t i = 0; i != n2; ++i, ++ii)
 	{
 		pe_string dll_name;
-		bool const name_parsed = pe_parse_delay_import_dll_name(file_data, file_size, names_in_out->m_tables->m_didt.m_table[i], &dll_name);
+		bool const name_parsed = pe_parse_delay_import_dll_name(img, names_in_out->m_tables->m_didt.m_table[i], &dll_name);
 		WARN_M_R(name_parsed, L"Failed to parse delay import DLL name.", false);
 		strings[ii] = names_in_out->m_ustrings->add_string(dll_name.m_str, dll_name.m_len, *names_in_out->m_alc);
 	}
@@ -59,36 +123,39 @@ bool pe_process_import_names(std::byte const* const file_data, int const file_si
 	return true;
 }
 
-bool pe_process_import_iat(std::byte const* const file_data, int const file_size, pe_import_iat* const iat_in_out)
+template<typename idx_t>
+bool pe_process_import_iat(pe_image const& img, pe_import_iat_t<idx_t>* const iat_in_out)
 {
 	assert(iat_in_out);
+	allocator& alc = *iat_in_out->m_alc;
 	int const n_dlls = iat_in_out->m_tables->m_idt.m_count + iat_in_out->m_tables->m_didt.m_count;
-	std::uint16_t* const import_counts = iat_in_out->m_alc->allocate_objects<std::uint16_t>(n_dlls);
-	unsigned** const are_ordinals_all = iat_in_out->m_alc->allocate_objects<unsigned*>(n_dlls);
-	std::uint16_t** const ordinals_or_hints_all = iat_in_out->m_alc->allocate_objects<std::uint16_t*>(n_dlls);
-	string_handle** const names_all = iat_in_out->m_alc->allocate_objects<string_handle*>(n_dlls);
-	string_handle** const undecorated_names_all = iat_in_out->m_alc->allocate_objects<string_handle*>(n_dlls);
-	std::uint16_t** const matched_exports_all = iat_in_out->m_alc->allocate_objects<std::uint16_t*>(n_dlls);
+	idx_t* const import_counts = alc.allocate_objects<idx_t>(n_dlls, allocation_tag::import_tables);
+	std::uint64_t** const are_ordinals_all = alc.allocate_objects<std::uint64_t*>(n_dlls, allocation_tag::import_tables);
+	std::uint16_t** const ordinals_or_hints_all = alc.allocate_objects<std::uint16_t*>(n_dlls, allocation_tag::import_tables);
+	string_handle** const names_all = alc.allocate_objects<string_handle*>(n_dlls, allocation_tag::import_tables);
+	string_handle** const undecorated_names_all = alc.allocate_objects<string_handle*>(n_dlls, allocation_tag::import_tables);
+	idx_t** const matched_exports_all = alc.allocate_objects<idx_t*>(n_dlls, allocation_tag::import_tables);
 	int ii = 0;
-	for(int i = 0; i != iat_in_out->m_tables->m_idt.m_count; ++i, ++ii)
+	for(std::uint32_t i = 0; i != iat_in_out->m_tables->m_idt.m_count; ++i, ++ii)
 	{
 		pe_import_address_table iat;
-		bool const iat_parsed = pe_parse_import_address_table(file_data, file_size, iat_in_out->m_tables->m_idt.m_table[i], &iat);
+		bool const iat_parsed = pe_parse_import_address_table(img, iat_in_out->m_tables->m_idt.m_table[i], &iat);
 		WARN_M_R(iat_parsed, L"Failed to parse import address table.", false);
-		int const bits_to_dwords = array_bool_space_needed(iat.m_count);
-		unsigned* const are_ordinals = iat_in_out->m_alc->allocate_objects<unsigned>(bits_to_dwords);
-		std::fill(are_ordinals, are_ordinals + bits_to_dwords, 0u);
-		std::uint16_t* const ordinals_or_hints = iat_in_out->m_alc->allocate_objects<std::uint16_t>(iat.m_count);
-		string_handle* const names = iat_in_out->m_alc->allocate_objects<string_handle>(iat.m_count);
-		string_handle* const undecorated_names = iat_in_out->m_alc->allocate_objects<string_handle>(iat.m_count);
-		std::uint16_t* const matched_exports = iat_in_out->m_alc->allocate_objects<std::uint16_t>(iat.m_count);
-		std::fill(matched_exports,  matched_exports + iat.m_count, std::uint16_t{0xFFFF});
-		for(int j = 0; j != iat.m_count; ++j)
+		WARN_M_R(iat.m_count < pe_invalid_idx_v<idx_t>, L"Too many imports.", false);
+		int const bits_to_words = array_bool_space_needed(iat.m_count);
+		std::uint64_t* const are_ordinals = alc.allocate_objects<std::uint64_t>(bits_to_words, allocation_tag::import_tables);
+		std::fill(are_ordinals, are_ordinals + bits_to_words, std::uint64_t{0});
+		std::uint16_t* const ordinals_or_hints = alc.allocate_objects<std::uint16_t>(iat.m_count, allocation_tag::import_tables);
+		string_handle* const names = alc.allocate_objects<string_handle>(iat.m_count, allocation_tag::import_tables);
+		string_handle* const undecorated_names = alc.allocate_objects<string_handle>(iat.m_count, allocation_tag::import_tables);
+		idx_t* const matched_exports = alc.allocate_objects<idx_t>(iat.m_count, allocation_tag::matching);
+		std::fill(matched_exports,  matched_exports + iat.m_count, pe_invalid_idx_v<idx_t>);
+		for(int j = 0; j != static_cast<int>(iat.m_count); ++j)
 		{
 			bool is_ordinal;
 			std::uint16_t ordinal;
 			pe_hint_name hint_name;
-			bool const address_parsed = pe_parse_import_address(file_data, file_size, iat, j, &is_ordinal, &ordinal, &hint_name);
+			bool const address_parsed = pe_parse_import_address(img, iat, j, &is_ordinal, &ordinal, &hint_name);
 			WARN_M_R(address_parsed, L"Failed to parse import address.", false);
 			if(is_ordinal)
 			{
@@ -101,32 +168,33 @@ bool pe_process_import_iat(std::byte const* const file_data, int const file_size
 				names[j] = iat_in_out->m_ustrings->add_string(hint_name.m_name.m_str, hint_name.m_name.m_len, *iat_in_out->m_alc);
 			}
 		}
-		import_counts[ii] = iat.m_count;
+		import_counts[ii] = static_cast<idx_t>(iat.m_count);
 		are_ordinals_all[ii] = are_ordinals;
 		ordinals_or_hints_all[ii] = ordinals_or_hints;
 		names_all[ii] = names;
 		undecorated_names_all[ii] = undecorated_names;
 		matched_exports_all[ii] = matched_exports;
 	}
-	for(int i = 0; i != iat_in_out->m_tables->m_didt.m_count; ++i, ++ii)
+	for(std::uint32_t i = 0; i != iat_in_out->m_tables->m_didt.m_count; ++i, ++ii)
 	{
 		pe_delay_load_import_address_table iat;
-		bool const iat_parsed = pe_parse_delay_import_address_table(file_data, file_size, iat_in_out->m_tables->m_didt.m_table[i], &iat);
+		bool const iat_parsed = pe_parse_delay_import_address_table(img, iat_in_out->m_tables->m_didt.m_table[i], &iat);
 		WARN_M_R(iat_parsed, L"Failed to parse delay import address table.", false);
-		int const bits_to_dwords = array_bool_space_needed(iat.m_count);
-		unsigned* const are_ordinals = iat_in_out->m_alc->allocate_objects<unsigned>(bits_to_dwords);
-		std::fill(are_ordinals, are_ordinals + bits_to_dwords, 0u);
-		std::uint16_t* const ordinals_or_hints = iat_in_out->m_alc->allocate_objects<std::uint16_t>(iat.m_count);
-		string_handle* const names = iat_in_out->m_alc->allocate_objects<string_handle>(iat.m_count);
-		string_handle* const undecorated_names = iat_in_out->m_alc->allocate_objects<string_handle>(iat.m_count);
-		std::uint16_t* const matched_exports = iat_in_out->m_alc->allocate_objects<std::uint16_t>(iat.m_count);
-		std::fill(matched_exports,  matched_exports + iat.m_count, std::uint16_t{0xFFFF});
-		for(int j = 0; j != iat.m_count; ++j)
+		WARN_M_R(iat.m_count < pe_invalid_idx_v<idx_t>, L"Too many delay imports.", false);
+		int const bits_to_words = array_bool_space_needed(iat.m_count);
+		std::uint64_t* const are_ordinals = alc.allocate_objects<std::uint64_t>(bits_to_words, allocation_tag::import_tables);
+		std::fill(are_ordinals, are_ordinals + bits_to_words, std::uint64_t{0});
+		std::uint16_t* const ordinals_or_hints = alc.allocate_objects<std::uint16_t>(iat.m_count, allocation_tag::import_tables);
+		string_handle* const names = alc.allocate_objects<string_handle>(iat.m_count, allocation_tag::import_tables);
+		string_handle* const undecorated_names = alc.allocate_objects<string_handle>(iat.m_count, allocation_tag::import_tables);
+		idx_t* const matched_exports = alc.allocate_objects<idx_t>(iat.m_count, allocation_tag::matching);
+		std::fill(matched_exports,  matched_exports + iat.m_count, pe_invalid_idx_v<idx_t>);
+		for(int j = 0; j != static_cast<int>(iat.m_count); ++j)
 		{
 			bool is_ordinal;
 			std::uint16_t ordinal;
 			pe_hint_name hint_name;
-			bool const address_parsed = pe_parse_delay_import_address(file_data, file_size, iat_in_out->m_tables->m_didt.m_table[i], iat, j, &is_ordinal, &ordinal, &hint_name);
+			bool const address_parsed = pe_parse_delay_import_address(img, iat_in_out->m_tables->m_didt.m_table[i], iat, j, &is_ordinal, &ordinal, &hint_name);
 			WARN_M_R(address_parsed, L"Failed to parse delay import address.", false);
 			if(is_ordinal)
 			{
@@ -139,7 +207,7 @@ bool pe_process_import_iat(std::byte const* const file_data, int const file_size
 				names[j] = iat_in_out->m_ustrings->add_string(hint_name.m_name.m_str, hint_name.m_name.m_len, *iat_in_out->m_alc);
 			}
 		}
-		import_counts[ii] = iat.m_count;
+		import_counts[ii] = static_cast<idx_t>(iat.m_count);
 		are_ordinals_all[ii] = are_ordinals;
 		ordinals_or_hints_all[ii] = ordinals_or_hints;
 		names_all[ii] = names;
@@ -156,121 +224,215 @@ bool pe_process_import_iat(std::byte const* const file_data, int const file_size
 }
 
 
+static void pe_classify_eat_block(pe_export_address_entry const* const eat, int const count, std::uint32_t const export_directory_va, std::uint32_t const export_directory_size, std::uint64_t* const non_zero_out, std::uint64_t* const forwarders_out)
+{
+	assert(count >= 1 && count <= 64);
+	__m128i const zero = _mm_setzero_si128();
+	__m128i const bias = _mm_set1_epi32(static_cast<int>(0x8000'0000u));
+	__m128i const va = _mm_set1_epi32(static_cast<int>(export_directory_va));
+	__m128i const size_biased = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(export_directory_size)), bias);
+	std::uint64_t non_zero = 0;
+	std::uint64_t forwarders = 0;
+	int i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i const rvas = _mm_loadu_si128(reinterpret_cast<__m128i const*>(eat + i));
+		__m128i const offsets_biased = _mm_xor_si128(_mm_sub_epi32(rvas, va), bias);
+		std::uint64_t const zeros = static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(rvas, zero))));
+		std::uint64_t const inside = static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(offsets_biased, size_biased))));
+		non_zero |= (~zeros & 0xFu) << i;
+		forwarders |= inside << i;
+	}
+	for(; i != count; ++i)
+	{
+		std::uint32_t const rva = eat[i].m_export_rva;
+		non_zero |= std::uint64_t{rva != 0 ? 1u : 0u} << i;
+		forwarders |= std::uint64_t{rva - export_directory_va < export_directory_size ? 1u : 0u} << i;
+	}
+	*non_zero_out = non_zero;
+	*forwarders_out = forwarders & non_zero;
+}
+
+static std::uint64_t pe_compress_bits(std::uint64_t const bits, std::uint64_t const mask)
+{
+	std::uint64_t ret = 0;
+	int j = 0;
+	for(std::uint64_t m = mask; m != 0; m &= m - 1, ++j)
+	{
+		ret |= ((bits >> std::countr_zero(m)) & 1u) << j;
+	}
+	return ret;
+}
+
+
+static bool pe_validate_forwarder(char const* const str, int const len)
+{
+	WARN_M_R(len >= 3, L"Export forwarder is too short.", false);
+	WARN_M_R(std::find(str, str + len, '.') != str + len, L"Bad export forwarder name format.", false);
+	return true;
+}
+
+template<typename idx_t>
+static bool pe_validate_enpt(idx_t const* const enpt, int const enpt_count, string_handle const* const names)
+{
+	bool const is_sorted = std::is_sorted(enpt, enpt + enpt_count, [&](auto const& a, auto const& b)
+	{
+		assert(a != pe_invalid_idx_v<idx_t>);
+		assert(b != pe_invalid_idx_v<idx_t>);
+		assert(names[a]);
+		assert(names[b]);
+		return names[a] < names[b];
+	});
+	WARN_M_R(is_sorted, L"Export name pointer table is not sorted.", false);
+	return true;
+}
+
+
 #pragma warning(push)
 #pragma warning(disable:4701)
 #pragma warning(disable:4703)
 // potentially uninitialized local variable 'name' used
 // potentially uninitialized local pointer variable 'name' used
-// potentially uninitialized local variable 'frwrdr' used
-// potentially uninitialized local pointer variable 'frwrdr' used
-bool pe_process_export_eat(std::byte const* const file_data, int const file_size, pe_export_eat* const eat_in_out)
+template<typename idx_t>
+bool pe_process_export_eat(pe_image const& img, pe_export_eat_t<idx_t>* const eat_in_out)
 {
 	assert(eat_in_out);
-	assert(eat_in_out->m_headers);
 	assert(eat_in_out->m_ustrings);
 	assert(eat_in_out->m_alc);
 	assert(eat_in_out->m_tmp_alc);
 	assert(eat_in_out->m_eti_out);
 	assert(eat_in_out->m_enpt_count_out);
 	assert(eat_in_out->m_enpt_out);
+	allocator& alc = *eat_in_out->m_alc;
+	allocator& tmp_alc = *eat_in_out->m_tmp_alc;
 
 	pe_export_directory_table edt;
-	bool const edt_parsed = pe_parse_export_directory_table(file_data, file_size, &edt);
+	bool const edt_parsed = pe_parse_export_directory_table(img, &edt);
 	WARN_M_R(edt_parsed, L"Failed to parse export directory table.", false);
 	if(!edt.m_table || edt.m_table->m_export_address_count == 0)
 	{
 		eat_in_out->m_eti_out->m_count = 0;
+		eat_in_out->m_eti_out->m_validation = pe_validation::skipped;
+		*eat_in_out->m_enpt_count_out = 0;
+		*eat_in_out->m_enpt_out = nullptr;
 		return true;
 	}
+	WARN_M_R(std::uint64_t{edt.m_table->m_ordinal_base} + std::uint64_t{edt.m_table->m_export_address_count} <= pe_invalid_idx_v<idx_t>, L"Biggest ordinal is too high.", false);
 
-	bool const is_32 = pe_is_32_bit(eat_in_out->m_headers->m_coff->m_32.m_standard);
-	std::uint32_t const coff_size = is_32 ? sizeof(pe_coff_full_32) : sizeof(pe_coff_full_64);
-	std::uint32_t const data_dir_offset = eat_in_out->m_headers->m_dos->m_pe_offset + coff_size;
-	pe_data_directory const* const dta_dir_table = reinterpret_cast<pe_data_directory const*>(file_data + data_dir_offset);
-	std::uint32_t const export_directory_va = dta_dir_table[static_cast<int>(pe_e_directory_table::export_table)].m_va;
-	std::uint32_t const export_directory_size = dta_dir_table[static_cast<int>(pe_e_directory_table::export_table)].m_size;
+	pe_data_directory const& export_directory = img.m_data_directories[static_cast<int>(pe_e_directory_table::export_table)];
+	std::uint32_t const export_directory_va = export_directory.m_va;
+	std::uint32_t const export_directory_size = export_directory.m_size;
 
 	pe_export_name_pointer_table enpt;
-	bool const enpt_parsed = pe_parse_export_name_pointer_table(file_data, file_size, edt, &enpt);
+	bool const enpt_parsed = pe_parse_export_name_pointer_table(img, edt, &enpt);
 	WARN_M_R(enpt_parsed, L"Failed to parse export name pointer table.", false);
 	pe_export_ordinal_table eot;
-	bool const eot_parsed = pe_parse_export_ordinal_table(file_data, file_size, edt, &eot);
+	bool const eot_parsed = pe_parse_export_ordinal_table(img, edt, &eot);
 	WARN_M_R(eot_parsed, L"Failed to parse export ordinal table.", false);
 	WARN_M_R(enpt.m_count == eot.m_count, L"Export name pointer table and export ordinal table are in fact two columns of the same table.", false);
 	WARN_M_R(enpt.m_count == 0 || (enpt.m_table && eot.m_table), L"Export name pointer table and export ordinal table are in fact two columns of the same table.", false);
 	pe_export_address_table eat;
-	bool const eat_parsed = pe_parse_export_address_table(file_data, file_size, edt, &eat);
+	bool const eat_parsed = pe_parse_export_address_table(img, edt, &eat);
 	WARN_M_R(eat_parsed, L"Failed to parse export address table.", false);
+	bool const is_strict = eat_in_out->m_policy == pe_parse_policy::strict;
+
+	idx_t const eat_count_max = static_cast<idx_t>(eat.m_count);
 
-	std::uint16_t const eat_count_proper = static_cast<std::uint16_t>(std::count_if(eat.m_table, eat.m_table + eat.m_count, [](pe_export_address_entry const& eae){ return eae.m_export_rva != 0; }));
-
-	std::uint16_t* ordinals = eat_in_out->m_alc->allocate_objects<std::uint16_t>(eat_count_proper);
-	int const bits_to_dwords = array_bool_space_needed(eat_count_proper);
-	unsigned* const are_rvas = eat_in_out->m_alc->allocate_objects<unsigned>(bits_to_dwords);
-	std::fill(are_rvas, are_rvas + bits_to_dwords, 0u);
-	pe_rva_or_forwarder* const rvas_or_forwarders = eat_in_out->m_alc->allocate_objects<pe_rva_or_forwarder>(eat_count_proper);
-	std::uint16_t* const hints = eat_in_out->m_alc->allocate_objects<std::uint16_t>(eat_count_proper);
-	string_handle* const names = eat_in_out->m_alc->allocate_objects<string_handle>(eat_count_proper);
-	string_handle* const undecorated_names = eat_in_out->m_alc->allocate_objects<string_handle>(eat_count_proper);
-	unsigned* const are_used = eat_in_out->m_alc->allocate_objects<unsigned>(bits_to_dwords);
-	std::fill(are_used, are_used + bits_to_dwords, 0u);
-
-	std::uint16_t* const enpt_ = eat_in_out->m_tmp_alc->allocate_objects<std::uint16_t>(enpt.m_count);
-	std::fill(enpt_, enpt_ + enpt.m_count, static_cast<std::uint16_t>(0xFFFF));
-
-	std::uint16_t const ordinal_base = static_cast<std::uint16_t>(edt.m_table->m_ordinal_base);
-	std::uint16_t const n = eat.m_count;
-	std::uint16_t hints_processed = 0;
-	std::uint16_t j = 0;
-	for(std::uint16_t i = 0; i != n; ++i)
+	idx_t* ordinals = alc.allocate_objects<idx_t>(eat_count_max, allocation_tag::export_tables);
+	int const bits_to_words = array_bool_space_needed(eat_count_max);
+	std::uint64_t* const are_rvas = alc.allocate_objects<std::uint64_t>(bits_to_words, allocation_tag::export_tables);
+	std::fill(are_rvas, are_rvas + bits_to_words, std::uint64_t{0});
+	pe_rva_or_forwarder* const rvas_or_forwarders = alc.allocate_objects<pe_rva_or_forwarder>(eat_count_max, allocation_tag::export_tables);
+	idx_t* const hints = alc.allocate_objects<idx_t>(eat_count_max, allocation_tag::export_tables);
+	string_handle* const names = alc.allocate_objects<string_handle>(eat_count_max, allocation_tag::export_tables);
+	string_handle* const undecorated_names = alc.allocate_objects<string_handle>(eat_count_max, allocation_tag::export_tables);
+	std::uint64_t* const are_used = alc.allocate_objects<std::uint64_t>(bits_to_words, allocation_tag::matching);
+	std::fill(are_used, are_used + bits_to_words, std::uint64_t{0});
+
+	idx_t* const enpt_ = tmp_alc.allocate_objects<idx_t>(enpt.m_count);
+	std::fill(enpt_, enpt_ + enpt.m_count, pe_invalid_idx_v<idx_t>);
+
+	idx_t* const eat_to_hint = tmp_alc.allocate_objects<idx_t>(eat.m_count);
+	std::fill(eat_to_hint, eat_to_hint + eat.m_count, pe_invalid_idx_v<idx_t>);
+	for(idx_t hint = 0; hint != eot.m_count; ++hint)
 	{
-		std::uint32_t const export_rva = eat.m_table[i].m_export_rva;
-		if(export_rva == 0)
+		std::uint16_t const idx = eot.m_table[hint].m_idx_to_eat;
+		if(idx >= eat.m_count)
 		{
 			continue;
 		}
-		std::uint16_t const ordinal = ordinal_base + i;
-		std::uint16_t hint;
-		pe_string ean;
-		string_handle name;
-		bool const ean_parsed = pe_parse_export_address_name(file_data, file_size, enpt, eot, i, &hint, &ean);
-		WARN_M_R(ean_parsed, L"Failed to parse export address name.", false);
-		bool const has_name = ean.m_len != 0;
-		if(has_name)
+		WARN_M_R(!is_strict || eat_to_hint[idx] == pe_invalid_idx_v<idx_t>, L"Bad hint.", false);
+		if(eat_to_hint[idx] == pe_invalid_idx_v<idx_t>)
 		{
-			name = eat_in_out->m_ustrings->add_string(ean.m_str, ean.m_len, *eat_in_out->m_alc);
+			eat_to_hint[idx] = hint;
 		}
-		pe_string forwarder;
-		string_handle frwrdr;
-		bool const is_fwd = export_rva >= export_directory_va && export_rva < export_directory_va + export_directory_size;
-		bool const is_rva = !is_fwd;
-		if(is_fwd)
+	}
+
+	idx_t const ordinal_base = static_cast<idx_t>(edt.m_table->m_ordinal_base);
+	int const n = static_cast<int>(eat.m_count);
+	idx_t hints_processed = 0;
+	idx_t j = 0;
+	for(int block = 0; block < n; block += 64)
+	{
+		int const block_count = std::min(64, n - block);
+		std::uint64_t non_zero;
+		std::uint64_t forwarders;
+		pe_classify_eat_block(eat.m_table + block, block_count, export_directory_va, export_directory_size, &non_zero, &forwarders);
+		if(non_zero == 0)
+		{
+			continue;
+		}
+		std::uint64_t const block_mask = block_count == 64 ? ~std::uint64_t{0} : ((std::uint64_t{1} << block_count) - 1);
+		std::uint64_t const are_rvas_bits = non_zero == block_mask ? (~forwarders & block_mask) : pe_compress_bits(~forwarders, non_zero);
+		array_bool_set_bits(are_rvas, j, are_rvas_bits, std::popcount(non_zero));
+		for(std::uint64_t m = non_zero; m != 0; m &= m - 1)
 		{
-			const bool fwd_parsed = pe_parse_string_rva(file_data, file_size, export_rva, &forwarder);
-			WARN_M_R(fwd_parsed, L"Failed to parse export forwarder.", false);
-			WARN_M_R(forwarder.m_len >= 3, L"Export forwarder is too short.", false);
-			WARN_M_R(std::find(forwarder.m_str, forwarder.m_str + forwarder.m_len, '.') != forwarder.m_str + forwarder.m_len, L"Bad export forwarder name format.", false);
-			frwrdr = eat_in_out->m_ustrings->add_string(forwarder.m_str, forwarder.m_len, *eat_in_out->m_alc);
+			int const bit = std::countr_zero(m);
+			idx_t const i = static_cast<idx_t>(block + bit);
+			std::uint32_t const export_rva = eat.m_table[i].m_export_rva;
+			idx_t const ordinal = static_cast<idx_t>(ordinal_base + i);
+			idx_t const hint = eat_to_hint[i];
+			bool const has_name = hint != pe_invalid_idx_v<idx_t>;
+			string_handle name;
+			if(has_name)
+			{
+				pe_string ean;
+				bool const ean_parsed = pe_parse_string_rva(img, enpt.m_table[hint].m_export_address_name_rva, &ean);
+				WARN_M_R(ean_parsed, L"Failed to parse export address name.", false);
+				name = eat_in_out->m_ustrings->add_string(ean.m_str, ean.m_len, *eat_in_out->m_alc);
+			}
+			bool const is_fwd = ((forwarders >> bit) & 1u) != 0;
+			if(is_fwd)
+			{
+				pe_string forwarder;
+				const bool fwd_parsed = pe_parse_string_rva(img, export_rva, &forwarder);
+				WARN_M_R(fwd_parsed, L"Failed to parse export forwarder.", false);
+				if(is_strict)
+				{
+					bool const fwd_valid = pe_validate_forwarder(forwarder.m_str, forwarder.m_len);
+					WARN_M_R(fwd_valid, L"Failed to validate export forwarder.", false);
+				}
+				rvas_or_forwarders[j].m_forwarder = eat_in_out->m_ustrings->add_string(forwarder.m_str, forwarder.m_len, *eat_in_out->m_alc);
+			}
+			else
+			{
+				rvas_or_forwarders[j].m_rva = export_rva;
+			}
+			ordinals[j] = ordinal;
+			if(has_name){ hints[j] = hint; }else{ hints[j] = pe_invalid_idx_v<idx_t>; }
+			if(has_name){ names[j] = name; }else{ names[j] = string_handle{nullptr}; }
+			if(has_name){ enpt_[hint] = j; ++hints_processed; }else{}
+			++j;
 		}
-		ordinals[j] = ordinal;
-		if(is_rva){ array_bool_set(are_rvas, j); };
-		if(is_rva){ rvas_or_forwarders[j].m_rva = export_rva; }else{ rvas_or_forwarders[j].m_forwarder = frwrdr; }
-		if(has_name){ hints[j] = hint; }else{ hints[j] = 0xFFFF; }
-		if(has_name){ names[j] = name; }else{ names[j] = string_handle{nullptr}; }
-		if(has_name){ WARN_M_R(enpt_[hint] == 0xFFFF, L"Bad hint.", false); enpt_[hint] = j; ++hints_processed; }else{}
-		++j;
 	}
+	idx_t const eat_count_proper = j;
 
 	WARN_M_R(hints_processed == enpt.m_count, L"Not all names processed.", false);
-	bool const is_sorted = std::is_sorted(enpt_, enpt_ + enpt.m_count, [&](auto const& a, auto const& b)
+	if(is_strict)
 	{
-		assert(a != 0xFFFF);
-		assert(b != 0xFFFF);
-		assert(names[a]);
-		assert(names[b]);
-		return names[a] < names[b];
-	});
-	WARN_M_R(is_sorted, L"Export name pointer table is not sorted.", false);
+		bool const enpt_valid = pe_validate_enpt(enpt_, static_cast<int>(enpt.m_count), names);
+		WARN_M_R(enpt_valid, L"Failed to validate export name pointer table.", false);
+	}
 
 	eat_in_out->m_eti_out->m_count = eat_count_proper;
 	eat_in_out->m_eti_out->m_ordinal_base = ordinal_base;
@@ -281,67 +443,201 @@ bool pe_process_export_eat(std::byte const* const file_data, int const file_size
 	eat_in_out->m_eti_out->m_names = names;
 	eat_in_out->m_eti_out->m_undecorated_names = undecorated_names;
 	eat_in_out->m_eti_out->m_are_used = are_used;
-	*eat_in_out->m_enpt_count_out = enpt.m_count;
+	eat_in_out->m_eti_out->m_validation = is_strict ? pe_validation::passed : (eat_in_out->m_policy == pe_parse_policy::deferred ? pe_validation::pending : pe_validation::skipped);
+	*eat_in_out->m_enpt_count_out = static_cast<idx_t>(enpt.m_count);
 	*eat_in_out->m_enpt_out = enpt_;
 	return true;
 }
 #pragma warning(pop)
 
+template<typename idx_t>
+bool pe_validate_export_table(pe_export_table_info_t<idx_t> const& eti, allocator& tmp_alc)
+{
+	int enpt_count = 0;
+	for(idx_t i = 0; i != eti.m_count; ++i)
+	{
+		if(eti.m_hints[i] != pe_invalid_idx_v<idx_t>)
+		{
+			++enpt_count;
+		}
+	}
+	idx_t* const enpt = tmp_alc.allocate_objects<idx_t>(enpt_count);
+	std::fill(enpt, enpt + enpt_count, pe_invalid_idx_v<idx_t>);
+	for(idx_t i = 0; i != eti.m_count; ++i)
+	{
+		bool const is_rva = array_bool_tst(eti.m_are_rvas, i);
+		if(!is_rva)
+		{
+			string_handle const& forwarder = eti.m_rvas_or_forwarders[i].m_forwarder;
+			bool const fwd_valid = pe_validate_forwarder(forwarder.m_string->m_str, forwarder.m_string->m_len);
+			WARN_M_R(fwd_valid, L"Failed to validate export forwarder.", false);
+		}
+		idx_t const hint = eti.m_hints[i];
+		if(hint == pe_invalid_idx_v<idx_t>)
+		{
+			continue;
+		}
+		WARN_M_R(hint < static_cast<idx_t>(enpt_count) && enpt[hint] == pe_invalid_idx_v<idx_t>, L"Bad hint.", false);
+		enpt[hint] = i;
+	}
+	bool const enpt_valid = pe_validate_enpt(enpt, enpt_count, eti.m_names);
+	WARN_M_R(enpt_valid, L"Failed to validate export name pointer table.", false);
+	return true;
+}
+
+
+bool pe_process_resource_table(pe_image const& img, memory_manager& mm, pe_resources_table_info* const rti_out)
+{
+	assert(rti_out);
+	rti_out->m_resources.clear();
+	pe_resource_table rt;
+	bool const rt_parsed = pe_parse_resource_table(img, &rt);
+	WARN_M_R(rt_parsed, L"Failed to parse resource table.", false);
+	if(rt.m_size == 0)
+	{
+		return true;
+	}
+	auto const convert_name = [&](pe_resource_name const& name) -> pe_resource_string_or_id
+	{
+		pe_resource_string_or_id ret;
+		ret.m_is_string = name.m_is_string;
+		if(name.m_is_string)
+		{
+			ret.m_string = mm.m_wstrs.add_string(name.m_string, name.m_id_or_len, mm.m_alc);
+		}
+		else
+		{
+			ret.m_id = name.m_id_or_len;
+		}
+		return ret;
+	};
+	pe_resource_directory types;
+	bool const types_parsed = pe_parse_resource_directory(img, rt, 0, &types);
+	WARN_M_R(types_parsed, L"Failed to parse resource type directory.", false);
+	for(int i = 0; i != types.m_count; ++i)
+	{
+		pe_resource_name type;
+		bool const type_parsed = pe_parse_resource_name(img, rt, types, i, &type);
+		WARN_M_R(type_parsed, L"Failed to parse resource type.", false);
+		pe_resource_directory names;
+		bool const names_parsed = pe_parse_resource_subdirectory(img, rt, types, i, &names);
+		WARN_M_R(names_parsed, L"Failed to parse resource name directory.", false);
+		for(int j = 0; j != names.m_count; ++j)
+		{
+			pe_resource_name name;
+			bool const name_parsed = pe_parse_resource_name(img, rt, names, j, &name);
+			WARN_M_R(name_parsed, L"Failed to parse resource name.", false);
+			pe_resource_directory langs;
+			bool const langs_parsed = pe_parse_resource_subdirectory(img, rt, names, j, &langs);
+			WARN_M_R(langs_parsed, L"Failed to parse resource language directory.", false);
+			for(int k = 0; k != langs.m_count; ++k)
+			{
+				pe_resource_name lang;
+				bool const lang_parsed = pe_parse_resource_name(img, rt, langs, k, &lang);
+				WARN_M_R(lang_parsed, L"Failed to parse resource language.", false);
+				pe_resource_data data;
+				bool const data_parsed = pe_parse_resource_data(img, rt, langs, k, &data);
+				WARN_M_R(data_parsed, L"Failed to parse resource data.", false);
+				pe_resource res;
+				res.m_type = convert_name(type);
+				res.m_name = convert_name(name);
+				res.m_lang = convert_name(lang);
+				res.m_data = data.m_data;
+				res.m_size = data.m_size;
+				res.m_code_page = data.m_code_page;
+				rti_out->m_resources.push_back(res);
+			}
+		}
+	}
+	return true;
+}
+
 
-bool pe_process_all(std::byte const* const file_data, int const file_size, memory_manager& mm, pe_tables* const tables_in_out)
+template<typename idx_t>
+bool pe_process_all(pe_image const& img, memory_manager& mm, pe_tables_t<idx_t>* const tables_in_out)
 {
 	assert(tables_in_out);
-	assert(tables_in_out->m_tmp_alc);
-	assert(tables_in_out->m_iti_out);
-	assert(tables_in_out->m_eti_out);
-	assert(tables_in_out->m_enpt_count_out);
-	assert(tables_in_out->m_enpt_out);
-
-	pe_headers headers;
-	bool const headers_parsed = pe_process_headers(file_data, file_size, &headers);
-	WARN_M_R(headers_parsed, L"Failed to process headers.", false);
-
-	pe_import_tables tables;
-	bool const count_parsed = pe_process_import_tables(file_data, file_size, &tables);
-	WARN_M_R(count_parsed, L"Failed to pe_process_import_tables.", false);
-	pe_import_table_info iti;
-	iti.m_dll_count = tables.m_idt.m_count + tables.m_didt.m_count;
-	iti.m_non_delay_dll_count = tables.m_idt.m_count;
-
-	pe_import_names names;
-	names.m_tables = &tables;
-	names.m_ustrings = &mm.m_strs;
-	names.m_alc = &mm.m_alc;
-	bool const names_processed = pe_process_import_names(file_data, file_size, &names);
-	WARN_M_R(names_processed, L"Failed to pe_process_import_names.", false);
-	iti.m_dll_names = names.m_names_out;
-
-	pe_import_iat imports;
-	imports.m_headers = &headers;
-	imports.m_tables = &tables;
-	imports.m_ustrings = &mm.m_strs;
-	imports.m_alc = &mm.m_alc;
-	imports.m_iti_out = &iti;
-	bool const imports_processed = pe_process_import_iat(file_data, file_size, &imports);
-	WARN_M_R(imports_processed, L"Failed to pe_process_import_iat.", false);
-
-	pe_export_table_info eti;
-	std::uint16_t entp_count;
-	std::uint16_t const* entp;
-	pe_export_eat exports;
-	exports.m_headers = &headers;
-	exports.m_ustrings = &mm.m_strs;
-	exports.m_alc = &mm.m_alc;
-	exports.m_tmp_alc = tables_in_out->m_tmp_alc;
-	exports.m_eti_out = &eti;
-	exports.m_enpt_count_out = &entp_count;
-	exports.m_enpt_out = &entp;
-	bool const export_eat_processed = pe_process_export_eat(file_data, file_size, &exports);
-	WARN_M_R(export_eat_processed, L"Failed to process export address table.", false);
-
-	*tables_in_out->m_iti_out = iti;
-	*tables_in_out->m_eti_out = eti;
-	*tables_in_out->m_enpt_count_out = entp_count;
-	*tables_in_out->m_enpt_out = entp;
+
+	if(tables_in_out->m_iti_out)
+	{
+		pe_import_tables tables;
+		bool const count_parsed = pe_process_import_tables(img, &tables);
+		WARN_M_R(count_parsed, L"Failed to pe_process_import_tables.", false);
+		WARN_M_R(std::uint64_t{tables.m_idt.m_count} + std::uint64_t{tables.m_didt.m_count} < pe_invalid_idx_v<idx_t>, L"Too many DLLs.", false);
+		pe_import_table_info_t<idx_t> iti;
+		iti.m_dll_count = static_cast<idx_t>(tables.m_idt.m_count + tables.m_didt.m_count);
+		iti.m_non_delay_dll_count = static_cast<idx_t>(tables.m_idt.m_count);
+
+		pe_import_names names;
+		names.m_tables = &tables;
+		names.m_ustrings = &mm.m_strs;
+		names.m_alc = &mm.m_alc;
+		bool const names_processed = pe_process_import_names(img, &names);
+		WARN_M_R(names_processed, L"Failed to pe_process_import_names.", false);
+		iti.m_dll_names = names.m_names_out;
+
+		if(tables_in_out->m_dll_names_only)
+		{
+			idx_t* const import_counts = mm.m_alc.allocate_objects<idx_t>(iti.m_dll_count, allocation_tag::import_tables);
+			std::fill(import_counts, import_counts + iti.m_dll_count, idx_t{0});
+			iti.m_import_counts = import_counts;
+			iti.m_are_ordinals = nullptr;
+			iti.m_ordinals_or_hints = nullptr;
+			iti.m_names = nullptr;
+			iti.m_undecorated_names = nullptr;
+			iti.m_matched_exports = nullptr;
+		}
+		else
+		{
+			pe_import_iat_t<idx_t> imports;
+			imports.m_tables = &tables;
+			imports.m_ustrings = &mm.m_strs;
+			imports.m_alc = &mm.m_alc;
+			imports.m_iti_out = &iti;
+			bool const imports_processed = pe_process_import_iat(img, &imports);
+			WARN_M_R(imports_processed, L"Failed to pe_process_import_iat.", false);
+		}
+		*tables_in_out->m_iti_out = iti;
+	}
+
+	if(tables_in_out->m_eti_out)
+	{
+		assert(tables_in_out->m_tmp_alc);
+		assert(tables_in_out->m_enpt_count_out);
+		assert(tables_in_out->m_enpt_out);
+		pe_export_table_info_t<idx_t> eti;
+		idx_t entp_count;
+		idx_t const* entp;
+		pe_export_eat_t<idx_t> exports;
+		exports.m_policy = tables_in_out->m_policy;
+		exports.m_ustrings = &mm.m_strs;
+		exports.m_alc = &mm.m_alc;
+		exports.m_tmp_alc = tables_in_out->m_tmp_alc;
+		exports.m_eti_out = &eti;
+		exports.m_enpt_count_out = &entp_count;
+		exports.m_enpt_out = &entp;
+		bool const export_eat_processed = pe_process_export_eat(img, &exports);
+		WARN_M_R(export_eat_processed, L"Failed to process export address table.", false);
+		*tables_in_out->m_eti_out = eti;
+		*tables_in_out->m_enpt_count_out = entp_count;
+		*tables_in_out->m_enpt_out = entp;
+	}
+
+	if(tables_in_out->m_rti_out)
+	{
+		bool const resources_processed = pe_process_resource_table(img, mm, tables_in_out->m_rti_out);
+		WARN_M_R(resources_processed, L"Failed to process resource table.", false);
+	}
+
 	return true;
 }
+
+
+template bool pe_process_import_iat<std::uint16_t>(pe_image const& img, pe_import_iat_t<std::uint16_t>* const iat_in_out);
+template bool pe_process_import_iat<std::uint32_t>(pe_image const& img, pe_import_iat_t<std::uint32_t>* const iat_in_out);
+template bool pe_process_export_eat<std::uint16_t>(pe_image const& img, pe_export_eat_t<std::uint16_t>* const eat_in_out);
+template bool pe_process_export_eat<std::uint32_t>(pe_image const& img, pe_export_eat_t<std::uint32_t>* const eat_in_out);
+template bool pe_validate_export_table<std::uint16_t>(pe_export_table_info_t<std::uint16_t> const& eti, allocator& tmp_alc);
+template bool pe_validate_export_table<std::uint32_t>(pe_export_table_info_t<std::uint32_t> const& eti, allocator& tmp_alc);
+template bool pe_process_all<std::uint16_t>(pe_image const& img, memory_manager& mm, pe_tables_t<std::uint16_t>* const tables_in_out);
+template bool pe_process_all<std::uint32_t>(pe_image const& img, memory_manager& mm, pe_tables_t<std::uint32_t>* const tables_in_out);
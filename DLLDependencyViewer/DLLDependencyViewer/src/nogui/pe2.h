@@ -3,23 +3,22 @@
 
 #include "allocator.h"
 #include "memory_manager.h"
+#include "memory_mapped_file.h"
 #include "pe.h"
+#include "selective_file.h"
 #include "unique_strings.h"
 
 #include "pe/coff_full.h"
 #include "pe/export_table.h"
 #include "pe/import_table.h"
 #include "pe/mz.h"
+#include "pe/pe_util.h"
+#include "pe/resource_table.h"
 
 #include <cstddef>
+#include <cstdint>
 
 
-struct pe_headers
-{
-	pe_dos_header const* m_dos;
-	pe_coff_full_32_64 const* m_coff;
-};
-
 struct pe_import_tables
 {
 	pe_import_directory_table m_idt;
@@ -34,42 +33,57 @@ struct pe_import_names
 	string_handle const* m_names_out;
 };
 
-struct pe_import_iat
+template<typename idx_t>
+struct pe_import_iat_t
 {
-	pe_headers* m_headers;
 	pe_import_tables const* m_tables;
 	unique_strings* m_ustrings;
 	allocator* m_alc;
-	pe_import_table_info* m_iti_out;
+	pe_import_table_info_t<idx_t>* m_iti_out;
 };
+typedef pe_import_iat_t<std::uint16_t> pe_import_iat;
 
-struct pe_export_eat
+template<typename idx_t>
+struct pe_export_eat_t
 {
-	pe_headers* m_headers;
+	pe_parse_policy m_policy;
 	unique_strings* m_ustrings;
 	allocator* m_alc;
 	allocator* m_tmp_alc;
-	pe_export_table_info* m_eti_out;
-	std::uint16_t* m_enpt_count_out;
-	std::uint16_t const** m_enpt_out;
+	pe_export_table_info_t<idx_t>* m_eti_out;
+	idx_t* m_enpt_count_out;
+	idx_t const** m_enpt_out;
 };
+typedef pe_export_eat_t<std::uint16_t> pe_export_eat;
 
-struct pe_tables
+template<typename idx_t>
+struct pe_tables_t
 {
+	pe_parse_policy m_policy;
+	bool m_dll_names_only;
 	allocator* m_tmp_alc;
-	pe_import_table_info* m_iti_out;
-	pe_export_table_info* m_eti_out;
-	std::uint16_t* m_enpt_count_out;
-	std::uint16_t const** m_enpt_out;
+	pe_import_table_info_t<idx_t>* m_iti_out;
+	pe_export_table_info_t<idx_t>* m_eti_out;
+	idx_t* m_enpt_count_out;
+	idx_t const** m_enpt_out;
+	pe_resources_table_info* m_rti_out;
 };
+typedef pe_tables_t<std::uint16_t> pe_tables;
+typedef pe_tables_t<std::uint32_t> pe_tables_32;
+
 
+bool pe_process_headers(std::byte const* const file_data, std::uint64_t const mapped_size, std::uint64_t const file_size, pe_image* const image_out);
+bool pe_process_headers(memory_mapped_file& mmf, bool const with_resources, pe_image* const image_out);
+bool pe_process_headers(selective_file& sf, bool const with_resources, pe_image* const image_out);
+bool pe_process_fetched_headers(selective_file const& sf, pe_image* const image_out);
 
-bool pe_process_headers(std::byte const* const file_data, int const file_size, pe_headers* const headers_out);
+bool pe_process_import_tables(pe_image const& img, pe_import_tables* const tables_out);
+bool pe_process_import_names(pe_image const& img, pe_import_names* const names_in_out);
+template<typename idx_t> bool pe_process_import_iat(pe_image const& img, pe_import_iat_t<idx_t>* const iat_in_out);
 
-bool pe_process_import_tables(std::byte const* const file_data, int const file_size, pe_import_tables* const tables_out);
-bool pe_process_import_names(std::byte const* const file_data, int const file_size, pe_import_names* const names_in_out);
-bool pe_process_import_iat(std::byte const* const file_data, int const file_size, pe_import_iat* const iat_in_out);
+template<typename idx_t> bool pe_process_export_eat(pe_image const& img, pe_export_eat_t<idx_t>* const eat_in_out);
+template<typename idx_t> bool pe_validate_export_table(pe_export_table_info_t<idx_t> const& eti, allocator& tmp_alc);
 
-bool pe_process_export_eat(std::byte const* const file_data, int const file_size, pe_export_eat* const eat_in_out);
+bool pe_process_resource_table(pe_image const& img, memory_manager& mm, pe_resources_table_info* const rti_out);
 
-bool pe_process_all(std::byte const* const file_data, int const file_size, memory_manager& mm, pe_tables* const tables_in_out);
+template<typename idx_t> bool pe_process_all(pe_image const& img, memory_manager& mm, pe_tables_t<idx_t>* const tables_in_out);
@@ -7,12 +7,12 @@
 #include <cassert>
 
 
-std::uint8_t pe_get_export_icon_id(pe_export_table_info const& eti, std::uint16_t const* const matched_imports, std::uint16_t const exp_idx)
+std::uint8_t pe_get_export_icon_id(pe_export_table_info_32 const& eti, std::uint32_t const* const matched_imports, std::uint32_t const exp_idx)
 {
 	bool const is_used = array_bool_tst(eti.m_are_used, exp_idx);
-	bool const is_matched = matched_imports[exp_idx] != 0xFFFF;
+	bool const is_matched = matched_imports[exp_idx] != pe_invalid_idx_v<std::uint32_t>;
 	bool const is_rva = array_bool_tst(eti.m_are_rvas, exp_idx);
-	bool const has_name = eti.m_hints[exp_idx] != 0xFFFF;
+	bool const has_name = eti.m_hints[exp_idx] != pe_invalid_idx_v<std::uint32_t>;
 	static constexpr std::int8_t const s_export_images[2][2][2][2] =
 	{
 		{
@@ -65,24 +65,24 @@ std::uint8_t pe_get_export_icon_id(pe_export_table_info const& eti, std::uint16_
 	return img;
 }
 
-bool pe_get_export_type(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+bool pe_get_export_type(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
 	bool const is_rva = array_bool_tst(eti.m_are_rvas, exp_idx);
 	return is_rva;
 }
 
-std::uint16_t pe_get_export_ordinal(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+std::uint32_t pe_get_export_ordinal(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	std::uint16_t const ordinal = eti.m_ordinals[exp_idx];
+	std::uint32_t const ordinal = eti.m_ordinals[exp_idx];
 	return ordinal;
 }
 
-optional<std::uint16_t> pe_get_export_hint(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+optional<std::uint32_t> pe_get_export_hint(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	bool const has_name = eti.m_hints[exp_idx] != 0xFFFF;
+	bool const has_name = eti.m_hints[exp_idx] != pe_invalid_idx_v<std::uint32_t>;
 	if(has_name)
 	{
-		std::uint16_t const hint = eti.m_hints[exp_idx];
+		std::uint32_t const hint = eti.m_hints[exp_idx];
 		return {hint, true};
 	}
 	else
@@ -91,9 +91,9 @@ optional<std::uint16_t> pe_get_export_hint(pe_export_table_info const& eti, std:
 	}
 }
 
-string_handle pe_get_export_name(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+string_handle pe_get_export_name(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	bool const has_name = eti.m_hints[exp_idx] != 0xFFFF;
+	bool const has_name = eti.m_hints[exp_idx] != pe_invalid_idx_v<std::uint32_t>;
 	if(has_name)
 	{
 		string_handle const& name = eti.m_names[exp_idx];
@@ -125,9 +125,9 @@ string_handle pe_get_export_name(pe_export_table_info const& eti, std::uint16_t
 	}
 }
 
-string_handle pe_get_export_name_undecorated(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+string_handle pe_get_export_name_undecorated(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
-	bool const has_name = eti.m_hints[exp_idx] != 0xFFFF;
+	bool const has_name = eti.m_hints[exp_idx] != pe_invalid_idx_v<std::uint32_t>;
 	if(has_name)
 	{
 		string_handle const& name = eti.m_names[exp_idx];
@@ -199,7 +199,7 @@ string_handle pe_get_export_name_undecorated(pe_export_table_info const& eti, st
 	}
 }
 
-pe_rva_or_forwarder pe_get_export_entry_point(pe_export_table_info const& eti, std::uint16_t const exp_idx)
+pe_rva_or_forwarder pe_get_export_entry_point(pe_export_table_info_32 const& eti, std::uint32_t const exp_idx)
 {
 	pe_rva_or_forwarder const& entry_point = eti.m_rvas_or_forwarders[exp_idx];
 	return entry_point;
@@ -8,10 +8,10 @@
 #include <cassert>
 
 
-std::uint8_t pe_get_import_icon_id(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+std::uint8_t pe_get_import_icon_id(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
-	std::uint16_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
-	bool const has_matched_export = matched_export != 0xFFFF;
+	std::uint32_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
+	bool const has_matched_export = matched_export != pe_invalid_idx_v<std::uint32_t>;
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	if(has_matched_export && is_ordinal)
 	{
@@ -33,13 +33,13 @@ std::uint8_t pe_get_import_icon_id(pe_import_table_info const& iti, std::uint16_
 	__assume(false);
 }
 
-bool pe_get_import_is_ordinal(pe_import_table_info const& iti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+bool pe_get_import_is_ordinal(pe_import_table_info_32 const& iti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	return is_ordinal;
 }
 
-optional<std::uint16_t> pe_get_import_ordinal(pe_import_table_info const& iti, pe_export_table_info const& eti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+optional<std::uint32_t> pe_get_import_ordinal(pe_import_table_info_32 const& iti, pe_export_table_info_32 const& eti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	if(is_ordinal)
@@ -49,11 +49,11 @@ optional<std::uint16_t> pe_get_import_ordinal(pe_import_table_info const& iti, p
 	}
 	else
 	{
-		std::uint16_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
-		bool const has_matched_export = matched_export != 0xFFFF;
+		std::uint32_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
+		bool const has_matched_export = matched_export != pe_invalid_idx_v<std::uint32_t>;
 		if(has_matched_export)
 		{
-			std::uint16_t const ordinal = pe_get_export_ordinal(eti, matched_export);
+			std::uint32_t const ordinal = pe_get_export_ordinal(eti, matched_export);
 			return {ordinal, true};
 		}
 		else
@@ -63,13 +63,13 @@ optional<std::uint16_t> pe_get_import_ordinal(pe_import_table_info const& iti, p
 	}
 }
 
-optional<std::uint16_t> pe_get_import_hint(pe_import_table_info const& iti, pe_export_table_info const& eti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+optional<std::uint32_t> pe_get_import_hint(pe_import_table_info_32 const& iti, pe_export_table_info_32 const& eti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	if(is_ordinal)
 	{
-		std::uint16_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
-		bool const has_matched_export = matched_export != 0xFFFF;
+		std::uint32_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
+		bool const has_matched_export = matched_export != pe_invalid_idx_v<std::uint32_t>;
 		if(has_matched_export)
 		{
 			auto const hint_opt = pe_get_export_hint(eti, matched_export);
@@ -87,13 +87,13 @@ optional<std::uint16_t> pe_get_import_hint(pe_import_table_info const& iti, pe_e
 	}
 }
 
-string_handle pe_get_import_name(pe_import_table_info const& iti, pe_export_table_info const& eti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+string_handle pe_get_import_name(pe_import_table_info_32 const& iti, pe_export_table_info_32 const& eti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	if(is_ordinal)
 	{
-		std::uint16_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
-		bool const has_matched_export = matched_export != 0xFFFF;
+		std::uint32_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
+		bool const has_matched_export = matched_export != pe_invalid_idx_v<std::uint32_t>;
 		if(has_matched_export)
 		{
 			return pe_get_export_name(eti, matched_export);
@@ -110,13 +110,13 @@ string_handle pe_get_import_name(pe_import_table_info const& iti, pe_export_tabl
 	}
 }
 
-string_handle pe_get_import_name_undecorated(pe_import_table_info const& iti, pe_export_table_info const& eti, std::uint16_t const dll_idx, std::uint16_t const imp_idx)
+string_handle pe_get_import_name_undecorated(pe_import_table_info_32 const& iti, pe_export_table_info_32 const& eti, std::uint32_t const dll_idx, std::uint32_t const imp_idx)
 {
 	bool const is_ordinal = array_bool_tst(iti.m_are_ordinals[dll_idx], imp_idx);
 	if(is_ordinal)
 	{
-		std::uint16_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
-		bool const has_matched_export = matched_export != 0xFFFF;
+		std::uint32_t const& matched_export = iti.m_matched_exports[dll_idx][imp_idx];
+		bool const has_matched_export = matched_export != pe_invalid_idx_v<std::uint32_t>;
 		if(has_matched_export)
 		{
 			return pe_get_export_name_undecorated(eti, matched_export);
@@ -0,0 +1,286 @@
+#include "pe_triage.h"
+
+#include "pe/coff_full.h"
+#include "pe/mz.h"
+#include "smart_handle.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <cwchar>
+#include <iterator>
+#include <vector>
+
+#include "my_windows.h"
+
+
+static constexpr int const s_triage_page_size = 4 * 1024;
+static constexpr int const s_triage_headers_max = static_cast<int>(sizeof(pe_coff_full_64) + 16 * sizeof(pe_data_directory));
+static constexpr std::uint16_t const s_triage_mz_signature = 0x5a4d; // MZ
+static constexpr std::uint32_t const s_triage_pe_signature = 0x00004550; // PE\0\0
+static constexpr std::uint16_t const s_triage_opt_signature_32 = 0x010b;
+static constexpr std::uint16_t const s_triage_opt_signature_64 = 0x020b;
+static constexpr std::uint16_t const s_triage_characteristics_dll = 0x2000; // IMAGE_FILE_DLL
+static constexpr std::uint16_t const s_triage_machine_x86 = 0x014c;
+static constexpr std::uint16_t const s_triage_machine_x64 = 0x8664;
+static constexpr std::uint16_t const s_triage_machine_arm64 = 0xaa64;
+static constexpr int const s_triage_load_config_chpe_offset_64 = 0xc8; // IMAGE_LOAD_CONFIG_DIRECTORY64::CHPEMetadataPointer
+
+static constexpr wchar_t const s_triage_filter_x86[] = L"x86";
+static constexpr wchar_t const s_triage_filter_x64[] = L"x64";
+static constexpr wchar_t const s_triage_filter_arm64[] = L"arm64";
+static constexpr wchar_t const s_triage_filter_dll[] = L"dll";
+static constexpr wchar_t const s_triage_filter_exe[] = L"exe";
+static constexpr wchar_t const s_triage_filter_imports[] = L"imports";
+static constexpr wchar_t const s_triage_filter_exports[] = L"exports";
+
+
+static bool pe_triage_read(HANDLE const file, std::uint64_t const offset, int const size, std::byte* const buffer, int* const read_out)
+{
+	assert(read_out);
+	OVERLAPPED ol{};
+	ol.Offset = static_cast<DWORD>(offset);
+	ol.OffsetHigh = static_cast<DWORD>(offset >> 32);
+	DWORD read;
+	BOOL const ok = ReadFile(file, buffer, static_cast<DWORD>(size), &read, &ol);
+	if(ok == FALSE)
+	{
+		return false;
+	}
+	*read_out = static_cast<int>(read);
+	return true;
+}
+
+// ARM64X images carry ARM64 in the COFF header and CHPE metadata in the load config, x64 processes can load them.
+static bool pe_triage_is_hybrid(HANDLE const file, std::byte const* const data)
+{
+	pe_dos_header const& dos = *reinterpret_cast<pe_dos_header const*>(data);
+	pe_coff_full_64 const& coff = *reinterpret_cast<pe_coff_full_64 const*>(data + dos.m_pe_offset);
+	std::uint32_t const dir_count = std::min<std::uint32_t>(coff.m_windows.m_data_directory_count, 16);
+	std::uint64_t const dirs_offset = dos.m_pe_offset + sizeof(pe_coff_full_64);
+	pe_data_directory const& load_config = reinterpret_cast<pe_data_directory const*>(data + dirs_offset)[static_cast<int>(pe_e_directory_table::load_config_table)];
+	int const section_count = coff.m_coff.m_section_count;
+	std::vector<pe_section_header> sections;
+	sections.resize(section_count);
+	int const sections_size = section_count * static_cast<int>(sizeof(pe_section_header));
+	int read;
+	bool const sections_read = pe_triage_read(file, dirs_offset + dir_count * sizeof(pe_data_directory), sections_size, reinterpret_cast<std::byte*>(sections.data()), &read);
+	if(!sections_read || read != sections_size)
+	{
+		return false;
+	}
+	auto const it = std::find_if(sections.cbegin(), sections.cend(), [&](pe_section_header const& sct){ return load_config.m_va >= sct.m_virtual_address && load_config.m_va - sct.m_virtual_address < sct.m_raw_size; });
+	if(it == sections.cend())
+	{
+		return false;
+	}
+	std::uint64_t const load_config_raw = std::uint64_t{it->m_raw_ptr} + (load_config.m_va - it->m_virtual_address);
+	std::byte buff[s_triage_load_config_chpe_offset_64 + sizeof(std::uint64_t)];
+	bool const load_config_read = pe_triage_read(file, load_config_raw, static_cast<int>(sizeof(buff)), buff, &read);
+	if(!load_config_read || read != static_cast<int>(sizeof(buff)))
+	{
+		return false;
+	}
+	std::uint32_t load_config_size;
+	std::memcpy(&load_config_size, buff, sizeof(load_config_size));
+	std::uint64_t chpe_metadata;
+	std::memcpy(&chpe_metadata, buff + s_triage_load_config_chpe_offset_64, sizeof(chpe_metadata));
+	return load_config_size >= sizeof(buff) && chpe_metadata != 0;
+}
+
+template<int n>
+static bool pe_triage_token_equal(wchar_t const* const token, int const len, wchar_t const(&str)[n])
+{
+	return len == n - 1 && std::wcsncmp(token, str, n - 1) == 0;
+}
+
+
+bool pe_triage_buffer(std::byte const* const data, int const size, pe_triage_info* const info_out)
+{
+	assert(info_out);
+	if(size < static_cast<int>(sizeof(pe_dos_header)))
+	{
+		return false;
+	}
+	pe_dos_header const& dos = *reinterpret_cast<pe_dos_header const*>(data);
+	if(dos.m_signature != s_triage_mz_signature)
+	{
+		return false;
+	}
+	int const pe_offset = dos.m_pe_offset;
+	if(size < pe_offset + static_cast<int>(sizeof(pe_coff_header) + sizeof(std::uint16_t)))
+	{
+		return false;
+	}
+	pe_coff_full_32_64 const& coff = *reinterpret_cast<pe_coff_full_32_64 const*>(data + pe_offset);
+	if(coff.m_32.m_coff.m_signature != s_triage_pe_signature)
+	{
+		return false;
+	}
+	std::uint16_t const opt_signature = coff.m_32.m_standard.m_signature;
+	if(opt_signature != s_triage_opt_signature_32 && opt_signature != s_triage_opt_signature_64)
+	{
+		return false;
+	}
+	bool const is_32 = opt_signature == s_triage_opt_signature_32;
+	int const full_size = static_cast<int>(is_32 ? sizeof(pe_coff_full_32) : sizeof(pe_coff_full_64));
+	if(size < pe_offset + full_size)
+	{
+		return false;
+	}
+	std::uint32_t const dir_count = std::min<std::uint32_t>(is_32 ? coff.m_32.m_windows.m_data_directory_count : coff.m_64.m_windows.m_data_directory_count, 16);
+	if(size < pe_offset + full_size + static_cast<int>(dir_count * sizeof(pe_data_directory)))
+	{
+		return false;
+	}
+	pe_data_directory const* const dirs = reinterpret_cast<pe_data_directory const*>(data + pe_offset + full_size);
+	std::uint32_t present = 0;
+	for(std::uint32_t i = 0; i != dir_count; ++i)
+	{
+		if(dirs[i].m_va != 0 && dirs[i].m_size != 0)
+		{
+			present |= std::uint32_t{1} << i;
+		}
+	}
+	info_out->m_machine = coff.m_32.m_coff.m_machine;
+	info_out->m_is_32 = is_32;
+	info_out->m_is_hybrid = false;
+	info_out->m_subsystem = is_32 ? coff.m_32.m_windows.m_subsystem : coff.m_64.m_windows.m_subsystem;
+	info_out->m_characteristics = coff.m_32.m_coff.m_characteristics;
+	info_out->m_dll_characteristics = is_32 ? coff.m_32.m_windows.m_dll_characteristics : coff.m_64.m_windows.m_dll_characteristics;
+	info_out->m_section_count = coff.m_32.m_coff.m_section_count;
+	info_out->m_data_directories = present;
+	return true;
+}
+
+bool pe_triage_file(wchar_t const* const file_name, pe_triage_info* const info_out)
+{
+	assert(file_name);
+	assert(info_out);
+	HANDLE const file = CreateFileW(file_name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	smart_handle const s_file(file);
+	std::byte page[s_triage_page_size];
+	int read;
+	bool const page_read = pe_triage_read(file, 0, s_triage_page_size, page, &read);
+	if(!page_read || read < static_cast<int>(sizeof(pe_dos_header)))
+	{
+		return false;
+	}
+	pe_dos_header const& dos = *reinterpret_cast<pe_dos_header const*>(page);
+	if(dos.m_signature != s_triage_mz_signature)
+	{
+		return false;
+	}
+	int const needed = dos.m_pe_offset + s_triage_headers_max;
+	std::byte const* data = page;
+	std::vector<std::byte> headers;
+	if(!(needed <= read || read < s_triage_page_size))
+	{
+		headers.resize(needed);
+		bool const headers_read = pe_triage_read(file, 0, needed, headers.data(), &read);
+		if(!headers_read)
+		{
+			return false;
+		}
+		data = headers.data();
+	}
+	bool const triaged = pe_triage_buffer(data, read, info_out);
+	if(!triaged)
+	{
+		return false;
+	}
+	if(info_out->m_machine == s_triage_machine_arm64 && !info_out->m_is_32 && pe_triage_has_data_directory(*info_out, static_cast<int>(pe_e_directory_table::load_config_table)))
+	{
+		info_out->m_is_hybrid = pe_triage_is_hybrid(file, data);
+	}
+	return true;
+}
+
+bool pe_triage_parse_filter(wchar_t const* const str, pe_triage_filter* const filter_out)
+{
+	assert(str);
+	assert(filter_out);
+	pe_triage_filter filter{};
+	wchar_t const* token = str;
+	for(;;)
+	{
+		wchar_t const* const token_end = std::wcschr(token, L',');
+		int const len = static_cast<int>(token_end ? token_end - token : std::wcslen(token));
+		if(pe_triage_token_equal(token, len, s_triage_filter_x86))
+		{
+			filter.m_machine = s_triage_machine_x86;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_x64))
+		{
+			filter.m_machine = s_triage_machine_x64;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_arm64))
+		{
+			filter.m_machine = s_triage_machine_arm64;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_dll))
+		{
+			filter.m_dlls_only = true;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_exe))
+		{
+			filter.m_exes_only = true;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_imports))
+		{
+			filter.m_with_imports = true;
+		}
+		else if(pe_triage_token_equal(token, len, s_triage_filter_exports))
+		{
+			filter.m_with_exports = true;
+		}
+		else if(len != 0)
+		{
+			return false;
+		}
+		if(!token_end)
+		{
+			break;
+		}
+		token = token_end + 1;
+	}
+	*filter_out = filter;
+	return true;
+}
+
+bool pe_triage_matches(pe_triage_info const& info, pe_triage_filter const& filter)
+{
+	bool const is_dll = (info.m_characteristics & s_triage_characteristics_dll) != 0;
+	if(filter.m_machine != 0 && info.m_machine != filter.m_machine)
+	{
+		return false;
+	}
+	if(filter.m_dlls_only && !is_dll)
+	{
+		return false;
+	}
+	if(filter.m_exes_only && is_dll)
+	{
+		return false;
+	}
+	if(filter.m_with_imports && !pe_triage_has_data_directory(info, static_cast<int>(pe_e_directory_table::import_table)) && !pe_triage_has_data_directory(info, static_cast<int>(pe_e_directory_table::delay_import_descriptor)))
+	{
+		return false;
+	}
+	if(filter.m_with_exports && !pe_triage_has_data_directory(info, static_cast<int>(pe_e_directory_table::export_table)))
+	{
+		return false;
+	}
+	return true;
+}
+
+bool pe_triage_has_data_directory(pe_triage_info const& info, int const dir)
+{
+	assert(dir >= 0 && dir < 32);
+	return (info.m_data_directories & (std::uint32_t{1} << dir)) != 0;
+}
+
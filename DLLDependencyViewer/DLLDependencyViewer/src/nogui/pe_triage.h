@@ -0,0 +1,34 @@
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+struct pe_triage_info
+{
+	std::uint16_t m_machine;
+	bool m_is_32;
+	bool m_is_hybrid;
+	std::uint16_t m_subsystem;
+	std::uint16_t m_characteristics;
+	std::uint16_t m_dll_characteristics;
+	std::uint16_t m_section_count;
+	std::uint32_t m_data_directories;
+};
+
+struct pe_triage_filter
+{
+	std::uint16_t m_machine;
+	bool m_dlls_only;
+	bool m_exes_only;
+	bool m_with_imports;
+	bool m_with_exports;
+};
+
+
+bool pe_triage_buffer(std::byte const* const data, int const size, pe_triage_info* const info_out);
+bool pe_triage_file(wchar_t const* const file_name, pe_triage_info* const info_out);
+bool pe_triage_parse_filter(wchar_t const* const str, pe_triage_filter* const filter_out);
+bool pe_triage_matches(pe_triage_info const& info, pe_triage_filter const& filter);
+bool pe_triage_has_data_directory(pe_triage_info const& info, int const dir);
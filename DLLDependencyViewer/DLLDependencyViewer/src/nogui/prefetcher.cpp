@@ -0,0 +1,154 @@
+#include "prefetcher.h"
+
+#include "pe2.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+
+static constexpr int const s_prefetcher_max_workers = 16;
+
+
+struct prefetcher_task
+{
+	prefetcher* m_self;
+	prefetcher_slot* m_slot;
+};
+
+
+prefetcher::prefetcher(int const worker_count) :
+	m_mutex(),
+	m_done_condition_variable(),
+	m_slots(),
+	m_untaken_slots(),
+	m_read_histogram(),
+	m_in_flight(),
+	m_untaken(),
+	m_misses(),
+	m_worker_count(worker_count),
+	m_next_worker(),
+	m_workers(std::make_unique<thread_worker[]>(worker_count))
+{
+	assert(worker_count >= 1);
+	latency_histogram_init(&m_read_histogram);
+}
+
+prefetcher::~prefetcher()
+{
+}
+
+void prefetcher::prefetch(wstring_handle const& file_path)
+{
+	prefetcher_slot* slot;
+	{
+		std::lock_guard<std::mutex> lck(m_mutex);
+		if(m_in_flight == s_prefetcher_max_in_flight)
+		{
+			return;
+		}
+		auto& e = m_slots[file_path];
+		if(e)
+		{
+			return;
+		}
+		e = std::make_unique<prefetcher_slot>();
+		slot = e.get();
+		slot->m_file_path = file_path;
+		slot->m_done = false;
+		slot->m_fetched = false;
+		slot->m_taken = false;
+		++m_in_flight;
+	}
+	prefetcher_task* const task = new prefetcher_task{this, slot};
+	m_workers[m_next_worker].add_task(&fetch_task, task);
+	m_next_worker = (m_next_worker + 1) % m_worker_count;
+}
+
+bool prefetcher::take(wstring_handle const& file_path, selective_file* const sf_out)
+{
+	assert(sf_out);
+	std::unique_lock<std::mutex> lck(m_mutex);
+	auto const it = m_slots.find(file_path);
+	if(it == m_slots.end() || it->second->m_taken)
+	{
+		++m_misses;
+		return false;
+	}
+	prefetcher_slot* const slot = it->second.get();
+	m_done_condition_variable.wait(lck, [slot](){ return slot->m_done; });
+	slot->m_taken = true;
+	m_untaken -= slot->m_fetched ? 1 : 0;
+	*sf_out = std::move(slot->m_file);
+	m_misses += slot->m_fetched ? 0 : 1;
+	return slot->m_fetched;
+}
+
+int prefetcher::worker_count() const
+{
+	return m_worker_count;
+}
+
+int prefetcher::miss_count() const
+{
+	return m_misses;
+}
+
+void prefetcher::get_read_histogram(latency_histogram* const histogram_out)
+{
+	assert(histogram_out);
+	std::lock_guard<std::mutex> lck(m_mutex);
+	*histogram_out = m_read_histogram;
+}
+
+int prefetcher::default_worker_count()
+{
+	int const cores = static_cast<int>(std::thread::hardware_concurrency());
+	return std::clamp(cores * 2, 2, s_prefetcher_max_workers);
+}
+
+void prefetcher::fetch_task(thread_worker_param_t const param)
+{
+	assert(param);
+	std::unique_ptr<prefetcher_task> const task(reinterpret_cast<prefetcher_task*>(param));
+	prefetcher& self = *task->m_self;
+	prefetcher_slot& slot = *task->m_slot;
+	auto const begin = std::chrono::steady_clock::now();
+	selective_file sf(slot.m_file_path.m_string->m_str);
+	bool fetched = false;
+	if(sf.begin() != nullptr)
+	{
+		pe_image img;
+		fetched = pe_process_headers(sf, false, &img);
+	}
+	auto const end = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::mutex> lck(self.m_mutex);
+		latency_histogram_add(&self.m_read_histogram, end - begin);
+		slot.m_file = std::move(sf);
+		slot.m_fetched = fetched;
+		slot.m_done = true;
+		--self.m_in_flight;
+		if(fetched)
+		{
+			self.m_untaken_slots.push_back(&slot);
+			++self.m_untaken;
+		}
+		// Slots of edges the walk never opens are not taken, drop their buffers instead of accumulating them.
+		while(self.m_untaken > s_prefetcher_max_untaken)
+		{
+			prefetcher_slot* const oldest = self.m_untaken_slots.front();
+			self.m_untaken_slots.pop_front();
+			if(oldest->m_taken)
+			{
+				continue;
+			}
+			oldest->m_file = selective_file{};
+			oldest->m_fetched = false;
+			--self.m_untaken;
+		}
+	}
+	self.m_done_condition_variable.notify_all();
+}
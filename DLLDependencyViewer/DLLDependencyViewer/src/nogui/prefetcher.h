@@ -0,0 +1,59 @@
+#pragma once
+
+
+#include "latency_histogram.h"
+#include "my_string_handle.h"
+#include "selective_file.h"
+#include "thread_worker.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+static constexpr int const s_prefetcher_max_in_flight = 64;
+static constexpr int const s_prefetcher_max_untaken = 64;
+
+
+struct prefetcher_slot
+{
+	wstring_handle m_file_path;
+	selective_file m_file;
+	bool m_done;
+	bool m_fetched;
+	bool m_taken;
+};
+
+
+class prefetcher
+{
+public:
+	prefetcher(int const worker_count);
+	prefetcher(prefetcher const&) = delete;
+	prefetcher& operator=(prefetcher const&) = delete;
+	~prefetcher();
+public:
+	void prefetch(wstring_handle const& file_path);
+	bool take(wstring_handle const& file_path, selective_file* const sf_out);
+	int worker_count() const;
+	int miss_count() const;
+	void get_read_histogram(latency_histogram* const histogram_out);
+	static int default_worker_count();
+private:
+	static void fetch_task(thread_worker_param_t const param);
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_done_condition_variable;
+	std::unordered_map<wstring_handle, std::unique_ptr<prefetcher_slot>> m_slots;
+	// Fetched slots in completion order, the oldest untaken ones release their buffers first.
+	std::deque<prefetcher_slot*> m_untaken_slots;
+	latency_histogram m_read_histogram;
+	int m_in_flight;
+	int m_untaken;
+	int m_misses;
+	int m_worker_count;
+	int m_next_worker;
+	std::unique_ptr<thread_worker[]> m_workers;
+};
@@ -0,0 +1,185 @@
+#include "selective_file.h"
+
+#include "assert.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "my_windows.h"
+
+
+#define s_very_big_int (2'147'483'647)
+static constexpr int const s_max_buffer_size = s_very_big_int;
+static constexpr std::uint64_t const s_max_read_size = 1024 * 1024 * 1024;
+static constexpr std::uint64_t const s_commit_granularity = 4 * 1024;
+
+
+void virtual_free_deleter::operator()(void* const ptr) const
+{
+	BOOL const freed = VirtualFree(ptr, 0, MEM_RELEASE);
+	assert(freed != 0);
+}
+
+
+selective_file::selective_file() noexcept :
+	m_file(),
+	m_buffer(),
+	m_size(),
+	m_file_size(),
+	m_fetched(),
+	m_request_count(),
+	m_bytes_read()
+{
+}
+
+selective_file::selective_file(wchar_t const* const file_name) :
+	selective_file()
+{
+	HANDLE const file = CreateFileW(file_name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	WARN_M_RV(file != INVALID_HANDLE_VALUE, L"Failed to CreateFileW.");
+	smart_handle s_file(file);
+	LARGE_INTEGER size;
+	BOOL const got_size = GetFileSizeEx(file, &size);
+	assert(got_size != 0);
+	WARN_M_RV(size.QuadPart != 0, L"File is empty.");
+	std::uint64_t const file_size = static_cast<std::uint64_t>(size.QuadPart);
+	int const buffer_size = static_cast<int>(std::min<std::uint64_t>(file_size, s_max_buffer_size));
+	void* const ptr = VirtualAlloc(nullptr, static_cast<SIZE_T>(buffer_size), MEM_RESERVE, PAGE_READWRITE);
+	WARN_M_RV(ptr != nullptr, L"Failed to VirtualAlloc.");
+	smart_virtual_memory s_buffer(ptr);
+
+	m_file = std::move(s_file);
+	m_buffer = std::move(s_buffer);
+	m_size = buffer_size;
+	m_file_size = file_size;
+}
+
+selective_file::selective_file(selective_file&& other) noexcept :
+	selective_file()
+{
+	swap(other);
+}
+
+selective_file& selective_file::operator=(selective_file&& other) noexcept
+{
+	swap(other);
+	return *this;
+}
+
+selective_file::~selective_file() noexcept
+{
+}
+
+void selective_file::swap(selective_file& other) noexcept
+{
+	using std::swap;
+	swap(m_file, other.m_file);
+	swap(m_buffer, other.m_buffer);
+	swap(m_size, other.m_size);
+	swap(m_file_size, other.m_file_size);
+	swap(m_fetched, other.m_fetched);
+	swap(m_request_count, other.m_request_count);
+	swap(m_bytes_read, other.m_bytes_read);
+}
+
+bool selective_file::fetch(std::uint64_t const offset, std::uint64_t const size)
+{
+	assert(m_buffer);
+	std::uint64_t const end = std::min<std::uint64_t>(offset + size, m_size);
+	std::uint64_t const begin = std::min<std::uint64_t>(offset, end);
+	if(begin == end)
+	{
+		return true;
+	}
+	auto const lo = std::lower_bound(m_fetched.begin(), m_fetched.end(), begin, [](pe_raw_range const& range, std::uint64_t const& pos){ return range.m_end < pos; });
+	auto const hi = std::upper_bound(lo, m_fetched.end(), end, [](std::uint64_t const& pos, pe_raw_range const& range){ return pos < range.m_begin; });
+	std::uint64_t pos = begin;
+	for(auto it = lo; it != hi; ++it)
+	{
+		if(pos < it->m_begin)
+		{
+			bool const gap_read = read_range(pos, it->m_begin);
+			WARN_M_R(gap_read, L"Failed to read.", false);
+		}
+		pos = std::max(pos, it->m_end);
+	}
+	if(pos < end)
+	{
+		bool const tail_read = read_range(pos, end);
+		WARN_M_R(tail_read, L"Failed to read.", false);
+	}
+	pe_raw_range merged{begin, end};
+	if(lo != hi)
+	{
+		merged.m_begin = std::min(merged.m_begin, lo->m_begin);
+		merged.m_end = std::max(merged.m_end, (hi - 1)->m_end);
+	}
+	auto const erased = m_fetched.erase(lo, hi);
+	m_fetched.insert(erased, merged);
+	return true;
+}
+
+pe_raw_range const* selective_file::fetched_ranges() const
+{
+	return m_fetched.data();
+}
+
+int selective_file::fetched_range_count() const
+{
+	return static_cast<int>(m_fetched.size());
+}
+
+bool selective_file::read_range(std::uint64_t const begin, std::uint64_t const end)
+{
+	std::uint64_t const commit_begin = begin & ~(s_commit_granularity - 1);
+	std::uint64_t const commit_end = std::min<std::uint64_t>((end + s_commit_granularity - 1) & ~(s_commit_granularity - 1), m_size);
+	void* const committed = VirtualAlloc(static_cast<std::byte*>(m_buffer.get()) + commit_begin, static_cast<SIZE_T>(commit_end - commit_begin), MEM_COMMIT, PAGE_READWRITE);
+	WARN_M_R(committed != nullptr, L"Failed to VirtualAlloc.", false);
+	std::uint64_t pos = begin;
+	while(pos != end)
+	{
+		DWORD const chunk = static_cast<DWORD>(std::min(end - pos, s_max_read_size));
+		OVERLAPPED ol{};
+		ol.Offset = static_cast<DWORD>(pos & 0xffffffff);
+		ol.OffsetHigh = static_cast<DWORD>(pos >> 32);
+		DWORD read;
+		BOOL const ok = ReadFile(m_file.get(), static_cast<std::byte*>(m_buffer.get()) + pos, chunk, &read, &ol);
+		WARN_M_R(ok != FALSE, L"Failed to ReadFile.", false);
+		WARN_M_R(read != 0, L"Unexpected end of file.", false);
+		++m_request_count;
+		m_bytes_read += read;
+		pos += read;
+	}
+	return true;
+}
+
+std::byte const* selective_file::begin() const
+{
+	return static_cast<std::byte const*>(m_buffer.get());
+}
+
+std::byte const* selective_file::end() const
+{
+	return begin() + size();
+}
+
+int selective_file::size() const
+{
+	return m_size;
+}
+
+std::uint64_t selective_file::file_size() const
+{
+	return m_file_size;
+}
+
+int selective_file::request_count() const
+{
+	return m_request_count;
+}
+
+std::uint64_t selective_file::bytes_read() const
+{
+	return m_bytes_read;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+
+#include "smart_handle.h"
+#include "pe/pe_util.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+struct virtual_free_deleter
+{
+public:
+	void operator()(void* const ptr) const;
+};
+typedef std::unique_ptr<void, virtual_free_deleter> smart_virtual_memory;
+
+
+class selective_file
+{
+public:
+	selective_file() noexcept;
+	selective_file(wchar_t const* const file_name);
+	selective_file(selective_file const&) = delete;
+	selective_file(selective_file&& other) noexcept;
+	selective_file& operator=(selective_file const&) = delete;
+	selective_file& operator=(selective_file&& other) noexcept;
+	~selective_file() noexcept;
+	void swap(selective_file& other) noexcept;
+public:
+	bool fetch(std::uint64_t const offset, std::uint64_t const size);
+	// Bytes outside of these ranges were never read. The pointer is invalidated by the next fetch.
+	pe_raw_range const* fetched_ranges() const;
+	int fetched_range_count() const;
+	std::byte const* begin() const;
+	std::byte const* end() const;
+	int size() const;
+	std::uint64_t file_size() const;
+	int request_count() const;
+	std::uint64_t bytes_read() const;
+private:
+	bool read_range(std::uint64_t const begin, std::uint64_t const end);
+private:
+	smart_handle m_file;
+	smart_virtual_memory m_buffer;
+	int m_size;
+	std::uint64_t m_file_size;
+	std::vector<pe_raw_range> m_fetched;
+	int m_request_count;
+	std::uint64_t m_bytes_read;
+};
+
+inline void swap(selective_file& a, selective_file& b) noexcept { a.swap(b); }
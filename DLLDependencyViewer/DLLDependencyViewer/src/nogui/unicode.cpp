@@ -1,6 +1,7 @@
 #include "unicode.h"
 
-#include <algorithm>
+#include "ascii_scan.h"
+
 #include <cstdint>
 
 
@@ -11,8 +12,7 @@ bool is_ascii_u(T const* const buff, int const size);
 template<>
 bool is_ascii(char const* const str, int const size)
 {
-	unsigned char const* const u = reinterpret_cast<unsigned char const*>(str);
-	return is_ascii_u(u, size);
+	return is_ascii_u(str, size);
 }
 
 template<>
@@ -58,5 +58,5 @@ template wchar_t to_lowercase<wchar_t>(wchar_t const ch);
 template<typename T>
 bool is_ascii_u(T const* const buff, int const size)
 {
-	if(std::all_of(buff, buff + size, [](auto const& e) -> bool { if(e >= 32 && e <= 126) [[likely]] { return true; } else { return false; } })) [[likely]] { return true; } else { return false; }
+	return ascii_is_printable(buff, size);
 }
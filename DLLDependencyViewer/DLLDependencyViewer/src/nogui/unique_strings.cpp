@@ -7,9 +7,13 @@
 #include <utility>
 
 
+static constexpr int const s_unique_strings_initial_capacity = 1024;
+
+
 template<typename char_t>
 basic_unique_strings<char_t>::basic_unique_strings() noexcept :
-	m_strings()
+	m_slots(),
+	m_count(0)
 {
 }
 
@@ -36,32 +40,71 @@ template<typename char_t>
 void basic_unique_strings<char_t>::swap(basic_unique_strings& other) noexcept
 {
 	using std::swap;
-	swap(m_strings, other.m_strings);
+	swap(m_slots, other.m_slots);
+	swap(m_count, other.m_count);
 }
 
 template<typename char_t>
 basic_string_handle<char_t> basic_unique_strings<char_t>::add_string(char_t const* const str, int const len, allocator& alc)
 {
-	basic_string<char_t> const tmp_str{str, len};
-	basic_string_handle<char_t> const tmp_hndl{&tmp_str};
-	auto const it = m_strings.find(tmp_hndl);
-	if(it == m_strings.end())
+	if((m_count + 1) * 8 > static_cast<int>(m_slots.size()) * 7)
+	{
+		grow();
+	}
+	std::size_t const hash = basic_string_hash<char_t>{}(basic_string<char_t>{str, len, 0});
+	std::size_t const mask = m_slots.size() - 1;
+	std::size_t idx = hash & mask;
+	for(;;)
 	{
-		char_t* const new_buff = alc.allocate_objects<char_t>(len + 1);
-		std::memcpy(new_buff, str, len * sizeof(char_t));
-		new_buff[len] = char_t{'\0'};
-		basic_string<char_t>* const new_str = alc.allocate_objects<basic_string<char_t>>(1);
-		*new_str = basic_string<char_t>{new_buff, len};
-		basic_string_handle<char_t> const new_hndl{new_str};
-		auto const itb = m_strings.insert(new_hndl);
-		assert(itb.first != m_strings.end());
-		assert(itb.second);
-		return *itb.first;
+		slot& s = m_slots[idx];
+		if(!s.m_string)
+		{
+			break;
+		}
+		if(s.m_hash == hash && s.m_len == len && std::memcmp(s.m_string->m_str, str, len * sizeof(char_t)) == 0)
+		{
+			return basic_string_handle<char_t>{s.m_string};
+		}
+		idx = (idx + 1) & mask;
 	}
-	else
+	char_t* const new_buff = alc.allocate_objects<char_t>(len + 1, allocation_tag::strings);
+	std::memcpy(new_buff, str, len * sizeof(char_t));
+	new_buff[len] = char_t{'\0'};
+	basic_string<char_t>* const new_str = alc.allocate_objects<basic_string<char_t>>(1, allocation_tag::strings);
+	*new_str = basic_string<char_t>{new_buff, len, hash};
+	m_slots[idx] = slot{hash, len, new_str};
+	++m_count;
+	return basic_string_handle<char_t>{new_str};
+}
+
+template<typename char_t>
+int basic_unique_strings<char_t>::size() const
+{
+	return m_count;
+}
+
+template<typename char_t>
+void basic_unique_strings<char_t>::grow()
+{
+	int const new_capacity = m_slots.empty() ? s_unique_strings_initial_capacity : static_cast<int>(m_slots.size()) * 2;
+	assert((new_capacity & (new_capacity - 1)) == 0);
+	std::vector<slot> new_slots;
+	new_slots.resize(new_capacity, slot{0, 0, nullptr});
+	std::size_t const mask = new_slots.size() - 1;
+	for(slot const& s : m_slots)
 	{
-		return *it;
+		if(!s.m_string)
+		{
+			continue;
+		}
+		std::size_t idx = s.m_hash & mask;
+		while(new_slots[idx].m_string)
+		{
+			idx = (idx + 1) & mask;
+		}
+		new_slots[idx] = s;
 	}
+	m_slots.swap(new_slots);
 }
 
 template class basic_unique_strings<char>;
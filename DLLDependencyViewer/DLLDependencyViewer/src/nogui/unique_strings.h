@@ -3,7 +3,8 @@
 
 #include "my_string_handle.h"
 
-#include <unordered_set>
+#include <cstddef>
+#include <vector>
 
 
 class allocator;
@@ -22,8 +23,19 @@ public:
 	void swap(basic_unique_strings<char_t>& other) noexcept;
 public:
 	basic_string_handle<char_t> add_string(char_t const* const str, int const len, allocator& alc);
+	int size() const;
 private:
-	std::unordered_set<basic_string_handle<char_t>> m_strings;
+	struct slot
+	{
+		std::size_t m_hash;
+		int m_len;
+		basic_string<char_t> const* m_string;
+	};
+private:
+	void grow();
+private:
+	std::vector<slot> m_slots;
+	int m_count;
 };
 
 template<typename char_t> inline void swap(basic_unique_strings<char_t>& a, basic_unique_strings<char_t>& b) noexcept { a.swap(b); }
@@ -0,0 +1,162 @@
+#include "wyhash.h"
+
+#include <cassert>
+#include <cstring>
+
+#include <emmintrin.h>
+#include <intrin.h>
+
+
+static constexpr std::uint64_t const s_wyp0 = 0xa0761d6478bd642fuLL;
+static constexpr std::uint64_t const s_wyp1 = 0xe7037ed1a0b428dbuLL;
+static constexpr std::uint64_t const s_wyp2 = 0x8ebc6af09c88c6e3uLL;
+static constexpr std::uint64_t const s_wyp3 = 0x589965cc75374cc3uLL;
+
+
+static inline void wyhash_mum(std::uint64_t* const a, std::uint64_t* const b)
+{
+	#ifdef _M_X64
+	std::uint64_t hi;
+	std::uint64_t const lo = _umul128(*a, *b, &hi);
+	*a = lo;
+	*b = hi;
+	#else
+	std::uint64_t const ha = *a >> 32;
+	std::uint64_t const hb = *b >> 32;
+	std::uint64_t const la = static_cast<std::uint32_t>(*a);
+	std::uint64_t const lb = static_cast<std::uint32_t>(*b);
+	std::uint64_t const rh = ha * hb;
+	std::uint64_t const rm0 = ha * lb;
+	std::uint64_t const rm1 = hb * la;
+	std::uint64_t const rl = la * lb;
+	std::uint64_t const t = rl + (rm0 << 32);
+	std::uint64_t const c = t < rl ? 1 : 0;
+	std::uint64_t const lo = t + (rm1 << 32);
+	std::uint64_t const hi = rh + (rm0 >> 32) + (rm1 >> 32) + c + (lo < t ? 1 : 0);
+	*a = lo;
+	*b = hi;
+	#endif
+}
+
+static inline std::uint64_t wyhash_mix(std::uint64_t a, std::uint64_t b)
+{
+	wyhash_mum(&a, &b);
+	return a ^ b;
+}
+
+static inline std::uint64_t wyhash_r8(std::uint8_t const* const p)
+{
+	std::uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline std::uint64_t wyhash_r4(std::uint8_t const* const p)
+{
+	std::uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline std::uint64_t wyhash_r3(std::uint8_t const* const p, int const k, std::uint64_t const fold_mask)
+{
+	std::uint64_t const a = p[0] | (fold_mask & 0xFF);
+	std::uint64_t const b = p[k >> 1] | ((fold_mask >> (((k >> 1) & 7) * 8)) & 0xFF);
+	std::uint64_t const c = p[k - 1] | ((fold_mask >> (((k - 1) & 7) * 8)) & 0xFF);
+	return (a << 16) | (b << 8) | c;
+}
+
+template<bool folded>
+static inline void wyhash_r16(std::uint8_t const* const p, __m128i const& mask, std::uint64_t* const w)
+{
+	if constexpr(folded)
+	{
+		__m128i const v = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)), mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(w), v);
+	}
+	else
+	{
+		std::memcpy(w, p, 16);
+	}
+}
+
+template<bool folded>
+static std::uint64_t wyhash_impl(void const* const ptr, int const len, std::uint64_t const fold_mask)
+{
+	assert(len >= 0);
+	assert(folded || fold_mask == 0);
+	std::uint8_t const* p = static_cast<std::uint8_t const*>(ptr);
+	__m128i const mask = _mm_set_epi32(static_cast<int>(fold_mask >> 32), static_cast<int>(fold_mask), static_cast<int>(fold_mask >> 32), static_cast<int>(fold_mask));
+	std::uint64_t seed = s_wyp0 ^ wyhash_mix(s_wyp0, s_wyp1);
+	std::uint64_t a;
+	std::uint64_t b;
+	if(len <= 16)
+	{
+		if(len >= 4)
+		{
+			std::uint64_t const m = fold_mask & 0xFFFF'FFFFuLL;
+			int const off = (len >> 3) << 2;
+			a = ((wyhash_r4(p) | m) << 32) | (wyhash_r4(p + off) | m);
+			b = ((wyhash_r4(p + len - 4) | m) << 32) | (wyhash_r4(p + len - 4 - off) | m);
+		}
+		else if(len > 0)
+		{
+			a = wyhash_r3(p, len, fold_mask);
+			b = 0;
+		}
+		else
+		{
+			a = 0;
+			b = 0;
+		}
+	}
+	else
+	{
+		alignas(16) std::uint64_t w[6];
+		int i = len;
+		if(i > 48)
+		{
+			std::uint64_t see1 = seed;
+			std::uint64_t see2 = seed;
+			do
+			{
+				wyhash_r16<folded>(p + 0, mask, w + 0);
+				wyhash_r16<folded>(p + 16, mask, w + 2);
+				wyhash_r16<folded>(p + 32, mask, w + 4);
+				seed = wyhash_mix(w[0] ^ s_wyp1, w[1] ^ seed);
+				see1 = wyhash_mix(w[2] ^ s_wyp2, w[3] ^ see1);
+				see2 = wyhash_mix(w[4] ^ s_wyp3, w[5] ^ see2);
+				p += 48;
+				i -= 48;
+			}while(i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while(i > 16)
+		{
+			wyhash_r16<folded>(p, mask, w);
+			seed = wyhash_mix(w[0] ^ s_wyp1, w[1] ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		wyhash_r16<folded>(p + i - 16, mask, w);
+		a = w[0];
+		b = w[1];
+	}
+	a ^= s_wyp1;
+	b ^= seed;
+	wyhash_mum(&a, &b);
+	return wyhash_mix(a ^ s_wyp0 ^ static_cast<std::uint64_t>(len), b ^ s_wyp1);
+}
+
+
+std::uint64_t wyhash(void const* const ptr, int const len)
+{
+	return wyhash_impl<false>(ptr, len, 0);
+}
+
+std::uint64_t wyhash_folded(void const* const ptr, int const len, std::uint64_t const fold_mask)
+{
+	return wyhash_impl<true>(ptr, len, fold_mask);
+}
+
+
@@ -0,0 +1,8 @@
+#pragma once
+
+
+#include <cstdint>
+
+
+std::uint64_t wyhash(void const* const ptr, int const len);
+std::uint64_t wyhash_folded(void const* const ptr, int const len, std::uint64_t const fold_mask);